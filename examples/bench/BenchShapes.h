@@ -0,0 +1,216 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef BENCHSHAPES_H
+#define BENCHSHAPES_H
+
+// The shapes of the narrow phase benches, and the random poses on which
+// pairs of them are tested.
+
+#include <math.h>
+
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include <SOLID.h>
+
+#include "DT_Object.h"
+#include "DT_Polytope.h"
+#include "DT_VertexBase.h"
+
+inline double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Kind {
+	const char     *m_name;
+	DT_ShapeHandle  m_shape;
+	float           m_margin;
+};
+
+// Boxes, spheres, cones, cylinders, points, line segments, polytopes (all
+// vertices searched), polyhedra (hill climbing) and complex shapes (a torus
+// mesh). All shapes fit in a sphere of radius 0.8 around their origin.
+// Points and line segments get a margin, so that they have a volume. The
+// vertices of the polytopes and of the torus are kept in 'points' and
+// 'coords'.
+inline std::vector<Kind> makeKinds(std::vector<MT_Point3>& points, std::vector<float>& coords)
+{
+	std::vector<Kind> kinds;
+
+	Kind box = { "box", DT_NewBox(1.0f, 0.8f, 0.6f), 0.0f };
+	Kind sphere = { "sphere", DT_NewSphere(0.5f), 0.0f };
+	Kind cone = { "cone", DT_NewCone(0.5f, 1.0f), 0.0f };
+	Kind cylinder = { "cylinder", DT_NewCylinder(0.4f, 1.0f), 0.0f };
+	DT_Vector3 origin = { 0.0f, 0.0f, 0.0f };
+	Kind point = { "point", DT_NewPoint(origin), 0.3f };
+	DT_Vector3 source = { -0.5f, 0.0f, 0.0f };
+	DT_Vector3 target = { 0.5f, 0.0f, 0.0f };
+	Kind segment = { "segment", DT_NewLineSegment(source, target), 0.2f };
+	kinds.push_back(box);
+	kinds.push_back(sphere);
+	kinds.push_back(cone);
+	kinds.push_back(cylinder);
+	kinds.push_back(point);
+	kinds.push_back(segment);
+
+	// The polytope and the polyhedron have the same 64 random vertices on
+	// a sphere. DT_EndPolytope always builds a polyhedron, so the polytope
+	// is made directly.
+	std::mt19937 rng(2);
+	std::normal_distribution<float> normal;
+	int i;
+	for (i = 0; i != 64; ++i)
+	{
+		MT_Vector3 v(normal(rng), normal(rng), normal(rng));
+		points.push_back(MT_Point3(0.0f, 0.0f, 0.0f) + v.normalized() * MT_Scalar(0.6f));
+	}
+	static DT_VertexBase vertexBase(&points[0], sizeof(MT_Point3));
+	static std::vector<DT_Index> indices;
+	for (i = 0; i != int(points.size()); ++i)
+	{
+		indices.push_back(i);
+	}
+	Kind polytope = { "polytope", (DT_ShapeHandle)new DT_Polytope(&vertexBase, points.size(), &indices[0]), 0.0f };
+	DT_VertexBaseHandle base = DT_NewVertexBase(&points[0], sizeof(MT_Point3));
+	Kind polyhedron = { "polyhedron", DT_NewPolytope(base), 0.0f };
+	DT_VertexRange(0, points.size());
+	DT_EndPolytope();
+	kinds.push_back(polytope);
+	kinds.push_back(polyhedron);
+
+	// A torus with radii 0.55 and 0.2, of 16 x 8 quads split into triangles.
+	const int NUM_MAJOR = 16;
+	const int NUM_MINOR = 8;
+	int j;
+	for (i = 0; i != NUM_MAJOR; ++i)
+	{
+		float phi = 2.0f * float(M_PI) * i / NUM_MAJOR;
+		for (j = 0; j != NUM_MINOR; ++j)
+		{
+			float theta = 2.0f * float(M_PI) * j / NUM_MINOR;
+			float r = 0.55f + 0.2f * cosf(theta);
+			coords.push_back(r * cosf(phi));
+			coords.push_back(r * sinf(phi));
+			coords.push_back(0.2f * sinf(theta));
+		}
+	}
+	DT_ShapeHandle torus = DT_NewComplexShape(DT_NewVertexBase(&coords[0], 3 * sizeof(float)));
+	for (i = 0; i != NUM_MAJOR; ++i)
+	{
+		for (j = 0; j != NUM_MINOR; ++j)
+		{
+			DT_Index a = i * NUM_MINOR + j;
+			DT_Index b = ((i + 1) % NUM_MAJOR) * NUM_MINOR + j;
+			DT_Index c = ((i + 1) % NUM_MAJOR) * NUM_MINOR + (j + 1) % NUM_MINOR;
+			DT_Index d = i * NUM_MINOR + (j + 1) % NUM_MINOR;
+			DT_Index tri1[3] = { a, b, c };
+			DT_Index tri2[3] = { a, c, d };
+			DT_VertexIndices(3, tri1);
+			DT_VertexIndices(3, tri2);
+		}
+	}
+	DT_EndComplexShape();
+	Kind complex = { "complex", torus, 0.0f };
+	kinds.push_back(complex);
+
+	return kinds;
+}
+
+inline DT_Object& object(DT_ObjectHandle handle)
+{
+	return *reinterpret_cast<DT_Object *>(handle);
+}
+
+inline bool intersects(DT_ObjectHandle a, DT_ObjectHandle b)
+{
+	MT_Vector3 v(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+	return intersect(object(a), object(b), v);
+}
+
+// Places b at distance t from a along dir.
+inline void place(DT_ObjectHandle b, const MT_Vector3& dir, float t)
+{
+	DT_Vector3 position = { dir[0] * t, dir[1] * t, dir[2] * t };
+	DT_SetPosition(b, position);
+}
+
+// Gives a and b random orientations and moves b from a along a random
+// direction to 'offset' beyond touching contact, so a negative offset makes
+// the shapes overlap. Returns false if the shapes do not meet along the
+// direction, or meet closer than -offset. The contact distance is found by
+// scanning inwards from a distance at which the shapes are surely separated,
+// and is refined by bisection.
+inline bool makePose(DT_ObjectHandle a, DT_ObjectHandle b, float offset, std::mt19937& rng)
+{
+	std::normal_distribution<float> normal;
+	DT_Quaternion qa = { normal(rng), normal(rng), normal(rng), normal(rng) };
+	DT_Quaternion qb = { normal(rng), normal(rng), normal(rng), normal(rng) };
+	float la = sqrtf(qa[0] * qa[0] + qa[1] * qa[1] + qa[2] * qa[2] + qa[3] * qa[3]);
+	float lb = sqrtf(qb[0] * qb[0] + qb[1] * qb[1] + qb[2] * qb[2] + qb[3] * qb[3]);
+	int k;
+	for (k = 0; k != 4; ++k)
+	{
+		qa[k] /= la;
+		qb[k] /= lb;
+	}
+	DT_SetOrientation(a, qa);
+	DT_SetOrientation(b, qb);
+	MT_Vector3 dir = MT_Vector3(normal(rng), normal(rng), normal(rng)).normalized();
+
+	float hi = 2.0f;
+	float lo = hi;
+	do
+	{
+		lo -= 0.05f;
+		place(b, dir, lo);
+	}
+	while (lo > 0.0f && !intersects(a, b));
+
+	if (lo <= 0.0f || lo + offset <= 0.0f)
+	{
+		return false;
+	}
+
+	hi = lo + 0.05f;
+	for (k = 0; k != 16; ++k)
+	{
+		float mid = 0.5f * (lo + hi);
+		place(b, dir, mid);
+		if (intersects(a, b))
+		{
+			lo = mid;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+
+	place(b, dir, lo + offset);
+	return true;
+}
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Cost of the exact tests of pairs of spheres and boxes, tested one by one 
+// with DT_Encounter::collide and in batches with DT_Batch. The objects are 
+// placed at random with random orientations, and the pairs are those whose
+// boxes overlap, as in a scene. The scenes hold only spheres, both spheres 
+// and boxes, or only boxes, with and without margins. Both ways look up the
+// response of each pair, so the times include that lookup. As in a scene, 
+// the pairs that a batch does not take, the boxes with margins, are tested 
+// one by one in batch mode.
+//
+// Prints CSV: shapes, margins (0 or 1), pairs, mode (pair or batch), ns per
+// pair, and hits, which are the same for both modes. Build the library and 
+// the bench with and without USE_SSE to compare the lanes.
+
+#include <stdio.h>
+#include <math.h>
+
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include <SOLID.h>
+
+#include "DT_Batch.h"
+#include "DT_Encounter.h"
+#include "DT_RespTable.h"
+
+const int       NUM_OBJECTS = 1000;
+const int       NUM_REPEATS = 50;
+const DT_Scalar WORLD_SIZE  = DT_Scalar(25.0);
+
+static DT_Bool respond(void *, void *, void *, const DT_CollData *)
+{
+	return DT_CONTINUE;
+}
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void run(const char *name, bool spheres, bool boxes, bool margins)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> world(0.0f, float(WORLD_SIZE));
+	std::normal_distribution<float> normal;
+
+	DT_ShapeHandle sphere = DT_NewSphere(DT_Scalar(0.6));
+	DT_ShapeHandle box = DT_NewBox(DT_Scalar(1.0), DT_Scalar(0.8), DT_Scalar(1.2));
+
+	DT_RespTableHandle respTable = DT_CreateRespTable();
+	DT_ResponseClass responseClass = DT_GenResponseClass(respTable);
+	DT_AddDefaultResponse(respTable, &respond, DT_SIMPLE_RESPONSE, 0);
+
+	std::vector<DT_ObjectHandle> objects(NUM_OBJECTS);
+	int i, j;
+	for (i = 0; i != NUM_OBJECTS; ++i)
+	{
+		bool is_sphere = spheres && (!boxes || i % 2 == 0);
+		objects[i] = DT_CreateObject(0, is_sphere ? sphere : box);
+		DT_SetResponseClass(respTable, objects[i], responseClass);
+		if (margins)
+		{
+			DT_SetMargin(objects[i], DT_Scalar(0.1));
+		}
+
+		DT_Vector3 position = { world(rng), world(rng), world(rng) };
+		DT_SetPosition(objects[i], position);
+
+		float q[4] = { normal(rng), normal(rng), normal(rng), normal(rng) };
+		float length = sqrtf(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+		for (j = 0; j != 4; ++j)
+		{
+			q[j] /= length;
+		}
+		DT_SetOrientation(objects[i], q);
+	}
+
+	std::vector<DT_Encounter> encounters;
+	for (i = 0; i != NUM_OBJECTS; ++i)
+	{
+		for (j = i + 1; j != NUM_OBJECTS; ++j)
+		{
+			DT_Object *a = (DT_Object *)objects[i];
+			DT_Object *b = (DT_Object *)objects[j];
+			if (a->getBBox().overlaps(b->getBBox()))
+			{
+				encounters.push_back(DT_Encounter(a, b));
+			}
+		}
+	}
+
+	const DT_RespTable *table = (const DT_RespTable *)respTable;
+	DT_Count count = DT_Count(encounters.size());
+	DT_Index k;
+	int hits = 0;
+	int repeat;
+
+	// GJK starts from the separating axis of the previous test, so both modes
+	// start from the same copies to find the same hits.
+	std::vector<DT_Encounter> fresh = encounters;
+
+	double start = now();
+	for (repeat = 0; repeat != NUM_REPEATS; ++repeat)
+	{
+		hits = 0;
+		for (k = 0; k != count; ++k)
+		{
+			DT_CollData coll_data;
+			if (encounters[k].collide(table, coll_data) != DT_NO_RESPONSE)
+			{
+				++hits;
+			}
+		}
+	}
+	double seconds = now() - start;
+	printf("%s,%d,%u,pair,%.1f,%d\n", name, int(margins), count, seconds * 1.0e9 / NUM_REPEATS / count, hits);
+
+	encounters = fresh;
+	DT_Batch batch;
+	start = now();
+	for (repeat = 0; repeat != NUM_REPEATS; ++repeat)
+	{
+		hits = 0;
+		for (k = 0; k != count; ++k)
+		{
+			const DT_Encounter& e = encounters[k];
+			DT_ResponseType type = table->find(e.first(), e.second()).getType();
+			if (!batch.add(e, type, k))
+			{
+				DT_CollData coll_data;
+				if (e.collide(type, coll_data) != DT_NO_RESPONSE)
+				{
+					++hits;
+				}
+			}
+		}
+		batch.close();
+		for (k = 0; k != batch.numBatches(); ++k)
+		{
+			batch.run(k, false);
+		}
+		for (k = 0; k != batch.size(); ++k)
+		{
+			if (batch.getType(k) != DT_NO_RESPONSE)
+			{
+				++hits;
+			}
+		}
+	}
+	seconds = now() - start;
+	printf("%s,%d,%u,batch,%.1f,%d\n", name, int(margins), count, seconds * 1.0e9 / NUM_REPEATS / count, hits);
+
+	for (i = 0; i != NUM_OBJECTS; ++i)
+	{
+		DT_DestroyObject(objects[i]);
+	}
+	DT_DestroyRespTable(respTable);
+	DT_DeleteShape(box);
+	DT_DeleteShape(sphere);
+}
+
+int main()
+{
+	printf("shapes,margins,pairs,mode,ns_per_pair,hits\n");
+
+	run("spheres", true, false, false);
+	run("mixed", true, true, false);
+	run("boxes", false, true, false);
+	run("spheres", true, false, true);
+	run("mixed", true, true, true);
+	run("boxes", false, true, true);
+
+	return 0;
+}
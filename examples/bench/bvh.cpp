@@ -0,0 +1,216 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Bounding-box trees of complex shapes built by splitting at the center of 
+// the longest axis (DT_BVH_FAST) and by the surface area heuristic 
+// (DT_BVH_SAH). For the teapot and x-wing models, times the build and a 
+// series of intersection tests of the mesh against a copy of itself in 
+// random poses. With the library built with STATISTICS defined, the number 
+// of box tests is reported as well. The model files are read from the 
+// working directory unless given on the command line.
+
+#include <stdio.h>
+#include <math.h>
+
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+#include <SOLID.h>
+
+#include "DT_BBoxTree.h"
+
+const int NUM_QUERIES = 2000;
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct Mesh {
+	std::vector<float>                 m_coords;
+	std::vector<std::vector<DT_Index> > m_polygons;
+	float                              m_size;
+};
+
+// Reads a .vrt file: a vertex list "[ x y z, ... ]" followed by a list of 
+// polygons "[ i j k ... -1, ... ]".
+static bool load(const char *name, Mesh& mesh)
+{
+	std::ifstream in(name);
+	char ch;
+	if (!(in >> ch) || ch != '[')
+	{
+		return false;
+	}
+
+	float lower[3] = { 1e30f, 1e30f, 1e30f }, upper[3] = { -1e30f, -1e30f, -1e30f };
+	do
+	{
+		int k;
+		for (k = 0; k != 3; ++k)
+		{
+			float x;
+			in >> x;
+			mesh.m_coords.push_back(x);
+			lower[k] = x < lower[k] ? x : lower[k];
+			upper[k] = x > upper[k] ? x : upper[k];
+		}
+		in >> ch;
+	} 
+	while (in && ch == ',');
+
+	if (!(in >> ch) || ch != '[')
+	{
+		return false;
+	}
+
+	do
+	{
+		std::vector<DT_Index> polygon;
+		int index;
+		do
+		{
+			in >> index >> ch;
+			if (index >= 0)
+			{
+				polygon.push_back(index);
+			}
+		}
+		while (in && index >= 0);
+		mesh.m_polygons.push_back(polygon);
+	}
+	while (in && ch == ',');
+
+	mesh.m_size = 0.0f;
+	int k;
+	for (k = 0; k != 3; ++k)
+	{
+		mesh.m_size = upper[k] - lower[k] > mesh.m_size ? upper[k] - lower[k] : mesh.m_size;
+	}
+
+	return in && ch == ']';
+}
+
+static DT_ShapeHandle build(const Mesh& mesh, DT_VertexBaseHandle base)
+{
+	DT_ShapeHandle shape = DT_NewComplexShape(base);
+	size_t i;
+	for (i = 0; i != mesh.m_polygons.size(); ++i)
+	{
+		DT_VertexIndices(mesh.m_polygons[i].size(), &mesh.m_polygons[i][0]);
+	}
+	DT_EndComplexShape();
+	return shape;
+}
+
+static void run(const char *name, const char *quality_name, DT_BVHQuality quality, const Mesh& mesh)
+{
+	DT_VertexBaseHandle base = DT_NewVertexBase(&mesh.m_coords[0], 3 * sizeof(float));
+	DT_SetBVHBuildQuality(quality);
+
+	double start = now();
+	DT_ShapeHandle shape = build(mesh, base);
+	double build_time = (now() - start) * 1.0e3;
+
+	DT_ObjectHandle object1 = DT_CreateObject(0, shape);
+	DT_ObjectHandle object2 = DT_CreateObject(0, shape);
+
+	// The same poses for every build. The copies are placed at up to the 
+	// size of the mesh apart, so that about half of them intersect.
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> offset(-0.6f * mesh.m_size, 0.6f * mesh.m_size);
+	std::normal_distribution<float> normal;
+
+#ifdef STATISTICS
+	num_box_tests = 0;
+#endif
+	int num_hits = 0;
+	double query_time = 0.0;
+	int i;
+	for (i = 0; i != NUM_QUERIES; ++i)
+	{
+		DT_Vector3 position = { offset(rng), offset(rng), offset(rng) };
+		DT_Quaternion orientation = { normal(rng), normal(rng), normal(rng), normal(rng) };
+		float len = sqrtf(orientation[0] * orientation[0] + orientation[1] * orientation[1] + 
+						  orientation[2] * orientation[2] + orientation[3] * orientation[3]);
+		int k;
+		for (k = 0; k != 4; ++k)
+		{
+			orientation[k] /= len;
+		}
+		DT_SetPosition(object2, position);
+		DT_SetOrientation(object2, orientation);
+
+		DT_Vector3 point;
+		start = now();
+		num_hits += DT_GetCommonPoint(object1, object2, point) ? 1 : 0;
+		query_time += now() - start;
+	}
+
+	printf("%-12s %-4s build %8.2f ms  query %8.2f us", name, quality_name, build_time, 
+		   query_time * 1.0e6 / NUM_QUERIES);
+#ifdef STATISTICS
+	printf("  %10.1f box tests/query", double(num_box_tests) / NUM_QUERIES);
+#endif
+	printf("  (%d hits)\n", num_hits);
+
+	DT_DestroyObject(object1);
+	DT_DestroyObject(object2);
+	DT_DeleteShape(shape);
+	DT_DeleteVertexBase(base);
+}
+
+static void run(const char *name)
+{
+	Mesh mesh;
+	if (!load(name, mesh))
+	{
+		fprintf(stderr, "%s: cannot read mesh\n", name);
+		return;
+	}
+
+	run(name, "fast", DT_BVH_FAST, mesh);
+	run(name, "sah", DT_BVH_SAH, mesh);
+}
+
+int main(int argc, char *argv[]) 
+{
+	if (argc > 1)
+	{
+		int i;
+		for (i = 1; i != argc; ++i)
+		{
+			run(argv[i]);
+		}
+	}
+	else
+	{
+		run("teapot.vrt");
+		run("x_wing.vrt");
+	}
+
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Cost of a batched update of a sweep-and-prune scene as the motion of the 
+// boxes loses coherence. In each frame, a fraction of the boxes jumps to a 
+// random place and the others move a little. The endpoint lists are brought
+// up to date by re-sorting, by rebuilding and by the automatic choice. 
+// Prints CSV: jumping (percent of the boxes), mode, ms per frame, and the
+// number of overlapping pairs at the end, which is the same for each mode.
+
+#include <stdio.h>
+
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include <SOLID_broad.h>
+
+const int       NUM_BOXES   = 10000;
+const int       NUM_FRAMES  = 10;
+const DT_Scalar WORLD_SIZE  = DT_Scalar(60.0);
+const DT_Scalar HALF_EXTENT = DT_Scalar(0.5);
+const DT_Scalar STEP        = DT_Scalar(0.05);
+
+static long numPairs = 0;
+
+static void beginOverlap(void *, void *, void *)
+{
+	++numPairs;
+}
+
+static void endOverlap(void *, void *, void *)
+{
+	--numPairs;
+}
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void place(DT_Scalar *min, DT_Scalar *max, std::mt19937& rng)
+{
+	std::uniform_real_distribution<DT_Scalar> world(DT_Scalar(0.0), WORLD_SIZE);
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		DT_Scalar center = world(rng);
+		min[i] = center - HALF_EXTENT;
+		max[i] = center + HALF_EXTENT;
+	}
+}
+
+static void run(double jumping, BP_UpdateMode mode, const char *name)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<DT_Scalar> step(-STEP, STEP);
+	std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+	std::vector<DT_Scalar> min(3 * NUM_BOXES), max(3 * NUM_BOXES);
+	std::vector<void *> objects(NUM_BOXES);
+	std::vector<BP_ProxyHandle> proxies(NUM_BOXES);
+	int i;
+	for (i = 0; i != NUM_BOXES; ++i)
+	{
+		place(&min[3 * i], &max[3 * i], rng);
+		objects[i] = &objects[i];
+	}
+
+	numPairs = 0;
+	BP_SceneHandle scene = BP_CreateScene(0, &beginOverlap, &endOverlap);
+	BP_SetUpdateMode(scene, mode);
+	BP_CreateProxies(scene, NUM_BOXES, &objects[0], 
+					 reinterpret_cast<const DT_Vector3 *>(&min[0]), 
+					 reinterpret_cast<const DT_Vector3 *>(&max[0]), 
+					 0, 0, &proxies[0]);
+
+	double start = now();
+	int frame;
+	for (frame = 0; frame != NUM_FRAMES; ++frame)
+	{
+		BP_BeginUpdate(scene);
+		for (i = 0; i != NUM_BOXES; ++i)
+		{
+			if (chance(rng) < jumping)
+			{
+				place(&min[3 * i], &max[3 * i], rng);
+			}
+			else
+			{
+				int j;
+				for (j = 0; j < 3; ++j)
+				{
+					DT_Scalar delta = step(rng);
+					min[3 * i + j] += delta;
+					max[3 * i + j] += delta;
+				}
+			}
+			BP_SetBBox(proxies[i], &min[3 * i], &max[3 * i]);
+		}
+		BP_EndUpdate(scene);
+	}
+	double seconds = now() - start;
+
+	printf("%g,%s,%.2f,%ld\n", jumping * 100.0, name, seconds * 1.0e3 / NUM_FRAMES, numPairs);
+	
+	BP_DestroyScene(scene);
+}
+
+int main()
+{
+	static const double jumping[] = { 0.0, 0.001, 0.01, 0.05, 0.1, 0.25, 0.5, 1.0 };
+
+	printf("jumping,mode,ms_per_frame,pairs\n");
+
+	int i;
+	for (i = 0; i != sizeof(jumping) / sizeof(jumping[0]); ++i)
+	{
+		run(jumping[i], BP_UPDATE_RESORT, "resort");
+		run(jumping[i], BP_UPDATE_REBUILD, "rebuild");
+		run(jumping[i], BP_UPDATE_AUTO, "auto");
+	}
+
+	return 0;
+}
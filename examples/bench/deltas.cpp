@@ -0,0 +1,129 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+
+// Memory held by a scene whose objects move in and out of overlap without
+// a DT_Test in between, as in a scene that is only ray cast or queried. The
+// overlap changes are kept until the next test, folded as they pile up. The
+// heap is measured by counting the bytes allocated through operator new.
+// Prints CSV: sweep (one sphere in and out of overlap with each of the
+// others), live heap bytes at the end of the sweep. Returns 1 if the heap 
+// grows after the first sweep by more than the folding allows.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <new>
+#include <vector>
+
+#include <SOLID.h>
+
+const int NUM_OBJECTS = 100;
+const int NUM_SWEEPS  = 20;
+const int NUM_MOVES   = 100000;
+
+static size_t liveBytes = 0;
+
+// Each block is prefixed with its size, so that delete can subtract it.
+void *operator new(size_t size)
+{
+	size_t *block = (size_t *)malloc(size + sizeof(size_t) * 2);
+	if (block == 0)
+	{
+		throw std::bad_alloc();
+	}
+	block[0] = size;
+	liveBytes += size;
+	return block + 2;
+}
+
+void operator delete(void *ptr) noexcept
+{
+	if (ptr != 0)
+	{
+		size_t *block = (size_t *)ptr - 2;
+		liveBytes -= block[0];
+		free(block);
+	}
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+int main() 
+{
+	DT_SceneHandle scene = DT_CreateScene();
+	DT_ShapeHandle sphere = DT_NewSphere(DT_Scalar(0.5));
+
+	// A row of spheres one apart, and a mover that overlaps one of them 
+	// at a time as it goes back and forth along the row.
+	std::vector<DT_ObjectHandle> objects;
+	int i;
+	for (i = 0; i != NUM_OBJECTS; ++i)
+	{
+		DT_ObjectHandle object = DT_CreateObject(0, sphere);
+		DT_Vector3 position = { DT_Scalar(i), DT_Scalar(0.0), DT_Scalar(0.0) };
+		DT_SetPosition(object, position);
+		DT_AddObject(scene, object);
+		objects.push_back(object);
+	}
+	DT_ObjectHandle mover = DT_CreateObject(0, sphere);
+	DT_AddObject(scene, mover);
+
+	printf("sweep,live_bytes\n");
+	size_t first = 0;
+	int sweep;
+	for (sweep = 0; sweep != NUM_SWEEPS; ++sweep)
+	{
+		int move;
+		for (move = 0; move != NUM_MOVES; ++move)
+		{
+			int k = move % (2 * NUM_OBJECTS);
+			DT_Scalar x = DT_Scalar(k < NUM_OBJECTS ? k : 2 * NUM_OBJECTS - 1 - k);
+			DT_Vector3 position = { x, DT_Scalar(move % 2 == 0 ? 0.0 : 5.0), DT_Scalar(0.0) };
+			DT_SetPosition(mover, position);
+		}
+		printf("%d,%lu\n", sweep, (unsigned long)liveBytes);
+		if (sweep == 0)
+		{
+			first = liveBytes;
+		}
+	}
+	size_t last = liveBytes;
+
+	for (i = 0; i != NUM_OBJECTS; ++i)
+	{
+		DT_RemoveObject(scene, objects[i]);
+		DT_DestroyObject(objects[i]);
+	}
+	DT_RemoveObject(scene, mover);
+	DT_DestroyObject(mover);
+	DT_DestroyScene(scene);
+	DT_DeleteShape(sphere);
+
+	// The pending lists fold at most at twice the pairs of the scene plus 
+	// 1024 pairs, so the heap may grow by a few pages at most.
+	return last > first + 64 * 1024 ? 1 : 0;
+}
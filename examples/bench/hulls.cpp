@@ -0,0 +1,180 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Convex hulls of the vertex sets of the teapot and x-wing models. Times
+// the hull computation, the construction of a polytope shape including its 
+// hill-climbing hierarchy, and support queries on the polytope compared to 
+// a linear search over all vertices. The model files are read from the 
+// working directory unless given on the command line.
+
+#include <stdio.h>
+#include <math.h>
+
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+#include <SOLID.h>
+
+#include "DT_QuickHull.h"
+#include "DT_Polyhedron.h"
+#include "DT_Polytope.h"
+#include "DT_VertexBase.h"
+
+const int NUM_BUILDS  = 50;
+const int NUM_QUERIES = 200000;
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Reads the vertex list of a .vrt file: "[ x y z, x y z, ... ]".
+static bool load(const char *name, std::vector<MT_Point3>& points)
+{
+	std::ifstream in(name);
+	char ch;
+	if (!(in >> ch) || ch != '[')
+	{
+		return false;
+	}
+
+	do
+	{
+		float x, y, z;
+		in >> x >> y >> z >> ch;
+		points.push_back(MT_Point3(x, y, z));
+	} 
+	while (in && ch == ',');
+
+	return in && ch == ']';
+}
+
+template <typename Shape>
+double timeSupport(const Shape& shape, const std::vector<MT_Vector3>& dirs, MT_Scalar& sum)
+{
+	double start = now();
+	int i;
+	for (i = 0; i != NUM_QUERIES; ++i)
+	{
+		sum += shape.supportH(dirs[i]);
+	}
+	return (now() - start) * 1.0e9 / NUM_QUERIES;
+}
+
+static void run(const char *name)
+{
+	std::vector<MT_Point3> points;
+	if (!load(name, points))
+	{
+		fprintf(stderr, "%s: cannot read vertex list\n", name);
+		return;
+	}
+	DT_Count count = points.size();
+
+	DT_QuickHull hull;
+	double start = now();
+	int k;
+	for (k = 0; k != NUM_BUILDS; ++k)
+	{
+		hull.compute(count, &points[0], 0);
+	}
+	double hull_time = (now() - start) * 1.0e3 / NUM_BUILDS;
+
+	std::vector<float> coords;
+	DT_Index i;
+	for (i = 0; i != count; ++i)
+	{
+		coords.push_back(points[i][0]);
+		coords.push_back(points[i][1]);
+		coords.push_back(points[i][2]);
+	}
+	DT_VertexBaseHandle base = DT_NewVertexBase(&coords[0], 3 * sizeof(float));
+	
+	start = now();
+	for (k = 0; k != NUM_BUILDS; ++k)
+	{
+		DT_ShapeHandle shape = DT_NewPolytope(base);
+		DT_VertexRange(0, count);
+		DT_EndPolytope();
+		DT_DeleteShape(shape);
+	}
+	double shape_time = (now() - start) * 1.0e3 / NUM_BUILDS;
+
+	DT_DeleteVertexBase(base);
+
+	// Support queries on the polyhedron and on a polytope that searches 
+	// all vertices, for the same random directions.
+	DT_VertexBase vertexBase(&points[0], sizeof(MT_Point3));
+	std::vector<DT_Index> indices(count);
+	for (i = 0; i != count; ++i)
+	{
+		indices[i] = i;
+	}
+	DT_Polyhedron polyhedron(&vertexBase, count, &indices[0]);
+	DT_Polytope   polytope(&vertexBase, count, &indices[0]);
+
+	std::mt19937 rng(1);
+	std::normal_distribution<float> normal;
+	std::vector<MT_Vector3> dirs(NUM_QUERIES);
+	for (k = 0; k != NUM_QUERIES; ++k)
+	{
+		dirs[k].setValue(normal(rng), normal(rng), normal(rng));
+	}
+
+	MT_Scalar hill_sum = MT_Scalar(0.0), linear_sum = MT_Scalar(0.0);
+	double hill_time = timeSupport(polyhedron, dirs, hill_sum);
+	double linear_time = timeSupport(polytope, dirs, linear_sum);
+
+	printf("%s: %d points, %d on the hull, %d faces\n", name, (int)count, 
+		   (int)polyhedron.numVerts(), (int)hull.faces().size() / 3);
+	printf("  hull         %10.3f ms\n", hull_time);
+	printf("  polytope     %10.3f ms\n", shape_time);
+	printf("  support      %10.2f ns/query (hill climbing)\n", hill_time);
+	printf("  support      %10.2f ns/query (all vertices)\n", linear_time);
+
+	if (fabs(hill_sum - linear_sum) > MT_Scalar(1.0e-3) * fabs(linear_sum))
+	{
+		fprintf(stderr, "%s: support queries disagree\n", name);
+	}
+}
+
+int main(int argc, char *argv[]) 
+{
+	if (argc > 1)
+	{
+		int i;
+		for (i = 1; i != argc; ++i)
+		{
+			run(argv[i]);
+		}
+	}
+	else
+	{
+		run("teapot.vrt");
+		run("x_wing.vrt");
+	}
+
+	return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Throughput of the vector math under GJK support mappings, box tree tests
+// and bounding box computations, for an A/B comparison of builds with and
+// without USE_SSE (see include/MT/Simd.h). Build the library and this 
+// program with the same switches. Doubles (USE_DOUBLES) only use SIMD if 
+// the compiler also targets AVX.
+//
+// The output is comma-separated, one line per kernel:
+//
+//   kernel,ns_per_op,checksum
+//
+// The checksum sums the results of the kernel. It is the same for both 
+// builds, since the SIMD operations round the same as the scalar ones.
+
+#include <stdio.h>
+
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "MT_Transform.h"
+#include "MT_Quaternion.h"
+
+#include "DT_Box.h"
+#include "DT_Polytope.h"
+#include "DT_VertexBase.h"
+#include "DT_BBoxTree.h"
+
+const int NUM_ITEMS   = 4096;
+const int NUM_REPEATS = 256;
+
+typedef DT_ObjectData<const DT_Convex *, MT_Scalar> ObjectData;
+typedef DT_DuoPack<const DT_Convex *, MT_Scalar>    DuoPack;
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double sum(const MT_Vector3& v)
+{
+	return double(v[0]) + double(v[1]) + double(v[2]);
+}
+
+static void report(const char *kernel, double seconds, double checksum)
+{
+	printf("%s,%.2f,%.9g\n", kernel, seconds * 1.0e9 / (double(NUM_REPEATS) * NUM_ITEMS), checksum);
+}
+
+// Times 'op' on every item, NUM_REPEATS times over. The checksum is taken 
+// from the first round.
+template <typename Op>
+static void run(const char *kernel, Op op)
+{
+	double checksum = 0.0;
+	double start = now();
+	int r, i;
+	for (r = 0; r != NUM_REPEATS; ++r)
+	{
+		double round = 0.0;
+		for (i = 0; i != NUM_ITEMS; ++i)
+		{
+			round += op(i);
+		}
+		if (r == 0)
+		{
+			checksum = round;
+		}
+	}
+	report(kernel, now() - start, checksum);
+}
+
+int main() 
+{
+	std::mt19937 rng(5);
+	std::normal_distribution<float> normal;
+	std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> size(0.1f, 0.5f);
+
+	std::vector<MT_Transform> xforms;
+	std::vector<MT_Vector3> vectors;
+	std::vector<DT_CBox> cboxes;
+	int i;
+	for (i = 0; i != NUM_ITEMS; ++i)
+	{
+		MT_Quaternion q(normal(rng), normal(rng), normal(rng), normal(rng));
+		xforms.push_back(MT_Transform(q, MT_Vector3(uniform(rng), uniform(rng), uniform(rng))));
+		vectors.push_back(MT_Vector3(uniform(rng), uniform(rng), uniform(rng)));
+		cboxes.push_back(DT_CBox(MT_Point3(uniform(rng), uniform(rng), uniform(rng)) * MT_Scalar(0.5), 
+								 MT_Vector3(size(rng), size(rng), size(rng))));
+	}
+
+	// 64 random vertices on a sphere, as in the narrowphase bench.
+	std::vector<MT_Point3> points;
+	std::vector<DT_Index> indices;
+	for (i = 0; i != 64; ++i)
+	{
+		MT_Vector3 v(normal(rng), normal(rng), normal(rng));
+		points.push_back(v.normalized() * MT_Scalar(0.6f));
+		indices.push_back(i);
+	}
+	DT_VertexBase base(&points[0], sizeof(MT_Point3));
+	DT_Polytope polytope(&base, points.size(), &indices[0]);
+	const DT_Convex& convex = polytope;
+	DT_Box box(1.0f, 0.8f, 0.6f);
+
+	// Box tree tests between the boxes of object i and object i + 1, as 
+	// the traversal of two complex shapes does them.
+	std::vector<DuoPack> packs;
+	for (i = 0; i != NUM_ITEMS; ++i)
+	{
+		const MT_Transform& a2w = xforms[i];
+		const MT_Transform& b2w = xforms[(i + 1) % NUM_ITEMS];
+		packs.push_back(DuoPack(ObjectData(0, 0, a2w, MT_Scalar(0.0)), ObjectData(0, 0, b2w, MT_Scalar(0.0))));
+	}
+
+	printf("kernel,ns_per_op,checksum\n");
+
+	run("transform", [&](int i) { return sum(xforms[i](vectors[i])); });
+	run("inverse_rotate", [&](int i) { return sum(vectors[i] * xforms[i].getBasis()); });
+	run("compose", [&](int i) 
+	{ 
+		MT_Transform t = xforms[i] * xforms[(i + 1) % NUM_ITEMS]; 
+		return sum(t.getBasis()[0]) + sum(t.getOrigin()); 
+	});
+	run("inverse_times", [&](int i) 
+	{ 
+		MT_Transform t = xforms[i].inverseTimes(xforms[(i + 1) % NUM_ITEMS]); 
+		return sum(t.getBasis()[0]) + sum(t.getOrigin()); 
+	});
+	run("cross", [&](int i) { return sum(vectors[i].cross(vectors[(i + 1) % NUM_ITEMS])); });
+	run("box_support", [&](int i) 
+	{ 
+		const MT_Transform& t = xforms[i]; 
+		return sum(t(box.support(vectors[i] * t.getBasis()))); 
+	});
+	run("polytope_support", [&](int i) 
+	{ 
+		const MT_Transform& t = xforms[i]; 
+		return sum(t(polytope.support(vectors[i] * t.getBasis()))); 
+	});
+	run("obb_test", [&](int i) 
+	{ 
+		return intersect(cboxes[i], cboxes[(i + 7) % NUM_ITEMS], packs[i]) ? 1.0 : 0.0; 
+	});
+	run("box_bbox", [&](int i) 
+	{ 
+		MT_BBox bbox = box.bbox(xforms[i], MT_Scalar(0.1)); 
+		return sum(bbox.getMin()) + sum(bbox.getMax()); 
+	});
+	run("polytope_bbox", [&](int i) 
+	{ 
+		MT_BBox bbox = i % 16 == 0 ? polytope.bbox() : convex.bbox(xforms[i], MT_Scalar(0.1)); 
+		return sum(bbox.getMin()) + sum(bbox.getMax()); 
+	});
+
+	return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Throughput of the exact tests for every pair of shape kinds: boxes, 
+// spheres, cones, cylinders, points, line segments, polytopes (all vertices 
+// searched), polyhedra (hill climbing) and complex shapes (a torus mesh). 
+// For each pair, intersect, common_point, penetration_depth and 
+// closest_points are timed on seeded random poses that overlap, touch or 
+// are separated. Ray casts are timed per shape. Points and line segments 
+// get a margin, so that they have a volume and every pair can overlap.
+//
+// The output is comma-separated, one line per measurement:
+//
+//   shape1,shape2,query,poses,ns_per_query,hits,gjk_iterations,gjk_failures
+//
+// Hits count the queries that report contact. For ray casts shape2 is empty, 
+// and shapes that do not implement a ray test report no hits. The number of GJK iterations is averaged 
+// over the queries and is only reported if the library was built with 
+// STATISTICS defined. Queries that do not run GJK count zero iterations. 
+// Each GJK call restarts the count, so for complex shapes only the last 
+// leaf pair is counted. GJK failures count the queries in which GJK left 
+// its loop on a degenerate simplex or on a failed closest point search, and
+// are also only reported with STATISTICS. Building the library with 
+// SIGNED_VOLUMES as well compares the signed volumes sub-algorithm with 
+// Johnson's.
+
+#include <stdio.h>
+
+#include "BenchShapes.h"
+
+#ifdef STATISTICS
+extern int num_iterations;
+extern int num_irregularities;
+#endif
+
+const int NUM_POSES   = 256;
+const int NUM_REPEATS = 8;
+const int NUM_RAYS    = 2048;
+
+enum Pose { OVERLAPPING, TOUCHING, SEPARATED, NUM_POSE_TYPES };
+
+static const char *poseNames[NUM_POSE_TYPES] = { "overlapping", "touching", "separated" };
+
+// The distance of b beyond touching contact for each kind of pose
+static const float poseOffsets[NUM_POSE_TYPES] = { -0.1f, 0.0f, 0.5f };
+
+enum Query { INTERSECT, COMMON_POINT, PENETRATION_DEPTH, CLOSEST_POINTS, NUM_QUERY_TYPES };
+
+static const char *queryNames[NUM_QUERY_TYPES] = { "intersect", "common_point", "penetration_depth", "closest_points" };
+
+// The objects of a pair are passed to the queries in the order of their 
+// shape types, as DT_Test does.
+static void order(DT_ObjectHandle& a, DT_ObjectHandle& b)
+{
+	if (object(b).getType() < object(a).getType())
+	{
+		DT_ObjectHandle c = a;
+		a = b;
+		b = c;
+	}
+}
+
+static bool run(Query query, DT_ObjectHandle a, DT_ObjectHandle b)
+{
+	MT_Vector3 v(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+	MT_Point3 pa, pb;
+	switch (query)
+	{
+	case INTERSECT:
+		return intersect(object(a), object(b), v);
+	case COMMON_POINT:
+		return common_point(object(a), object(b), v, pa, pb);
+	case PENETRATION_DEPTH:
+		return penetration_depth(object(a), object(b), v, pa, pb);
+	case CLOSEST_POINTS:
+		// GJK stops at a small positive distance if the shapes overlap.
+		return closest_points(object(a), object(b), pa, pb) <= MT_Scalar(1.0e-6);
+	default:
+		return false;
+	}
+}
+
+static void report(const char *name1, const char *name2, const char *query, const char *poses,
+				   double seconds, int count, int hits, long iterations, int failures)
+{
+	printf("%s,%s,%s,%s,%.1f,%d,", name1, name2, query, poses, seconds * 1.0e9 / count, hits);
+#ifdef STATISTICS
+	printf("%.2f,%d", double(iterations) / count, failures);
+#else
+	(void)iterations;
+	(void)failures;
+	printf(",");
+#endif
+	printf("\n");
+}
+
+static void runPair(const Kind& kind1, const Kind& kind2)
+{
+	std::mt19937 rng(1);
+	int pose;
+	for (pose = 0; pose != NUM_POSE_TYPES; ++pose)
+	{
+		std::vector<DT_ObjectHandle> objects1, objects2;
+		while (int(objects1.size()) != NUM_POSES)
+		{
+			DT_ObjectHandle a = DT_CreateObject(0, kind1.m_shape);
+			DT_ObjectHandle b = DT_CreateObject(0, kind2.m_shape);
+			DT_SetMargin(a, kind1.m_margin);
+			DT_SetMargin(b, kind2.m_margin);
+			order(a, b);
+			if (makePose(a, b, poseOffsets[pose], rng))
+			{
+				objects1.push_back(a);
+				objects2.push_back(b);
+			}
+			else
+			{
+				DT_DestroyObject(a);
+				DT_DestroyObject(b);
+			}
+		}
+
+		int query;
+		for (query = 0; query != NUM_QUERY_TYPES; ++query)
+		{
+			int hits = 0;
+			long iterations = 0;
+			int failures = 0;
+			double start = now();
+			int r, i;
+			for (r = 0; r != NUM_REPEATS; ++r)
+			{
+				for (i = 0; i != NUM_POSES; ++i)
+				{
+#ifdef STATISTICS
+					num_iterations = 0;
+					int irregularities = num_irregularities;
+#endif
+					hits += run(Query(query), objects1[i], objects2[i]) ? 1 : 0;
+#ifdef STATISTICS
+					iterations += num_iterations;
+					failures += num_irregularities != irregularities ? 1 : 0;
+#endif
+				}
+			}
+			double seconds = now() - start;
+			report(kind1.m_name, kind2.m_name, queryNames[query], poseNames[pose], 
+				   seconds, NUM_REPEATS * NUM_POSES, hits / NUM_REPEATS, iterations, failures / NUM_REPEATS);
+		}
+
+		int i;
+		for (i = 0; i != NUM_POSES; ++i)
+		{
+			DT_DestroyObject(objects1[i]);
+			DT_DestroyObject(objects2[i]);
+		}
+	}
+}
+
+// Rays from random points at distance 2 to random points within 0.5 of 
+// the origin of the shape. 
+static void runRays(const Kind& kind)
+{
+	std::mt19937 rng(1);
+	std::normal_distribution<float> normal;
+	DT_ObjectHandle object = DT_CreateObject(0, kind.m_shape);
+	DT_SetMargin(object, kind.m_margin);
+
+	std::vector<MT_Point3> sources, targets;
+	int i;
+	for (i = 0; i != NUM_RAYS; ++i)
+	{
+		MT_Vector3 s = MT_Vector3(normal(rng), normal(rng), normal(rng)).normalized() * MT_Scalar(2.0);
+		MT_Vector3 t = MT_Vector3(normal(rng), normal(rng), normal(rng)).normalized() * MT_Scalar(0.5);
+		sources.push_back(MT_Point3(s[0], s[1], s[2]));
+		targets.push_back(MT_Point3(t[0], t[1], t[2]));
+	}
+
+	int hits = 0;
+	double start = now();
+	int r;
+	for (r = 0; r != NUM_REPEATS; ++r)
+	{
+		for (i = 0; i != NUM_RAYS; ++i)
+		{
+			DT_Vector3 source, target, normal;
+			sources[i].getValue(source);
+			targets[i].getValue(target);
+			DT_Scalar param;
+			hits += DT_ObjectRayCast(object, source, target, DT_Scalar(1.0), &param, normal) ? 1 : 0;
+		}
+	}
+	double seconds = now() - start;
+	report(kind.m_name, "", "ray_cast", "random", seconds, NUM_REPEATS * NUM_RAYS, hits / NUM_REPEATS, 0, 0);
+
+	DT_DestroyObject(object);
+}
+
+int main() 
+{
+	std::vector<MT_Point3> points;
+	std::vector<float> coords;
+	std::vector<Kind> kinds = makeKinds(points, coords);
+
+	printf("shape1,shape2,query,poses,ns_per_query,hits,gjk_iterations,gjk_failures\n");
+	size_t i, j;
+	for (i = 0; i != kinds.size(); ++i)
+	{
+		for (j = i; j != kinds.size(); ++j)
+		{
+			runPair(kinds[i], kinds[j]);
+		}
+	}
+	for (i = 0; i != kinds.size(); ++i)
+	{
+		runRays(kinds[i]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+// Throughput of the pair cache of a scene. Compares DT_EncounterTable 
+// with the std::set<DT_Encounter> it replaced, for inserting, finding, 
+// iterating over and erasing a set of random pairs.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <set>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+
+#include <SOLID.h>
+
+#include "DT_EncounterTable.h"
+
+const int NUM_OBJECTS = 20000;
+const int NUM_PAIRS   = 200000;
+const int NUM_ITER    = 20;
+
+typedef std::set<DT_Encounter> EncounterSet;
+
+static double now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void report(const char *table, const char *op, double seconds, int count)
+{
+	printf("%-6s %-8s %10.2f ns/op\n", table, op, seconds * 1.0e9 / count);
+}
+
+static MT_Scalar sumAxes(const EncounterSet& set)
+{
+	MT_Scalar sum = MT_Scalar(0.0);
+	EncounterSet::const_iterator it;
+	for (it = set.begin(); it != set.end(); ++it)
+	{
+		sum += (*it).separatingAxis()[0];
+	}
+	return sum;
+}
+
+static MT_Scalar sumAxes(const DT_EncounterTable& table)
+{
+	MT_Scalar sum = MT_Scalar(0.0);
+	DT_EncounterTable::const_iterator it;
+	for (it = table.begin(); it != table.end(); ++it)
+	{
+		sum += (*it).separatingAxis()[0];
+	}
+	return sum;
+}
+
+template <typename Table>
+void run(const char *name, const std::vector<DT_Encounter>& pairs)
+{
+	Table table;
+	
+	double start = now();
+	int i;
+	for (i = 0; i != NUM_PAIRS; ++i)
+	{
+		table.insert(pairs[i]);
+	}
+	report(name, "insert", now() - start, NUM_PAIRS);
+
+	start = now();
+	int found = 0;
+	for (i = 0; i != NUM_PAIRS; ++i)
+	{
+		found += table.find(pairs[NUM_PAIRS - 1 - i]) != table.end();
+	}
+	report(name, "find", now() - start, NUM_PAIRS);
+
+	start = now();
+	MT_Scalar sum = MT_Scalar(0.0);
+	int k;
+	for (k = 0; k != NUM_ITER; ++k)
+	{
+		sum += sumAxes(table);
+	}
+	report(name, "iterate", now() - start, NUM_ITER * table.size());
+
+	start = now();
+	for (i = 0; i != NUM_PAIRS; ++i)
+	{
+		table.erase(table.find(pairs[(i * 7919) % NUM_PAIRS]));
+	}
+	report(name, "erase", now() - start, NUM_PAIRS);
+
+	if (found != NUM_PAIRS || sum != MT_Scalar(0.0) || !table.empty())
+	{
+		fprintf(stderr, "%s: inconsistent results\n", name);
+	}
+}
+
+int main() 
+{
+	DT_ShapeHandle shape = DT_NewSphere(1.0f);
+
+	std::vector<DT_Object *> objects;
+	int i;
+	for (i = 0; i != NUM_OBJECTS; ++i) 
+	{
+		objects.push_back((DT_Object *)DT_CreateObject(0, shape));
+	}
+
+	// Distinct random pairs, in random order
+	std::set<DT_Encounter> unique;
+	while (unique.size() != NUM_PAIRS)
+	{
+		int a = rand() % NUM_OBJECTS;
+		int b = rand() % NUM_OBJECTS;
+		if (a != b)
+		{
+			unique.insert(DT_Encounter(objects[a], objects[b]));
+		}
+	}
+	std::vector<DT_Encounter> pairs(unique.begin(), unique.end());
+	std::shuffle(pairs.begin(), pairs.end(), std::mt19937(1));
+
+	printf("%d pairs of %d objects\n", NUM_PAIRS, NUM_OBJECTS);
+	run<EncounterSet>("set", pairs);
+	run<DT_EncounterTable>("table", pairs);
+
+	for (i = 0; i != NUM_OBJECTS; ++i) 
+	{
+		DT_DestroyObject((DT_ObjectHandle)objects[i]);
+	}
+	DT_DeleteShape(shape);
+
+	return 0;
+}
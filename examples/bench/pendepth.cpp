@@ -0,0 +1,190 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+
+// Accuracy and cost of the two penetration depth methods, the expanding
+// polytope algorithm (EPA) and Minkowski portal refinement (MPR), on pairs 
+// of boxes, cones, cylinders and polyhedra. Pairs of a sphere and a box have
+// closed forms and are left out. Each pair is placed on seeded random poses
+// at a given depth below touching contact, without margins and with a margin
+// of 0.1 on both objects, and DT_GetPenDepth is timed with either method. 
+//
+// The output is comma-separated, one line per pair, depth and margin:
+//
+//   shape1,shape2,margin,depth,poses,epa_ns,mpr_ns,epa_hits,mpr_hits,mean_excess,max_excess,mean_angle
+//
+// The excess is the relative amount by which the MPR depth exceeds the EPA 
+// depth, and the angle, in degrees, is the one between the two depth 
+// vectors, both over the poses on which both methods report contact.
+
+#include <stdio.h>
+#include <string.h>
+
+#include "BenchShapes.h"
+
+const int NUM_POSES   = 256;
+const int NUM_REPEATS = 8;
+
+struct Depth {
+	float m_depth;
+	float m_length;
+	float m_dir[3];
+};
+
+// Times DT_GetPenDepth on all poses and keeps the depth vectors of the 
+// last round.
+static double measure(const std::vector<DT_ObjectHandle>& objects1, 
+					  const std::vector<DT_ObjectHandle>& objects2, 
+					  std::vector<Depth>& depths, int& hits)
+{
+	double start = now();
+	int r, i;
+	for (r = 0; r != NUM_REPEATS; ++r)
+	{
+		hits = 0;
+		for (i = 0; i != NUM_POSES; ++i)
+		{
+			DT_Vector3 point1, point2;
+			Depth& depth = depths[i];
+			depth.m_length = 0.0f;
+			if (DT_GetPenDepth(objects1[i], objects2[i], point1, point2))
+			{
+				int k;
+				for (k = 0; k != 3; ++k)
+				{
+					depth.m_dir[k] = float(point2[k] - point1[k]);
+				}
+				depth.m_length = sqrtf(depth.m_dir[0] * depth.m_dir[0] + 
+									   depth.m_dir[1] * depth.m_dir[1] + 
+									   depth.m_dir[2] * depth.m_dir[2]);
+				++hits;
+			}
+		}
+	}
+	return (now() - start) * 1.0e9 / (NUM_REPEATS * NUM_POSES);
+}
+
+static void runPair(const Kind& kind1, const Kind& kind2, float margin, float depth)
+{
+	std::mt19937 rng(1);
+	std::vector<DT_ObjectHandle> objects1, objects2;
+	while (int(objects1.size()) != NUM_POSES)
+	{
+		DT_ObjectHandle a = DT_CreateObject(0, kind1.m_shape);
+		DT_ObjectHandle b = DT_CreateObject(0, kind2.m_shape);
+		DT_SetMargin(a, margin);
+		DT_SetMargin(b, margin);
+		if (makePose(a, b, -depth, rng))
+		{
+			objects1.push_back(a);
+			objects2.push_back(b);
+		}
+		else
+		{
+			DT_DestroyObject(a);
+			DT_DestroyObject(b);
+		}
+	}
+
+	std::vector<Depth> epa(NUM_POSES), mpr(NUM_POSES);
+	int epa_hits, mpr_hits;
+	DT_SetPenDepthMethod(DT_PENDEPTH_EPA);
+	double epa_ns = measure(objects1, objects2, epa, epa_hits);
+	DT_SetPenDepthMethod(DT_PENDEPTH_MPR);
+	double mpr_ns = measure(objects1, objects2, mpr, mpr_hits);
+	DT_SetPenDepthMethod(DT_PENDEPTH_EPA);
+
+	double sum_excess = 0.0;
+	double max_excess = 0.0;
+	double sum_angle = 0.0;
+	int count = 0;
+	int i;
+	for (i = 0; i != NUM_POSES; ++i)
+	{
+		if (epa[i].m_length > 0.0f && mpr[i].m_length > 0.0f)
+		{
+			double excess = (mpr[i].m_length - epa[i].m_length) / epa[i].m_length;
+			double cosine = (epa[i].m_dir[0] * mpr[i].m_dir[0] + 
+							 epa[i].m_dir[1] * mpr[i].m_dir[1] + 
+							 epa[i].m_dir[2] * mpr[i].m_dir[2]) / (epa[i].m_length * mpr[i].m_length);
+			sum_excess += excess;
+			if (max_excess < excess)
+			{
+				max_excess = excess;
+			}
+			sum_angle += acos(cosine < 1.0 ? cosine : 1.0) * 180.0 / M_PI;
+			++count;
+		}
+	}
+
+	printf("%s,%s,%.1f,%.2f,%d,%.1f,%.1f,%d,%d,%.4f,%.4f,%.2f\n", kind1.m_name, kind2.m_name, margin, depth, 
+		   NUM_POSES, epa_ns, mpr_ns, epa_hits, mpr_hits, 
+		   count ? sum_excess / count : 0.0, max_excess, count ? sum_angle / count : 0.0);
+
+	for (i = 0; i != NUM_POSES; ++i)
+	{
+		DT_DestroyObject(objects1[i]);
+		DT_DestroyObject(objects2[i]);
+	}
+}
+
+int main() 
+{
+	std::vector<MT_Point3> points;
+	std::vector<float> coords;
+	std::vector<Kind> all = makeKinds(points, coords);
+
+	// The convex shapes without closed forms or margins of their own
+	std::vector<Kind> kinds;
+	size_t i, j;
+	for (i = 0; i != all.size(); ++i)
+	{
+		const char *name = all[i].m_name;
+		if (!strcmp(name, "box") || !strcmp(name, "cone") || 
+			!strcmp(name, "cylinder") || !strcmp(name, "polyhedron"))
+		{
+			kinds.push_back(all[i]);
+		}
+	}
+
+	static const float margins[] = { 0.0f, 0.1f };
+	static const float depths[] = { 0.02f, 0.2f, 0.4f };
+
+	printf("shape1,shape2,margin,depth,poses,epa_ns,mpr_ns,epa_hits,mpr_hits,mean_excess,max_excess,mean_angle\n");
+	int m, d;
+	for (i = 0; i != kinds.size(); ++i)
+	{
+		for (j = i; j != kinds.size(); ++j)
+		{
+			for (m = 0; m != 2; ++m)
+			{
+				for (d = 0; d != 3; ++d)
+				{
+					runPair(kinds[i], kinds[j], margins[m], depths[d]);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -118,7 +118,7 @@ public:
 		m_points[1].setValue(points[1]);
 		m_points[2].setValue(points[2]);
 
-		m_base = DT_NewVertexBase(m_points, 0);
+		m_base = DT_NewVertexBase(m_points, sizeof(MT_Point3));
 #if defined(USE_HULL)
 
 		setShape(DT_NewPolytope(m_base));
@@ -168,7 +168,7 @@ public:
 				(bits & 0x4) ? e[2] : -e[2]);
 		}
 
-		m_base = DT_NewVertexBase(m_vertices, 0);
+		m_base = DT_NewVertexBase(m_vertices, sizeof(MT_Point3));
 
 #if defined(USE_HULL)
 		setShape(DT_NewPolytope(m_base));
@@ -271,9 +271,7 @@ namespace MT {
 	inline Matrix3x3<Scalar>& 
 	Matrix3x3<Scalar>::operator*=(const Matrix3x3<Scalar>& m)
 	{
-		setValue(m.tdot(0, m_el[0]), m.tdot(1, m_el[0]), m.tdot(2, m_el[0]),
-				 m.tdot(0, m_el[1]), m.tdot(1, m_el[1]), m.tdot(2, m_el[1]),
-				 m.tdot(0, m_el[2]), m.tdot(1, m_el[2]), m.tdot(2, m_el[2]));
+		*this = *this * m;
 		return *this;
 	}
 	
@@ -289,10 +287,11 @@ namespace MT {
 	inline Matrix3x3<Scalar> 
 	Matrix3x3<Scalar>::absolute() const
 	{
-		return Matrix3x3<Scalar>(
-			Scalar_traits<Scalar>::abs(m_el[0][0]), Scalar_traits<Scalar>::abs(m_el[0][1]), Scalar_traits<Scalar>::abs(m_el[0][2]),
-			Scalar_traits<Scalar>::abs(m_el[1][0]), Scalar_traits<Scalar>::abs(m_el[1][1]), Scalar_traits<Scalar>::abs(m_el[1][2]),
-			Scalar_traits<Scalar>::abs(m_el[2][0]), Scalar_traits<Scalar>::abs(m_el[2][1]), Scalar_traits<Scalar>::abs(m_el[2][2]));
+		Matrix3x3<Scalar> m;
+		m[0] = m_el[0].absolute();
+		m[1] = m_el[1].absolute();
+		m[2] = m_el[2].absolute();
+		return m;
 	}
 
 	template <typename Scalar>
@@ -330,34 +329,31 @@ namespace MT {
 	inline Matrix3x3<Scalar> 
 	Matrix3x3<Scalar>::transposeTimes(const Matrix3x3<Scalar>& m) const
 	{
-		return Matrix3x3<Scalar>(
-			m_el[0][0] * m[0][0] + m_el[1][0] * m[1][0] + m_el[2][0] * m[2][0],
-			m_el[0][0] * m[0][1] + m_el[1][0] * m[1][1] + m_el[2][0] * m[2][1],
-			m_el[0][0] * m[0][2] + m_el[1][0] * m[1][2] + m_el[2][0] * m[2][2],
-			m_el[0][1] * m[0][0] + m_el[1][1] * m[1][0] + m_el[2][1] * m[2][0],
-			m_el[0][1] * m[0][1] + m_el[1][1] * m[1][1] + m_el[2][1] * m[2][1],
-			m_el[0][1] * m[0][2] + m_el[1][1] * m[1][2] + m_el[2][1] * m[2][2],
-			m_el[0][2] * m[0][0] + m_el[1][2] * m[1][0] + m_el[2][2] * m[2][0],
-			m_el[0][2] * m[0][1] + m_el[1][2] * m[1][1] + m_el[2][2] * m[2][1],
-			m_el[0][2] * m[0][2] + m_el[1][2] * m[1][2] + m_el[2][2] * m[2][2]);
+		Matrix3x3<Scalar> t;
+		t[0] = Vector3<Scalar>(m_el[0][0], m_el[1][0], m_el[2][0]) * m;
+		t[1] = Vector3<Scalar>(m_el[0][1], m_el[1][1], m_el[2][1]) * m;
+		t[2] = Vector3<Scalar>(m_el[0][2], m_el[1][2], m_el[2][2]) * m;
+		return t;
 	}
 	
 	template <typename Scalar>
 	inline Matrix3x3<Scalar> 
 	Matrix3x3<Scalar>::timesTranspose(const Matrix3x3<Scalar>& m) const
 	{
-		return Matrix3x3<Scalar>(
-			m_el[0].dot(m[0]), m_el[0].dot(m[1]), m_el[0].dot(m[2]),
-			m_el[1].dot(m[0]), m_el[1].dot(m[1]), m_el[1].dot(m[2]),
-			m_el[2].dot(m[0]), m_el[2].dot(m[1]), m_el[2].dot(m[2]));
-		
+		Matrix3x3<Scalar> t;
+		t[0] = m * m_el[0];
+		t[1] = m * m_el[1];
+		t[2] = m * m_el[2];
+		return t;
 	}
 
 	template <typename Scalar>
 	inline Vector3<Scalar> 
 	operator*(const Matrix3x3<Scalar>& m, const Vector3<Scalar>& v) 
 	{
-		return Vector3<Scalar>(m[0].dot(v), m[1].dot(v), m[2].dot(v));
+		Vector3<Scalar> r;
+		dots3(&r[0], &m[0][0], &m[1][0], &m[2][0], &v[0]);
+		return r;
 	}
 	
 
@@ -365,17 +361,20 @@ namespace MT {
 	inline Vector3<Scalar>
 	operator*(const Vector3<Scalar>& v, const Matrix3x3<Scalar>& m)
 	{
-		return Vector3<Scalar>(m.tdot(0, v), m.tdot(1, v), m.tdot(2, v));
+		Vector3<Scalar> r;
+		combine3(&r[0], &m[0][0], &m[1][0], &m[2][0], &v[0]);
+		return r;
 	}
 
 	template <typename Scalar>
 	inline Matrix3x3<Scalar> 
 	operator*(const Matrix3x3<Scalar>& m1, const Matrix3x3<Scalar>& m2)
 	{
-		return Matrix3x3<Scalar>(
-			m2.tdot(0, m1[0]), m2.tdot(1, m1[0]), m2.tdot(2, m1[0]),
-			m2.tdot(0, m1[1]), m2.tdot(1, m1[1]), m2.tdot(2, m1[1]),
-			m2.tdot(0, m1[2]), m2.tdot(1, m1[2]), m2.tdot(2, m1[2]));
+		Matrix3x3<Scalar> m;
+		m[0] = m1[0] * m2;
+		m[1] = m1[1] * m2;
+		m[2] = m1[2] * m2;
+		return m;
 	}
 }
 
@@ -0,0 +1,314 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#ifdef USE_SSE
+#include <xmmintrin.h>
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#endif
+
+namespace MT {
+
+	// Coordinate-wise operations on the storage of three-tuples. The generic
+	// versions loop over three scalars. If USE_SSE is defined, tuples of 
+	// floats are padded to four lanes and use SSE. Tuples of doubles do the 
+	// same with AVX if the compiler targets it (__AVX__). The padding lane 
+	// is always zero. The SIMD versions perform the same operations in the
+	// same order as the generic ones, so results do not depend on the switch.
+	// 
+	// Loads and stores are unaligned. Only the padded storage of a tuple may 
+	// be passed, never a plain array of three scalars. Arrays of padded 
+	// tuples are not packed, so a vertex base over an array of MT_Point3 
+	// needs sizeof(MT_Point3) as its stride.
+
+	template <typename Scalar>
+	struct Lanes {
+		enum { SIZE = 3 };
+	};
+
+	template <typename Scalar>
+	inline void clear_pad(Scalar *) {}
+
+	template <typename Scalar>
+	inline void set3(Scalar *r, const Scalar& x, const Scalar& y, const Scalar& z)
+	{
+		r[0] = x; r[1] = y; r[2] = z;
+	}
+
+	template <typename Scalar>
+	inline void add3(Scalar *r, const Scalar *a, const Scalar *b)
+	{
+		r[0] = a[0] + b[0]; r[1] = a[1] + b[1]; r[2] = a[2] + b[2];
+	}
+
+	template <typename Scalar>
+	inline void sub3(Scalar *r, const Scalar *a, const Scalar *b)
+	{
+		r[0] = a[0] - b[0]; r[1] = a[1] - b[1]; r[2] = a[2] - b[2];
+	}
+
+	template <typename Scalar>
+	inline void scale3(Scalar *r, const Scalar *a, const Scalar& s)
+	{
+		r[0] = a[0] * s; r[1] = a[1] * s; r[2] = a[2] * s;
+	}
+
+	template <typename Scalar>
+	inline void neg3(Scalar *r, const Scalar *a)
+	{
+		r[0] = -a[0]; r[1] = -a[1]; r[2] = -a[2];
+	}
+
+	template <typename Scalar>
+	inline void abs3(Scalar *r, const Scalar *a)
+	{
+		r[0] = Scalar_traits<Scalar>::abs(a[0]); 
+		r[1] = Scalar_traits<Scalar>::abs(a[1]); 
+		r[2] = Scalar_traits<Scalar>::abs(a[2]);
+	}
+
+	// As GEN_min and GEN_max per coordinate: ties and NaNs keep 'a'.
+
+	template <typename Scalar>
+	inline void min3(Scalar *r, const Scalar *a, const Scalar *b)
+	{
+		r[0] = b[0] < a[0] ? b[0] : a[0];
+		r[1] = b[1] < a[1] ? b[1] : a[1];
+		r[2] = b[2] < a[2] ? b[2] : a[2];
+	}
+
+	template <typename Scalar>
+	inline void max3(Scalar *r, const Scalar *a, const Scalar *b)
+	{
+		r[0] = a[0] < b[0] ? b[0] : a[0];
+		r[1] = a[1] < b[1] ? b[1] : a[1];
+		r[2] = a[2] < b[2] ? b[2] : a[2];
+	}
+
+	template <typename Scalar>
+	inline bool lessEqual3(const Scalar *a, const Scalar *b)
+	{
+		return a[0] <= b[0] && a[1] <= b[1] && a[2] <= b[2];
+	}
+
+	template <typename Scalar>
+	inline Scalar dot3(const Scalar *a, const Scalar *b)
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	template <typename Scalar>
+	inline void cross3(Scalar *r, const Scalar *a, const Scalar *b)
+	{
+		Scalar x = a[1] * b[2] - a[2] * b[1];
+		Scalar y = a[2] * b[0] - a[0] * b[2];
+		Scalar z = a[0] * b[1] - a[1] * b[0];
+		r[0] = x; r[1] = y; r[2] = z;
+	}
+
+	// The dot products of the rows 'm0', 'm1' and 'm2' with 'x'.
+
+	template <typename Scalar>
+	inline void dots3(Scalar *r, const Scalar *m0, const Scalar *m1, const Scalar *m2, const Scalar *x)
+	{
+		Scalar x0 = dot3(m0, x);
+		Scalar x1 = dot3(m1, x);
+		Scalar x2 = dot3(m2, x);
+		r[0] = x0; r[1] = x1; r[2] = x2;
+	}
+
+	// The sum of the rows 'm0', 'm1' and 'm2' weighted by the coordinates of 'x'.
+
+	template <typename Scalar>
+	inline void combine3(Scalar *r, const Scalar *m0, const Scalar *m1, const Scalar *m2, const Scalar *x)
+	{
+		Scalar x0 = m0[0] * x[0] + m1[0] * x[1] + m2[0] * x[2];
+		Scalar x1 = m0[1] * x[0] + m1[1] * x[1] + m2[1] * x[2];
+		Scalar x2 = m0[2] * x[0] + m1[2] * x[1] + m2[2] * x[2];
+		r[0] = x0; r[1] = x1; r[2] = x2;
+	}
+
+#ifdef USE_SSE
+
+	template <>
+	struct Lanes<float> {
+		enum { SIZE = 4 };
+	};
+
+	inline void clear_pad(float *a) { a[3] = 0.0f; }
+
+	// A single store, so that a vector load of the result right after can 
+	// take it from the store buffer. Separate stores of the coordinates 
+	// would stall that load.
+	inline void set3(float *r, const float& x, const float& y, const float& z)
+	{
+		_mm_storeu_ps(r, _mm_setr_ps(x, y, z, 0.0f));
+	}
+
+	inline void add3(float *r, const float *a, const float *b)
+	{
+		_mm_storeu_ps(r, _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void sub3(float *r, const float *a, const float *b)
+	{
+		_mm_storeu_ps(r, _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+	}
+
+	inline void scale3(float *r, const float *a, const float& s)
+	{
+		_mm_storeu_ps(r, _mm_mul_ps(_mm_loadu_ps(a), _mm_set1_ps(s)));
+	}
+
+	inline void neg3(float *r, const float *a)
+	{
+		_mm_storeu_ps(r, _mm_xor_ps(_mm_loadu_ps(a), _mm_set_ps(0.0f, -0.0f, -0.0f, -0.0f)));
+	}
+
+	inline void abs3(float *r, const float *a)
+	{
+		_mm_storeu_ps(r, _mm_andnot_ps(_mm_set1_ps(-0.0f), _mm_loadu_ps(a)));
+	}
+
+	inline void min3(float *r, const float *a, const float *b)
+	{
+		_mm_storeu_ps(r, _mm_min_ps(_mm_loadu_ps(b), _mm_loadu_ps(a)));
+	}
+
+	inline void max3(float *r, const float *a, const float *b)
+	{
+		_mm_storeu_ps(r, _mm_max_ps(_mm_loadu_ps(b), _mm_loadu_ps(a)));
+	}
+
+	inline bool lessEqual3(const float *a, const float *b)
+	{
+		return (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(a), _mm_loadu_ps(b))) & 0x7) == 0x7;
+	}
+
+	inline void cross3(float *r, const float *a, const float *b)
+	{
+		__m128 u = _mm_loadu_ps(a);
+		__m128 v = _mm_loadu_ps(b);
+		__m128 u_yzx = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 u_zxy = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 1, 0, 2));
+		__m128 v_yzx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+		__m128 v_zxy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2));
+		_mm_storeu_ps(r, _mm_sub_ps(_mm_mul_ps(u_yzx, v_zxy), _mm_mul_ps(u_zxy, v_yzx)));
+	}
+
+	inline void dots3(float *r, const float *m0, const float *m1, const float *m2, const float *x)
+	{
+		set3(r, dot3(m0, x), dot3(m1, x), dot3(m2, x));
+	}
+
+	inline void combine3(float *r, const float *m0, const float *m1, const float *m2, const float *x)
+	{
+		__m128 s = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m0), _mm_set1_ps(x[0])), 
+							  _mm_mul_ps(_mm_loadu_ps(m1), _mm_set1_ps(x[1])));
+		_mm_storeu_ps(r, _mm_add_ps(s, _mm_mul_ps(_mm_loadu_ps(m2), _mm_set1_ps(x[2]))));
+	}
+
+#ifdef __AVX__
+
+	// Cross products are computed per coordinate, since AVX cannot permute 
+	// doubles across its two halves in one instruction.
+
+	template <>
+	struct Lanes<double> {
+		enum { SIZE = 4 };
+	};
+
+	inline void clear_pad(double *a) { a[3] = 0.0; }
+
+	inline void set3(double *r, const double& x, const double& y, const double& z)
+	{
+		_mm256_storeu_pd(r, _mm256_setr_pd(x, y, z, 0.0));
+	}
+
+	inline void add3(double *r, const double *a, const double *b)
+	{
+		_mm256_storeu_pd(r, _mm256_add_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+	}
+
+	inline void sub3(double *r, const double *a, const double *b)
+	{
+		_mm256_storeu_pd(r, _mm256_sub_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b)));
+	}
+
+	inline void scale3(double *r, const double *a, const double& s)
+	{
+		_mm256_storeu_pd(r, _mm256_mul_pd(_mm256_loadu_pd(a), _mm256_set1_pd(s)));
+	}
+
+	inline void neg3(double *r, const double *a)
+	{
+		_mm256_storeu_pd(r, _mm256_xor_pd(_mm256_loadu_pd(a), _mm256_set_pd(0.0, -0.0, -0.0, -0.0)));
+	}
+
+	inline void abs3(double *r, const double *a)
+	{
+		_mm256_storeu_pd(r, _mm256_andnot_pd(_mm256_set1_pd(-0.0), _mm256_loadu_pd(a)));
+	}
+
+	inline void min3(double *r, const double *a, const double *b)
+	{
+		_mm256_storeu_pd(r, _mm256_min_pd(_mm256_loadu_pd(b), _mm256_loadu_pd(a)));
+	}
+
+	inline void max3(double *r, const double *a, const double *b)
+	{
+		_mm256_storeu_pd(r, _mm256_max_pd(_mm256_loadu_pd(b), _mm256_loadu_pd(a)));
+	}
+
+	inline bool lessEqual3(const double *a, const double *b)
+	{
+		return (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(a), _mm256_loadu_pd(b), _CMP_LE_OQ)) & 0x7) == 0x7;
+	}
+
+	inline void dots3(double *r, const double *m0, const double *m1, const double *m2, const double *x)
+	{
+		set3(r, dot3(m0, x), dot3(m1, x), dot3(m2, x));
+	}
+
+	inline void cross3(double *r, const double *a, const double *b)
+	{
+		set3(r, a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]);
+	}
+
+	inline void combine3(double *r, const double *m0, const double *m1, const double *m2, const double *x)
+	{
+		__m256d s = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(m0), _mm256_set1_pd(x[0])), 
+								  _mm256_mul_pd(_mm256_loadu_pd(m1), _mm256_set1_pd(x[1])));
+		_mm256_storeu_pd(r, _mm256_add_pd(s, _mm256_mul_pd(_mm256_loadu_pd(m2), _mm256_set1_pd(x[2]))));
+	}
+
+#endif
+
+#endif
+}
+
+#endif
@@ -27,12 +27,17 @@
 #include <cassert>
 #include <iostream>
 
+#include "Simd.h"
+
 namespace MT {
 
 	template <typename Scalar>
 	class Tuple3 {
 	public:
-		Tuple3() {}
+		Tuple3() 
+		{
+			clear_pad(m_co);
+		}
 		
 		template <typename Scalar2>
 		explicit Tuple3(const Scalar2 *v) 
@@ -55,9 +60,7 @@ namespace MT {
 		template <typename Scalar2>
 		Tuple3<Scalar>& operator=(const Tuple3<Scalar2>& t) 
 		{ 
-			m_co[0] = Scalar(t[0]); 
-			m_co[1] = Scalar(t[1]); 
-			m_co[2] = Scalar(t[2]);
+			set3(m_co, Scalar(t[0]), Scalar(t[1]), Scalar(t[2]));
 			return *this;
 		}
 		
@@ -79,17 +82,13 @@ namespace MT {
 		template <typename Scalar2>
 		void setValue(const Scalar2 *v) 
 		{
-			m_co[0] = Scalar(v[0]); 
-			m_co[1] = Scalar(v[1]); 
-			m_co[2] = Scalar(v[2]);
+			set3(m_co, Scalar(v[0]), Scalar(v[1]), Scalar(v[2]));
 		}
 
 		template <typename Scalar2>
 		void setValue(const Scalar2& x, const Scalar2& y, const Scalar2& z)
 		{
-			m_co[0] = Scalar(x); 
-			m_co[1] = Scalar(y); 
-			m_co[2] = Scalar(z);
+			set3(m_co, Scalar(x), Scalar(y), Scalar(z));
 		}
 
 		template <typename Scalar2>
@@ -101,7 +100,8 @@ namespace MT {
 		}
     
 	protected:
-		Scalar m_co[3];                            
+		// Padded to the SIMD width for the operations in Simd.h.
+		Scalar m_co[Lanes<Scalar>::SIZE];                            
 	};
 
 	template <typename Scalar>
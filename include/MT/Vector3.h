@@ -45,19 +45,19 @@ namespace MT {
 		
 		Vector3<Scalar>& operator+=(const Vector3<Scalar>& v)
 		{
-			this->m_co[0] += v[0]; this->m_co[1] += v[1]; this->m_co[2] += v[2];
+			add3(this->m_co, this->m_co, &v[0]);
 			return *this;
 		}
 		
 		Vector3<Scalar>& operator-=(const Vector3<Scalar>& v) 
 		{
-			this->m_co[0] -= v[0]; this->m_co[1] -= v[1]; this->m_co[2] -= v[2];
+			sub3(this->m_co, this->m_co, &v[0]);
 			return *this;
 		}
 
 		Vector3<Scalar>& operator*=(const Scalar& s)
 		{
-			this->m_co[0] *= s; this->m_co[1] *= s; this->m_co[2] *= s;
+			scale3(this->m_co, this->m_co, s);
 			return *this;
 		}
 		
@@ -69,7 +69,7 @@ namespace MT {
   
 		Scalar dot(const Vector3<Scalar>& v) const
 		{
-			return this->m_co[0] * v[0] + this->m_co[1] * v[1] + this->m_co[2] * v[2];
+			return dot3(this->m_co, &v[0]);
 		}
 
 		Scalar length2() const
@@ -111,16 +111,16 @@ namespace MT {
    
 		Vector3<Scalar> absolute() const 
 		{
-			return Vector3<Scalar>(Scalar_traits<Scalar>::abs(this->m_co[0]), 
-								   Scalar_traits<Scalar>::abs(this->m_co[1]), 
-								   Scalar_traits<Scalar>::abs(this->m_co[2]));
+			Vector3<Scalar> r;
+			abs3(&r[0], this->m_co);
+			return r;
 		}
 
 		Vector3<Scalar> cross(const Vector3<Scalar>& v) const
 		{
-			return Vector3<Scalar>(this->m_co[1] * v[2] - this->m_co[2] * v[1],
-								   this->m_co[2] * v[0] - this->m_co[0] * v[2],
-								   this->m_co[0] * v[1] - this->m_co[1] * v[0]);
+			Vector3<Scalar> r;
+			cross3(&r[0], this->m_co, &v[0]);
+			return r;
 		}
 		
 		Scalar triple(const Vector3<Scalar>& v1, const Vector3<Scalar>& v2) const
@@ -130,6 +130,25 @@ namespace MT {
 				   this->m_co[2] * (v1[0] * v2[1] - v1[1] * v2[0]);
 		}
 
+		// Coordinate-wise minimum and maximum, as GEN_set_min and GEN_set_max.
+
+		void setMin(const Vector3<Scalar>& v)
+		{
+			min3(this->m_co, this->m_co, &v[0]);
+		}
+
+		void setMax(const Vector3<Scalar>& v)
+		{
+			max3(this->m_co, this->m_co, &v[0]);
+		}
+
+		// Whether no coordinate exceeds the one of 'v'.
+
+		bool lessEqual(const Vector3<Scalar>& v) const
+		{
+			return lessEqual3(this->m_co, &v[0]);
+		}
+
 		int minAxis() const
 		{
 			return this->m_co[0] < this->m_co[1] ? (this->m_co[0] < this->m_co[2] ? 0 : 2) : (this->m_co[1] < this->m_co[2] ? 1 : 2);
@@ -172,28 +191,36 @@ namespace MT {
 	inline Vector3<Scalar> 
 	operator+(const Vector3<Scalar>& v1, const Vector3<Scalar>& v2) 
 	{
-		return Vector3<Scalar>(v1[0] + v2[0], v1[1] + v2[1], v1[2] + v2[2]);
+		Vector3<Scalar> r;
+		add3(&r[0], &v1[0], &v2[0]);
+		return r;
 	}
 
 	template <typename Scalar>
 	inline Vector3<Scalar> 
 	operator-(const Vector3<Scalar>& v1, const Vector3<Scalar>& v2)
 	{
-		return Vector3<Scalar>(v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2]);
+		Vector3<Scalar> r;
+		sub3(&r[0], &v1[0], &v2[0]);
+		return r;
 	}
 	
 	template <typename Scalar>
 	inline Vector3<Scalar> 
 	operator-(const Vector3<Scalar>& v)
 	{
-		return Vector3<Scalar>(-v[0], -v[1], -v[2]);
+		Vector3<Scalar> r;
+		neg3(&r[0], &v[0]);
+		return r;
 	}
 	
 	template <typename Scalar>
 	inline Vector3<Scalar> 
 	operator*(const Vector3<Scalar>& v, const Scalar& s)
 	{
-		return Vector3<Scalar>(v[0] * s, v[1] * s, v[2] * s);
+		Vector3<Scalar> r;
+		scale3(&r[0], &v[0], s);
+		return r;
 	}
 	
 	template <typename Scalar>
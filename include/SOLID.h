@@ -41,13 +41,51 @@
 		DT_WITNESSED_RESPONSE,           /* A point common to both objects
 											is returned as collision data
 										 */
-		DT_DEPTH_RESPONSE                /* The penetration depth is returned
+		DT_DEPTH_RESPONSE,               /* The penetration depth is returned
 											as collision data. The penetration depth
 											is the shortest vector over which one 
 											object needs to be translated in order
 											to bring the objects in touching contact. 
 										 */ 
+		DT_APPROX_DEPTH_RESPONSE         /* As DT_DEPTH_RESPONSE, but the depth is 
+											approximated by Minkowski portal refinement,
+											whatever the penetration depth method. 
+											The approximate depth may be longer than the
+											shortest vector
+										 */
 	} DT_ResponseType;
+
+	typedef enum DT_BVHQuality {
+		DT_BVH_FAST,                     /* Split boxes at the center of their longest 
+											axis. Fast to build (default) 
+										 */
+		DT_BVH_SAH                       /* Split by a binned surface area heuristic. 
+											Slower to build, but tighter trees need
+											fewer box tests in queries 
+										 */
+	} DT_BVHQuality;
+
+	typedef enum DT_BroadPhase {
+		DT_SWEEP_AND_PRUNE,              /* Sorted lists of bounding-box endpoints per 
+											axis (default) 
+										 */
+		DT_DYNAMIC_TREE                  /* A balanced tree of enlarged bounding boxes. 
+											Better for scenes in which many objects 
+											overlap on one axis, such as a flat map,
+											or in which objects jump
+										 */
+	} DT_BroadPhase;
+
+	typedef enum DT_PenDepthMethod {
+		DT_PENDEPTH_EPA,                 /* The expanding polytope algorithm finds the 
+											shortest penetration vector (default) 
+										 */
+		DT_PENDEPTH_MPR                  /* Minkowski portal refinement measures the 
+											penetration along the line through the 
+											centers of the objects. Faster, and close
+											to the shortest vector for shallow contacts
+										 */
+	} DT_PenDepthMethod;
     
 /* For witnessed response, the following structure represents a common point. The world 
    coordinates of 'point1' and 'point2' coincide. 'normal' is the zero vector.
@@ -73,6 +111,38 @@
 										   void *client_object1,
 										   void *client_object2,
 										   const DT_CollData *coll_data);
+
+/* A query callback is called by 'DT_QueryBox' for each object found. */
+
+	typedef void (*DT_QueryCallback)(void *client_data,
+									 void *client_object);
+
+/* A contact is a colliding pair of objects as collected by 'DT_TestCollect'. The client
+   objects and collision data are ordered as they would be passed to a response callback.
+   'type' is the response type of the pair. For a simple response 'coll_data' is zero.
+*/
+
+	typedef struct DT_Contact {
+		void             *client_object1;
+		void             *client_object2;
+		DT_ResponseClass  responseClass1;
+		DT_ResponseClass  responseClass2;
+		DT_ResponseType   type;
+		DT_CollData       coll_data;
+	} DT_Contact;
+
+/* A contact buffer is either provided by the client, by pointing 'contacts' to an array
+   of 'capacity' contacts and setting 'storage' to zero, or created by the library using
+   'DT_CreateContactBuffer'. A buffer created by the library grows as needed. 'count' is
+   the number of contacts in the buffer.
+*/
+
+	typedef struct DT_ContactBuffer {
+		DT_Contact *contacts;
+		DT_Count    capacity;
+		DT_Count    count;
+		void       *storage;
+	} DT_ContactBuffer;
 										
 /* Shape definition */
 
@@ -93,6 +163,12 @@
 	 DT_ShapeHandle DT_NewComplexShape(DT_VertexBaseHandle vertexBase);
 	 void           DT_EndComplexShape();
 
+/* Selects how DT_EndComplexShape builds the bounding-box tree of the shape. 
+   Applies to complex shapes finished after the call. 
+*/
+
+	 void           DT_SetBVHBuildQuality(DT_BVHQuality quality);
+
 	 DT_ShapeHandle DT_NewPolytope(DT_VertexBaseHandle vertexBase);
 	 void           DT_EndPolytope();
 
@@ -130,6 +206,40 @@
    
 	 void DT_SetMargin(DT_ObjectHandle object, DT_Scalar margin);
 
+/* A static object is one that rarely or never moves, such as a wall or a prop. A 
+   sweep-and-prune scene keeps static objects apart from the others, so that the 
+   moving objects need not be sorted past them. A static object can still be moved,
+   but each move costs a query of the whole scene. Changing the flag of an object 
+   that is in a scene ends its overlaps and begins them again. 
+*/
+
+	 void DT_SetObjectStatic(DT_ObjectHandle object, DT_Bool is_static);
+
+/* Two objects are tested only if the category of each shares a bit with the mask 
+   of the other. Unlike DT_NO_RESPONSE, this is decided in the broad phase, so the 
+   pairs that are filtered out are never kept in a scene. An object starts with all
+   bits set in both. Changing the filter of an object that is in a scene begins 
+   and ends its overlaps as the new filter decides. 
+*/
+
+	 void DT_SetObjectFilter(DT_ObjectHandle object, DT_Mask category, DT_Mask mask);
+
+/* The broad phase may keep a looser box of an object than its actual box. The 
+   loose box is the actual box enlarged by the slack on each side, and stretched 
+   along the velocity, which is the displacement expected before the next move. 
+   The broad phase box is updated only when the actual box leaves it, so an 
+   object that jitters or moves steadily does not churn the overlaps. The pairs 
+   of loose boxes are tested exactly, so only the number of tests is affected. 
+   DT_GetBBoxUpdates returns how many moves of the object did and did not update
+   the broad phase box, which helps to tune the slack. The slack and velocity are
+   zero by default.
+*/
+
+	 void DT_SetObjectSlack(DT_ObjectHandle object, DT_Scalar slack);
+	 void DT_SetObjectVelocity(DT_ObjectHandle object, const DT_Vector3 velocity);
+	 void DT_GetBBoxUpdates(DT_ObjectHandle object, 
+							DT_Count *updated, DT_Count *skipped);
+
 
 /* These commands assume a column-major 4x4 OpenGL matrix representation */
 
@@ -157,13 +267,78 @@
 /* Scene */
 
 	 DT_SceneHandle DT_CreateScene(); 
+	 DT_SceneHandle DT_CreateSceneOfType(DT_BroadPhase type);
 	 void           DT_DestroyScene(DT_SceneHandle scene);
 
 	 void DT_AddObject(DT_SceneHandle scene, DT_ObjectHandle object);
 	 void DT_RemoveObject(DT_SceneHandle scene, DT_ObjectHandle object);
 
+/* Adds 'count' objects to a scene at once. Use this for loading a level: 
+   the broad phase sorts the bounding boxes of all objects in one go instead
+   of inserting them one at a time.
+*/
+
+	 void DT_AddObjects(DT_SceneHandle scene, DT_Count count, const DT_ObjectHandle *objects);
+
+/* Removes 'count' objects from a scene at once. Objects that are not in the 
+   scene are skipped. Removing an object ends its overlaps right away, but the 
+   broad phase frees the space of removed objects in one pass once they make up 
+   half of the scene, so removing many objects costs about as much as adding them.
+*/
+
+	 void DT_RemoveObjects(DT_SceneHandle scene, DT_Count count, const DT_ObjectHandle *objects);
+
 /* Note that objects can be assigned to multiple scenes! */
 
+/* Between DT_BeginUpdate and DT_EndUpdate, moving the objects of a scene only 
+   records their new bounding boxes. DT_EndUpdate re-sorts the broad phase once 
+   and updates the set of overlapping pairs in a single pass. This is a lot 
+   cheaper than moving the objects one by one when many objects move per frame.
+*/
+
+	 void DT_BeginUpdate(DT_SceneHandle scene);
+	 void DT_EndUpdate(DT_SceneHandle scene);
+
+/* Sets the matrices of 'count' objects. 'matrices' holds 'count' column-major 
+   4x4 matrices stored one after another. If the scene is not already being 
+   updated, the call is wrapped in DT_BeginUpdate/DT_EndUpdate.
+*/
+
+	 void DT_SetMatricesf(DT_SceneHandle scene, DT_Count count, 
+						  const DT_ObjectHandle *objects, const float *matrices);
+	 void DT_SetMatricesd(DT_SceneHandle scene, DT_Count count, 
+						  const DT_ObjectHandle *objects, const double *matrices);
+
+/* With simplex caching, a scene keeps for each pair of objects the simplex on 
+   which the last exact test ended, and the next exact test of the pair starts 
+   from it. For objects that rest on each other or move little, most tests then
+   end in the first iteration or without one. The vertices of the simplex follow
+   the objects, so they stay valid as long as the objects move rigidly: turn 
+   caching off for scenes in which objects change their scaling. Caching is off
+   by default. DT_GetSimplexCacheStats returns the number of tests that started 
+   from a cached simplex and that started cold while caching was on, and the 
+   number of GJK iterations they took. Only tests of two convex objects that 
+   need GJK use the cache, so tests of two spheres or of complex shapes are not
+   counted.
+*/
+
+	 void DT_SetSimplexCaching(DT_SceneHandle scene, DT_Bool enable);
+	 void DT_GetSimplexCacheStats(DT_SceneHandle scene, DT_Count *hits, 
+								  DT_Count *misses, DT_Count *iterations);
+
+/* With pair batching, the exact tests of pairs of spheres and boxes that have
+   a simple response are grouped by the types of the shapes, and run four 
+   pairs at a time in SIMD lanes. Pairs with other shapes or responses, and 
+   pairs of boxes with margins, are tested one by one as before. The results 
+   are the same as without batching, but DT_Test tests all pairs before it 
+   calls the first response, as DT_TestParallel does, so a response that 
+   returns DT_DONE no longer saves the remaining tests. Batching is off by 
+   default. The lanes need a library built with USE_SSE, and with AVX if 
+   it uses doubles; without them, DT_SetPairBatching does nothing.
+*/
+
+	 void DT_SetPairBatching(DT_SceneHandle scene, DT_Bool enable);
+
 /* Response */
 
 /* Response tables are defined independent of the scenes in which they are used.
@@ -231,6 +406,29 @@
  
 	 DT_Count DT_Test(DT_SceneHandle scene, DT_RespTableHandle respTable);
 
+/* Same as 'DT_Test', but the exact tests are spread over 'num_threads' threads,
+   including the calling thread. The callbacks are still called from the calling
+   thread, in the same order as 'DT_Test' calls them. The exact tests of all pairs
+   are done before the first callback is called, so returning DT_DONE only stops
+   the callbacks.
+*/
+
+	 DT_Count DT_TestParallel(DT_SceneHandle scene, DT_RespTableHandle respTable, 
+							  DT_Count num_threads);
+
+/* Same as 'DT_Test', but instead of calling the response callbacks the colliding pairs 
+   are written to 'buffer', in the order in which 'DT_Test' would call the callbacks. 
+   Only the response types of the pairs are taken from the response table. The previous 
+   contents of the buffer are overwritten. 'DT_TestCollect' returns the number of colliding 
+   pairs, which is larger than 'buffer->count' if a client-provided buffer was too small.
+*/
+
+	 DT_ContactBuffer *DT_CreateContactBuffer();
+	 void              DT_DestroyContactBuffer(DT_ContactBuffer *buffer);
+
+	 DT_Count DT_TestCollect(DT_SceneHandle scene, DT_RespTableHandle respTable, 
+							 DT_ContactBuffer *buffer);
+
 /* Set the maximum relative error in the closest points and penetration depth
    computation. The default for `max_error' is 1.0e-3. Larger errors result
    in better performance. Non-positive error tolerances are ignored.
@@ -245,6 +443,16 @@
     
 	 void DT_SetTolerance(DT_Scalar tol_error);
 
+/* Set the method that computes the penetration depth for DT_DEPTH_RESPONSE and 
+   'DT_GetPenDepth', for all objects except pairs of a sphere and a sphere, box or
+   line segment, which have closed forms. The default is DT_PENDEPTH_EPA. Responses 
+   of type DT_APPROX_DEPTH_RESPONSE use DT_PENDEPTH_MPR whatever the method. A pair
+   of objects with both types of depth responses gets the exact depth, which is 
+   passed to the approximate depth responses as well. 
+*/ 
+
+	 void DT_SetPenDepthMethod(DT_PenDepthMethod method);
+
 
 /* This function returns the client pointer to the first object in a scene hit by the ray 
    (actually a line segment) defined by the points 'from' en 'to'. The spot is the hit point 
@@ -264,6 +472,16 @@
 											 const DT_Vector3 source, const DT_Vector3 target,
 											 DT_Scalar max_param, DT_Scalar *param, DT_Vector3 normal);
 
+/* Calls 'callback' for each object in the scene whose bounding box overlaps the box 
+   from 'min' to 'max', and returns the number of objects. The scene is not changed 
+   and no responses are called, so several threads may query a scene at once, as 
+   long as no thread changes the scene meanwhile.
+*/
+
+	 DT_Count DT_QueryBox(DT_SceneHandle scene, 
+						  const DT_Vector3 min, const DT_Vector3 max,
+						  DT_QueryCallback callback, void *client_data);
+
 
 
 #endif
@@ -37,30 +37,184 @@ extern "C" {
 								void *object1,
 								void *object2);
 
+	typedef struct BP_Pair {
+		void *object1;
+		void *object2;
+	} BP_Pair;
+
+	typedef void (*BP_QueryCallback)(void *client_data,
+									 void *object);
+
 	typedef bool (*BP_RayCastCallback)(void *client_data,
 									   void *object,
 									   const DT_Vector3 source,
 									   const DT_Vector3 target,
 									   DT_Scalar *lambda);
 	
+	typedef enum BP_SceneType {
+		BP_SWEEP_AND_PRUNE,              /* Sorted lists of box endpoints per axis 
+											(default) 
+										 */
+		BP_DYNAMIC_TREE                  /* A balanced tree of enlarged boxes. Does 
+											not degrade when many boxes overlap on 
+											one axis or when boxes jump 
+										 */
+	} BP_SceneType;
+	
+	typedef enum BP_UpdateMode {
+		BP_UPDATE_AUTO,                  /* Picks one of the two below by estimating 
+											how far the endpoints move (default) 
+										 */
+		BP_UPDATE_RESORT,                /* Insertion sort of the endpoint lists. 
+											Cheap when the boxes move a little 
+										 */
+		BP_UPDATE_REBUILD                /* Radix sort of the endpoint lists and a 
+											sweep for the overlapping pairs. The cost 
+											does not depend on how far boxes move
+										 */
+	} BP_UpdateMode;
+	
+	typedef enum BP_ReportMode {
+		BP_REPORT_CALLBACKS,             /* Calls beginOverlap or endOverlap for each
+											change in overlap status (default) 
+										 */
+		BP_REPORT_DELTA                  /* Collects the changes, which are fetched 
+											with BP_GetPairDelta
+										 */
+	} BP_ReportMode;
+	
 	DECLSPEC BP_SceneHandle BP_CreateScene(void *client_data,
 												  BP_Callback beginOverlap,
 												  BP_Callback endOverlap);
+
+	DECLSPEC BP_SceneHandle BP_CreateSceneOfType(BP_SceneType type,
+												 void *client_data,
+												 BP_Callback beginOverlap,
+												 BP_Callback endOverlap);
 	
 	DECLSPEC void           BP_DestroyScene(BP_SceneHandle scene);
 	
+/* The filter of a proxy is a category and a mask. A pair of overlapping proxies
+   is reported only if the category of each proxy shares a bit with the mask of 
+   the other. The filter is tested before the boxes, so pairs that are filtered 
+   out cost next to nothing. BP_CreateProxy sets all bits of both. 
+*/
+
+#define BP_ALL_BITS 0xffffffffu
+
 	DECLSPEC BP_ProxyHandle BP_CreateProxy(BP_SceneHandle scene, 
 												  void *object,
 												  const DT_Vector3 min, 
 												  const DT_Vector3 max);
 	
+	DECLSPEC BP_ProxyHandle BP_CreateFilteredProxy(BP_SceneHandle scene, 
+												   void *object,
+												   const DT_Vector3 min, 
+												   const DT_Vector3 max,
+												   DT_Mask category,
+												   DT_Mask mask);
+	
+/* Creates a proxy for an object that rarely moves. A sweep-and-prune scene keeps
+   static proxies in a tree of their boxes instead of in the endpoint lists, and 
+   finds their overlaps with other proxies by querying the tree for the proxies 
+   that move. Moving a static proxy with BP_SetBBox is allowed but costs a query of
+   the whole scene. A dynamic-tree scene creates an ordinary proxy.
+*/
+
+	DECLSPEC BP_ProxyHandle BP_CreateStaticProxy(BP_SceneHandle scene, 
+												 void *object,
+												 const DT_Vector3 min, 
+												 const DT_Vector3 max,
+												 DT_Mask category,
+												 DT_Mask mask);
+	
+/* Creates 'count' proxies at once. 'objects', 'min' and 'max' hold the client objects
+   and boxes of the proxies, and 'categories' and 'masks' their filters, and the 
+   proxies are returned in 'proxies'. If 'categories' or 'masks' is NULL, all bits 
+   are set in both. The overlaps of the new proxies are reported as by 
+   BP_CreateProxy. For a sweep-and-prune scene, the endpoints of all proxies are 
+   sorted into the lists at once, which is much faster than creating the proxies 
+   one by one. 
+*/
+
+	DECLSPEC void           BP_CreateProxies(BP_SceneHandle scene,
+											 DT_Count count,
+											 void *const *objects,
+											 const DT_Vector3 *min,
+											 const DT_Vector3 *max,
+											 const DT_Mask *categories,
+											 const DT_Mask *masks,
+											 BP_ProxyHandle *proxies);
+	
 	DECLSPEC void           BP_DestroyProxy(BP_SceneHandle scene, 
 												  BP_ProxyHandle proxy);
+
+/* Destroys 'count' proxies at once. The overlaps of the proxies are ended as by 
+   BP_DestroyProxy. In a sweep-and-prune scene, a destroyed proxy leaves its 
+   endpoints in the lists until the destroyed proxies make up half of the lists, 
+   so that destroying many proxies takes time linear in the size of the lists. 
+*/
+
+	DECLSPEC void           BP_DestroyProxies(BP_SceneHandle scene,
+											  DT_Count count,
+											  const BP_ProxyHandle *proxies);
 	
 	DECLSPEC void BP_SetBBox(BP_ProxyHandle proxy, 
 									const DT_Vector3 min, 
 									const DT_Vector3 max);
+
+/* Changes the filter of a proxy. The overlaps with proxies that the new filter 
+   holds back are ended, and the ones that it lets through are begun. 
+*/
+
+	DECLSPEC void BP_SetProxyFilter(BP_SceneHandle scene,
+									BP_ProxyHandle proxy,
+									DT_Mask category,
+									DT_Mask mask);
+
+/* Between BP_BeginUpdate and BP_EndUpdate, BP_SetBBox only records the new
+   box of a proxy. BP_EndUpdate re-sorts each endpoint list once and reports 
+   the changes in overlap status through the scene's callbacks. 
+*/
+
+	DECLSPEC void BP_BeginUpdate(BP_SceneHandle scene);
+	DECLSPEC void BP_EndUpdate(BP_SceneHandle scene);
+	DECLSPEC DT_Bool BP_IsUpdating(BP_SceneHandle scene);
+
+/* Sets how BP_EndUpdate brings the endpoint lists of a sweep-and-prune scene up to
+   date. When many boxes jump, for instance after an explosion or a teleport, 
+   re-sorting takes time quadratic in the number of boxes, and rebuilding the lists 
+   is faster. The pairs are reported the same way in each mode. Other scenes 
+   ignore the mode. 
+*/
+
+	DECLSPEC void BP_SetUpdateMode(BP_SceneHandle scene, BP_UpdateMode mode);
+
+/* Sets how a scene reports the pairs of proxies that begin or end overlapping. In 
+   the delta mode, the scene collects the pairs, and BP_GetPairDelta returns the pairs
+   that began and the pairs that ended since it was last called, as two arrays. A pair 
+   that both began and ended in between is left out of both. The arrays stay valid 
+   until the next call of BP_GetPairDelta. The objects of a pair are in order of 
+   address. 
+*/
+
+	DECLSPEC void BP_SetReportMode(BP_SceneHandle scene, BP_ReportMode mode);
+	DECLSPEC void BP_GetPairDelta(BP_SceneHandle scene,
+								  const BP_Pair **begins, DT_Count *num_begins,
+								  const BP_Pair **ends, DT_Count *num_ends);
 	
+/* Calls 'callback' for each proxy whose box overlaps the box from 'min' to 'max', and
+   returns the number of proxies. The scene is not changed and no overlaps are 
+   reported, so several threads may query a scene at once, as long as no thread 
+   changes the scene meanwhile. 
+*/
+
+	DECLSPEC DT_Count BP_QueryBox(BP_SceneHandle scene,
+								  const DT_Vector3 min,
+								  const DT_Vector3 max,
+								  BP_QueryCallback callback,
+								  void *client_data);
+
 	DECLSPEC void *BP_RayCast(BP_SceneHandle scene, 
 									 BP_RayCastCallback objectRayCast, 
 									 void *client_data,
@@ -46,6 +46,7 @@ typedef unsigned int   DT_Count;
 typedef unsigned int   DT_Size;
 typedef float          DT_Scalar; 
 typedef int            DT_Bool;
+typedef unsigned int   DT_Mask;
 
 #define DT_FALSE 0
 #define DT_TRUE  1
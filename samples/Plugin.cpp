@@ -5,27 +5,26 @@
 
 #include "Plugin.h"
 
-DT_Bool collResp(void* client_data, void* obj1, void* obj2, const DT_CollData* coll_data)
+// Contacts are collected with DT_TestCollect, so the response is never called.
+static DT_Bool collResp(void* client_data, void* obj1, void* obj2, const DT_CollData* coll_data)
 {
-	const auto& myObj1 = *(PluginObject*)obj1;
-	const auto& myObj2 = *(PluginObject*)obj2;
-		
-	m_CollResult->id1 = myObj1.id;
-	m_CollResult->id2 = myObj2.id;
-
-	m_CollResult->point1[0] = coll_data->point1[0];
-	m_CollResult->point1[1] = coll_data->point1[1];
-	m_CollResult->point1[2] = coll_data->point1[2];
-
-	m_CollResult->point2[0] = coll_data->point2[0];
-	m_CollResult->point2[1] = coll_data->point2[1];
-	m_CollResult->point2[2] = coll_data->point2[2];
+	return DT_CONTINUE;
+}
 
-	m_CollResult->normal[0] = coll_data->normal[0];
-	m_CollResult->normal[1] = coll_data->normal[1];
-	m_CollResult->normal[2] = coll_data->normal[2];
+static void copyContact(const DT_Contact& contact, PluginCollisionData& result)
+{
+	const auto& myObj1 = *(PluginObject*)contact.client_object1;
+	const auto& myObj2 = *(PluginObject*)contact.client_object2;
+		
+	result.id1 = myObj1.id;
+	result.id2 = myObj2.id;
 
-	return DT_CONTINUE;
+	for (int i = 0; i < 3; ++i)
+	{
+		result.point1[i] = contact.coll_data.point1[i];
+		result.point2[i] = contact.coll_data.point2[i];
+		result.normal[i] = contact.coll_data.normal[i];
+	}
 }
 
 void InitCollisionDetection()
@@ -33,6 +32,8 @@ void InitCollisionDetection()
 	m_Objects = std::make_shared<std::vector<PluginObject>>();
 	m_Objects->reserve(100);
 	m_CollResult = std::make_shared<PluginCollisionData>();
+	m_CollResults = std::make_shared<std::vector<PluginCollisionData>>();
+	m_Contacts = DT_CreateContactBuffer();
 
 	m_Scene = std::make_shared<PluginScene>();
 	m_Scene->scene = DT_CreateScene();
@@ -45,7 +46,21 @@ void InitCollisionDetection()
 
 unsigned int AllObjectsCollisionCheck()
 {
-	return DT_Test(m_Scene->scene, m_Scene->respTable);
+	DT_Count count = DT_TestCollect(m_Scene->scene, m_Scene->respTable, m_Contacts);
+
+	m_CollResults->resize(m_Contacts->count);
+	for (DT_Index i = 0; i < m_Contacts->count; ++i)
+	{
+		copyContact(m_Contacts->contacts[i], (*m_CollResults)[i]);
+	}
+
+	// GetCollisionPtr returns the last contact, as the old callback left it.
+	if (!m_CollResults->empty())
+	{
+		*m_CollResult = m_CollResults->back();
+	}
+
+	return count;
 }
 
 void* GetCollisionPtr()
@@ -53,6 +68,11 @@ void* GetCollisionPtr()
 	return m_CollResult.get();
 }
 
+void* GetAllCollisionsPtr()
+{
+	return m_CollResults->data();
+}
+
 void Dispose()
 {
 	for (auto& obj : *m_Objects)
@@ -65,6 +85,7 @@ void Dispose()
 
 	DT_DestroyRespTable(m_Scene->respTable);
 	DT_DestroyScene(m_Scene->scene);
+	DT_DestroyContactBuffer(m_Contacts);
 }
 
 unsigned int ConstructComplexShape(const void* vertex, const unsigned int* indices, unsigned int vertexCount)
@@ -54,6 +54,8 @@ struct PluginScene
 static std::shared_ptr<PluginScene> m_Scene;
 static std::shared_ptr<std::vector<PluginObject>> m_Objects;
 static std::shared_ptr<PluginCollisionData> m_CollResult;
+static std::shared_ptr<std::vector<PluginCollisionData>> m_CollResults;
+static DT_ContactBuffer* m_Contacts;
 
 extern "C"
 {
@@ -62,6 +64,7 @@ extern "C"
 	DLLExport void Dispose();
 	DLLExport unsigned int AllObjectsCollisionCheck();
 	DLLExport void* GetCollisionPtr();
+	DLLExport void* GetAllCollisionsPtr();
 
 	DLLExport unsigned int ConstructComplexShape(const void* vertex, const unsigned int* indices, unsigned int vertexCount);
 	DLLExport unsigned int ConstructRigidBody(unsigned int shapeType, const float* pos, const float radius, const float height);
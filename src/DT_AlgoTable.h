@@ -26,7 +26,7 @@
 
 #include "DT_Shape.h"
 
-template <typename Function, int NUM_TYPES = 8>
+template <typename Function, int NUM_TYPES = NUM_SHAPE_TYPES>
 class AlgoTable {
 public:
   void addEntry(DT_ShapeType type1, DT_ShapeType type2, Function function) 
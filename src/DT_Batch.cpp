@@ -0,0 +1,689 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "DT_Batch.h"
+#include "DT_Encounter.h"
+#include "DT_Sphere.h"
+#include "DT_Box.h"
+#include "DT_Accuracy.h"
+
+// The lanes of a batch hold a scalar per encounter. They use SSE for floats 
+// and AVX for doubles, see DT_SIMD_LANES, and plain arrays otherwise. The operations are those of the scalar tests, so each 
+// lane rounds as the scalar test would. A mask holds a comparison per lane.
+
+#if defined(DT_SIMD_LANES) && !defined(USE_DOUBLES)
+
+#include <xmmintrin.h>
+
+class Lanes {
+public:
+	Lanes() {}
+	Lanes(__m128 v) : m_v(v) {}
+	explicit Lanes(const MT_Scalar& s) : m_v(_mm_set1_ps(s)) {}
+	explicit Lanes(const MT_Scalar *s) : m_v(_mm_loadu_ps(s)) {}
+
+	void store(MT_Scalar *s) const { _mm_storeu_ps(s, m_v); }
+
+	__m128 m_v;
+};
+
+struct Mask {
+	Mask(__m128 v) : m_v(v) {}
+
+	__m128 m_v;
+};
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) { return _mm_add_ps(a.m_v, b.m_v); }
+inline Lanes operator-(const Lanes& a, const Lanes& b) { return _mm_sub_ps(a.m_v, b.m_v); }
+inline Lanes operator*(const Lanes& a, const Lanes& b) { return _mm_mul_ps(a.m_v, b.m_v); }
+inline Lanes operator/(const Lanes& a, const Lanes& b) { return _mm_div_ps(a.m_v, b.m_v); }
+inline Lanes operator-(const Lanes& a) { return _mm_xor_ps(a.m_v, _mm_set1_ps(-0.0f)); }
+inline Lanes abs(const Lanes& a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.m_v); }
+inline Lanes sqrt(const Lanes& a) { return _mm_sqrt_ps(a.m_v); }
+
+inline Mask operator<(const Lanes& a, const Lanes& b) { return _mm_cmplt_ps(a.m_v, b.m_v); }
+inline Mask operator>(const Lanes& a, const Lanes& b) { return _mm_cmpgt_ps(a.m_v, b.m_v); }
+inline Mask operator<=(const Lanes& a, const Lanes& b) { return _mm_cmple_ps(a.m_v, b.m_v); }
+inline Mask operator&(const Mask& a, const Mask& b) { return _mm_and_ps(a.m_v, b.m_v); }
+inline int bits(const Mask& m) { return _mm_movemask_ps(m.m_v); }
+
+inline Lanes select(const Mask& m, const Lanes& a, const Lanes& b)
+{
+	return _mm_or_ps(_mm_and_ps(m.m_v, a.m_v), _mm_andnot_ps(m.m_v, b.m_v));
+}
+
+#elif defined(DT_SIMD_LANES)
+
+#include <immintrin.h>
+
+class Lanes {
+public:
+	Lanes() {}
+	Lanes(__m256d v) : m_v(v) {}
+	explicit Lanes(const MT_Scalar& s) : m_v(_mm256_set1_pd(s)) {}
+	explicit Lanes(const MT_Scalar *s) : m_v(_mm256_loadu_pd(s)) {}
+
+	void store(MT_Scalar *s) const { _mm256_storeu_pd(s, m_v); }
+
+	__m256d m_v;
+};
+
+struct Mask {
+	Mask(__m256d v) : m_v(v) {}
+
+	__m256d m_v;
+};
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) { return _mm256_add_pd(a.m_v, b.m_v); }
+inline Lanes operator-(const Lanes& a, const Lanes& b) { return _mm256_sub_pd(a.m_v, b.m_v); }
+inline Lanes operator*(const Lanes& a, const Lanes& b) { return _mm256_mul_pd(a.m_v, b.m_v); }
+inline Lanes operator/(const Lanes& a, const Lanes& b) { return _mm256_div_pd(a.m_v, b.m_v); }
+inline Lanes operator-(const Lanes& a) { return _mm256_xor_pd(a.m_v, _mm256_set1_pd(-0.0)); }
+inline Lanes abs(const Lanes& a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a.m_v); }
+inline Lanes sqrt(const Lanes& a) { return _mm256_sqrt_pd(a.m_v); }
+
+inline Mask operator<(const Lanes& a, const Lanes& b) { return _mm256_cmp_pd(a.m_v, b.m_v, _CMP_LT_OQ); }
+inline Mask operator>(const Lanes& a, const Lanes& b) { return _mm256_cmp_pd(a.m_v, b.m_v, _CMP_GT_OQ); }
+inline Mask operator<=(const Lanes& a, const Lanes& b) { return _mm256_cmp_pd(a.m_v, b.m_v, _CMP_LE_OQ); }
+inline Mask operator&(const Mask& a, const Mask& b) { return _mm256_and_pd(a.m_v, b.m_v); }
+inline int bits(const Mask& m) { return _mm256_movemask_pd(m.m_v); }
+
+inline Lanes select(const Mask& m, const Lanes& a, const Lanes& b)
+{
+	return _mm256_blendv_pd(b.m_v, a.m_v, m.m_v);
+}
+
+#else
+
+class Lanes {
+public:
+	Lanes() {}
+
+	explicit Lanes(const MT_Scalar& s) 
+	{
+		int l;
+		for (l = 0; l != DT_Batch::LANES; ++l)
+		{
+			m_s[l] = s;
+		}
+	}
+
+	explicit Lanes(const MT_Scalar *s) 
+	{
+		int l;
+		for (l = 0; l != DT_Batch::LANES; ++l)
+		{
+			m_s[l] = s[l];
+		}
+	}
+
+	void store(MT_Scalar *s) const 
+	{
+		int l;
+		for (l = 0; l != DT_Batch::LANES; ++l)
+		{
+			s[l] = m_s[l];
+		}
+	}
+
+	MT_Scalar m_s[DT_Batch::LANES];
+};
+
+struct Mask {
+	Mask(int bits = 0) : m_bits(bits) {}
+
+	int m_bits;
+};
+
+#define LANEWISE(expr)							\
+	Lanes r;									\
+	int l;										\
+	for (l = 0; l != DT_Batch::LANES; ++l)		\
+	{											\
+		r.m_s[l] = (expr);						\
+	}											\
+	return r;
+
+#define LANEWISE_TEST(expr)						\
+	Mask m;										\
+	int l;										\
+	for (l = 0; l != DT_Batch::LANES; ++l)		\
+	{											\
+		if (expr)								\
+		{										\
+			m.m_bits |= 1 << l;					\
+		}										\
+	}											\
+	return m;
+
+inline Lanes operator+(const Lanes& a, const Lanes& b) { LANEWISE(a.m_s[l] + b.m_s[l]) }
+inline Lanes operator-(const Lanes& a, const Lanes& b) { LANEWISE(a.m_s[l] - b.m_s[l]) }
+inline Lanes operator*(const Lanes& a, const Lanes& b) { LANEWISE(a.m_s[l] * b.m_s[l]) }
+inline Lanes operator/(const Lanes& a, const Lanes& b) { LANEWISE(a.m_s[l] / b.m_s[l]) }
+inline Lanes operator-(const Lanes& a) { LANEWISE(-a.m_s[l]) }
+inline Lanes abs(const Lanes& a) { LANEWISE(MT_abs(a.m_s[l])) }
+inline Lanes sqrt(const Lanes& a) { LANEWISE(MT_sqrt(a.m_s[l])) }
+
+inline Mask operator<(const Lanes& a, const Lanes& b) { LANEWISE_TEST(a.m_s[l] < b.m_s[l]) }
+inline Mask operator>(const Lanes& a, const Lanes& b) { LANEWISE_TEST(a.m_s[l] > b.m_s[l]) }
+inline Mask operator<=(const Lanes& a, const Lanes& b) { LANEWISE_TEST(a.m_s[l] <= b.m_s[l]) }
+inline Mask operator&(const Mask& a, const Mask& b) { return Mask(a.m_bits & b.m_bits); }
+inline int bits(const Mask& m) { return m.m_bits; }
+
+inline Lanes select(const Mask& m, const Lanes& a, const Lanes& b) 
+{ 
+	LANEWISE((m.m_bits >> l) & 1 ? a.m_s[l] : b.m_s[l]) 
+}
+
+#undef LANEWISE
+#undef LANEWISE_TEST
+
+#endif
+
+// The dot product of two vectors with their coordinates in lanes, in the 
+// order of MT_Vector3::dot.
+inline Lanes dot(const Lanes *a, const Lanes *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// A vector per lane, kept for the encounters of the lanes.
+struct LaneVector {
+	LaneVector() {}
+
+	LaneVector(const Lanes *v)
+	{
+		v[0].store(m_co[0]);
+		v[1].store(m_co[1]);
+		v[2].store(m_co[2]);
+	}
+
+	MT_Vector3 getValue(int l) const 
+	{
+		return MT_Vector3(m_co[0][l], m_co[1][l], m_co[2][l]);
+	}
+
+	MT_Scalar m_co[3][DT_Batch::LANES];
+};
+
+// The objects on one side of a batch: their transforms and margins per lane.
+// The world shapes of DT_Primitive.h are computed from these in the lanes, 
+// as their setValue does. A lane has a closed form if its bit is set in the
+// returned mask.
+class LaneObjects {
+public:
+	void setValue(int l, const MT_Transform& xform, MT_Scalar margin)
+	{
+		const MT_Matrix3x3& basis = xform.getBasis();
+		int i, j;
+		for (i = 0; i != 3; ++i)
+		{
+			for (j = 0; j != 3; ++j)
+			{
+				m_basis[i][j][l] = basis[i][j];
+			}
+			m_origin[i][l] = xform.getOrigin()[i];
+		}
+		m_margin[l] = margin;
+	}
+
+	void getOrigin(Lanes *origin) const 
+	{
+		origin[0] = Lanes(m_origin[0]);
+		origin[1] = Lanes(m_origin[1]);
+		origin[2] = Lanes(m_origin[2]);
+	}
+
+	Lanes getMargin() const { return Lanes(m_margin); }
+
+	// As DT_WorldSphere::setValue for spheres of the given radii. Sets the 
+	// margins of the world spheres.
+	int sphere(const MT_Scalar *radius, Lanes& margin) const
+	{
+		Lanes scale[3];
+		int closed = orthogonal(scale);
+		Lanes tolerance = Lanes(MT_sqrt(DT_Accuracy::rel_error2)) * scale[0];
+		closed &= bits(abs(scale[0] - scale[1]) <= tolerance) & bits(abs(scale[0] - scale[2]) <= tolerance);
+		margin = Lanes(radius) * scale[0] + getMargin();
+		return closed;
+	}
+
+	// As DT_WorldBox::setValue for boxes of the given extents. Sets the 
+	// axes and extents of the world boxes.
+	int box(const MT_Scalar extent[3][DT_Batch::LANES], Lanes axis[3][3], Lanes *ext) const
+	{
+		Lanes scale[3];
+		int closed = orthogonal(scale);
+		int i, j;
+		for (i = 0; i != 3; ++i)
+		{
+			for (j = 0; j != 3; ++j)
+			{
+				axis[i][j] = Lanes(m_basis[j][i]) / scale[i];
+			}
+			ext[i] = Lanes(extent[i]) * scale[i];
+		}
+		return closed;
+	}
+
+private:
+	// As 'orthogonal' in DT_Primitive.cpp, on the entries of the transpose 
+	// of the basis times the basis that it tests.
+	int orthogonal(Lanes *scale) const
+	{
+		Lanes b[3][3], m[3][3];
+		int i, j;
+		for (i = 0; i != 3; ++i)
+		{
+			for (j = 0; j != 3; ++j)
+			{
+				b[i][j] = Lanes(m_basis[i][j]);
+			}
+		}
+		for (i = 0; i != 3; ++i)
+		{
+			for (j = i; j != 3; ++j)
+			{
+				m[i][j] = b[0][j] * b[0][i] + b[1][j] * b[1][i] + b[2][j] * b[2][i];
+			}
+		}
+
+		Lanes rel_error2(DT_Accuracy::rel_error2);
+		int skewed = bits(m[0][1] * m[0][1] > rel_error2 * m[0][0] * m[1][1]) | 
+			bits(m[0][2] * m[0][2] > rel_error2 * m[0][0] * m[2][2]) |
+			bits(m[1][2] * m[1][2] > rel_error2 * m[1][1] * m[2][2]);
+		for (i = 0; i != 3; ++i)
+		{
+			scale[i] = sqrt(m[i][i]);
+		}
+		return ~skewed & ((1 << DT_Batch::LANES) - 1);
+	}
+
+	MT_Scalar  m_basis[3][3][DT_Batch::LANES];
+	MT_Scalar  m_origin[3][DT_Batch::LANES];
+	MT_Scalar  m_margin[DT_Batch::LANES];
+};
+
+static const MT_Vector3 zero(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+
+// Leaves the result of a lane in its encounter as DT_Encounter::collide does.
+static DT_ResponseType retire(const DT_Encounter& e, bool cache_simplex, bool intersect, 
+							  const MT_Vector3& v)
+{
+	e.setSeparatingAxis(v, cache_simplex);
+	return intersect ? DT_SIMPLE_RESPONSE : DT_NO_RESPONSE;
+}
+
+bool DT_Batch::add(const DT_Encounter& e, DT_ResponseType type, DT_Index index)
+{
+	if (type != DT_SIMPLE_RESPONSE)
+	{
+		return false;
+	}
+
+	// The encounter puts the lower shape type first.
+	T_Kind kind;
+	DT_ShapeType type1 = e.first()->getType(), type2 = e.second()->getType();
+	if (type1 == SPHERE && type2 == SPHERE)
+	{
+		kind = SPHERE_SPHERE;
+	}
+	else if (type1 == SPHERE && type2 == BOX)
+	{
+		kind = SPHERE_BOX;
+	}
+	else if (type1 == BOX && type2 == BOX && 
+			 e.first()->m_margin == MT_Scalar(0.0) && e.second()->m_margin == MT_Scalar(0.0))
+	{
+		kind = BOX_BOX;
+	}
+	else
+	{
+		return false;
+	}
+
+	T_Item item = { &e, index, DT_NO_RESPONSE };
+	m_queue[kind].push_back(item);
+	return true;
+}
+
+void DT_Batch::close()
+{
+	m_items.clear();
+	m_batches.clear();
+	int kind;
+	for (kind = 0; kind != NUM_KINDS; ++kind)
+	{
+		DT_Index begin = DT_Index(m_items.size());
+		m_items.insert(m_items.end(), m_queue[kind].begin(), m_queue[kind].end());
+		DT_Index end = DT_Index(m_items.size());
+		while (begin != end)
+		{
+			T_Batch batch = { T_Kind(kind), begin, end - begin < DT_Index(LANES) ? end : begin + LANES };
+			m_batches.push_back(batch);
+			begin = batch.m_end;
+		}
+		m_queue[kind].clear();
+	}
+}
+
+void DT_Batch::run(DT_Index batch, bool cache_simplex)
+{
+	const T_Batch& b = m_batches[batch];
+	T_Item *items = &m_items[b.m_begin];
+	int count = int(b.m_end - b.m_begin);
+	switch (b.m_kind)
+	{
+	case SPHERE_SPHERE:
+		runSphereSphere(items, count, cache_simplex);
+		break;
+	case SPHERE_BOX:
+		runSphereBox(items, count, cache_simplex);
+		break;
+	case BOX_BOX:
+		runBoxBox(items, count, cache_simplex);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+// In the kernels below, lanes past 'count' repeat the last encounter. Their 
+// results are not used. Lanes without a closed form compute garbage, which 
+// is not used either.
+
+void DT_Batch::runSphereSphere(T_Item *items, int count, bool cache_simplex)
+{
+	LaneObjects a, b;
+	MT_Scalar radius_a[LANES], radius_b[LANES];
+	int l;
+	for (l = 0; l != LANES; ++l)
+	{
+		const DT_Encounter& e = *items[l < count ? l : count - 1].m_encounter;
+		const DT_Object& oa = *e.first();
+		const DT_Object& ob = *e.second();
+		a.setValue(l, oa.m_xform, oa.m_margin);
+		b.setValue(l, ob.m_xform, ob.m_margin);
+		radius_a[l] = ((const DT_Sphere&)oa.m_shape).getRadius();
+		radius_b[l] = ((const DT_Sphere&)ob.m_shape).getRadius();
+	}
+
+	Lanes ma, mb;
+	int closed = a.sphere(radius_a, ma) & b.sphere(radius_b, mb);
+
+	// As DT_WorldSphere::nearest and sphereIntersect
+	Lanes pa[3], pb[3], n[3];
+	a.getOrigin(pa);
+	b.getOrigin(pb);
+	int i;
+	for (i = 0; i != 3; ++i)
+	{
+		n[i] = pa[i] - pb[i];
+	}
+	Lanes dist = sqrt(dot(n, n));
+	Lanes gap = dist - ma - mb;
+	int separated = bits(gap > Lanes(MT_Scalar(0.0)));
+
+	Lanes inv = Lanes(MT_Scalar(1.0)) / dist;
+	for (i = 0; i != 3; ++i)
+	{
+		n[i] = (n[i] * inv) * gap;
+	}
+	LaneVector v(n);
+
+	for (l = 0; l != count; ++l)
+	{
+		T_Item& item = items[l];
+		if ((closed >> l) & 1)
+		{
+			item.m_type = (separated >> l) & 1 ? 
+				retire(*item.m_encounter, cache_simplex, false, v.getValue(l)) :
+				retire(*item.m_encounter, cache_simplex, true, zero);
+		}
+		else
+		{
+			DT_CollData coll_data;
+			item.m_type = item.m_encounter->collide(DT_SIMPLE_RESPONSE, coll_data, cache_simplex);
+		}
+	}
+}
+
+void DT_Batch::runSphereBox(T_Item *items, int count, bool cache_simplex)
+{
+	LaneObjects a, b;
+	MT_Scalar radius_a[LANES], extent_b[3][LANES];
+	int l, i;
+	for (l = 0; l != LANES; ++l)
+	{
+		const DT_Encounter& e = *items[l < count ? l : count - 1].m_encounter;
+		const DT_Object& oa = *e.first();
+		const DT_Object& ob = *e.second();
+		a.setValue(l, oa.m_xform, oa.m_margin);
+		b.setValue(l, ob.m_xform, ob.m_margin);
+		radius_a[l] = ((const DT_Sphere&)oa.m_shape).getRadius();
+		for (i = 0; i != 3; ++i)
+		{
+			extent_b[i][l] = ((const DT_Box&)ob.m_shape).getExtent()[i];
+		}
+	}
+
+	Lanes ma, axis[3][3], ext[3];
+	int closed = a.sphere(radius_a, ma) & b.box(extent_b, axis, ext);
+
+	// As DT_WorldBox::nearest. A center inside the box always intersects, 
+	// so the lanes need not find the nearest face.
+	Lanes p[3], c[3], d[3], local[3];
+	a.getOrigin(p);
+	b.getOrigin(c);
+	for (i = 0; i != 3; ++i)
+	{
+		d[i] = p[i] - c[i];
+	}
+	int outside = 0;
+	for (i = 0; i != 3; ++i)
+	{
+		local[i] = dot(axis[i], d);
+		Mask below = local[i] < -ext[i];
+		Mask above = local[i] > ext[i];
+		outside |= bits(below) | bits(above);
+		local[i] = select(below, -ext[i], select(above, ext[i], local[i]));
+	}
+
+	Lanes n[3];
+	for (i = 0; i != 3; ++i)
+	{
+		n[i] = p[i] - (c[i] + axis[0][i] * local[0] + axis[1][i] * local[1] + axis[2][i] * local[2]);
+	}
+	Lanes dist = sqrt(dot(n, n));
+	Lanes gap = dist - ma - b.getMargin();
+	int separated = outside & bits((dist > Lanes(MT_Scalar(0.0))) & (gap > Lanes(MT_Scalar(0.0))));
+
+	Lanes inv = Lanes(MT_Scalar(1.0)) / dist;
+	for (i = 0; i != 3; ++i)
+	{
+		n[i] = (n[i] * inv) * gap;
+	}
+	LaneVector v(n);
+
+	for (l = 0; l != count; ++l)
+	{
+		T_Item& item = items[l];
+		if ((closed >> l) & 1)
+		{
+			item.m_type = (separated >> l) & 1 ? 
+				retire(*item.m_encounter, cache_simplex, false, v.getValue(l)) :
+				retire(*item.m_encounter, cache_simplex, true, zero);
+		}
+		else
+		{
+			DT_CollData coll_data;
+			item.m_type = item.m_encounter->collide(DT_SIMPLE_RESPONSE, coll_data, cache_simplex);
+		}
+	}
+}
+
+// The lanes of the separating axis test of 'separated' in DT_Primitive.cpp. 
+// A lane retires on the first axis that separates its boxes, and keeps the 
+// axis and the factor of the separating vector along it.
+class AxisLanes {
+public:
+	AxisLanes(int active) : m_active(active) {}
+
+	int active() const { return m_active; }
+
+	void retire(const Mask& separated, const Lanes& factor, int axis)
+	{
+		int retired = bits(separated) & m_active;
+		if (retired)
+		{
+			MT_Scalar f[DT_Batch::LANES];
+			factor.store(f);
+			int l;
+			for (l = 0; l != DT_Batch::LANES; ++l)
+			{
+				if ((retired >> l) & 1)
+				{
+					m_axis[l] = axis;
+					m_factor[l] = f[l];
+				}
+			}
+			m_active &= ~retired;
+		}
+	}
+
+	// The separating vector of a retired lane, from the axes of the boxes
+	MT_Vector3 getValue(int l, const LaneVector *a, const LaneVector *b) const
+	{
+		int k = m_axis[l];
+		return k < 3 ? a[k].getValue(l) * m_factor[l] :
+			k < 6 ? b[k - 3].getValue(l) * m_factor[l] :
+			a[(k - 6) / 3].getValue(l).cross(b[(k - 6) % 3].getValue(l)) * m_factor[l];
+	}
+
+private:
+	int        m_active;
+	int        m_axis[DT_Batch::LANES];
+	MT_Scalar  m_factor[DT_Batch::LANES];
+};
+
+void DT_Batch::runBoxBox(T_Item *items, int count, bool cache_simplex)
+{
+	LaneObjects oa, ob;
+	MT_Scalar extent_a[3][LANES], extent_b[3][LANES];
+	int l, i, j;
+	for (l = 0; l != LANES; ++l)
+	{
+		const DT_Encounter& e = *items[l < count ? l : count - 1].m_encounter;
+		const DT_Object& a = *e.first();
+		const DT_Object& b = *e.second();
+		oa.setValue(l, a.m_xform, a.m_margin);
+		ob.setValue(l, b.m_xform, b.m_margin);
+		for (i = 0; i != 3; ++i)
+		{
+			extent_a[i][l] = ((const DT_Box&)a.m_shape).getExtent()[i];
+			extent_b[i][l] = ((const DT_Box&)b.m_shape).getExtent()[i];
+		}
+	}
+
+	Lanes a[3][3], b[3][3], ea[3], eb[3];
+	int closed = oa.box(extent_a, a, ea) & ob.box(extent_b, b, eb);
+
+	Lanes ca[3], cb[3], d[3];
+	oa.getOrigin(ca);
+	ob.getOrigin(cb);
+	for (i = 0; i != 3; ++i)
+	{
+		d[i] = cb[i] - ca[i];
+	}
+
+	Lanes r[3][3], abs_r[3][3], da[3], db[3];
+	for (i = 0; i != 3; ++i)
+	{
+		for (j = 0; j != 3; ++j)
+		{
+			r[i][j] = dot(a[i], b[j]);
+			abs_r[i][j] = abs(r[i][j]) + Lanes(MT_EPSILON);
+		}
+		da[i] = dot(a[i], d);
+		db[i] = dot(b[i], d);
+	}
+
+	const Lanes zero_lanes(MT_Scalar(0.0));
+	AxisLanes lanes(closed);
+
+	// The face normals of a and of b are axes 0 to 5.
+	for (i = 0; i != 3 && lanes.active(); ++i)
+	{
+		Lanes gap = abs(da[i]) - ea[i] - 
+			(eb[0] * abs_r[i][0] + eb[1] * abs_r[i][1] + eb[2] * abs_r[i][2]);
+		lanes.retire(gap > zero_lanes, select(da[i] < zero_lanes, gap, -gap), i);
+	}
+
+	for (j = 0; j != 3 && lanes.active(); ++j)
+	{
+		Lanes gap = abs(db[j]) - eb[j] - 
+			(ea[0] * abs_r[0][j] + ea[1] * abs_r[1][j] + ea[2] * abs_r[2][j]);
+		lanes.retire(gap > zero_lanes, select(db[j] < zero_lanes, gap, -gap), 3 + j);
+	}
+
+	// The cross products of the edges are axes 6 to 14.
+	for (i = 0; i != 3 && lanes.active(); ++i)
+	{
+		int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+		for (j = 0; j != 3 && lanes.active(); ++j)
+		{
+			int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			Lanes length2 = Lanes(MT_Scalar(1.0)) - r[i][j] * r[i][j];
+			Lanes dist = da[i2] * r[i1][j] - da[i1] * r[i2][j];
+			Lanes gap = abs(dist) - 
+				(ea[i1] * abs_r[i2][j] + ea[i2] * abs_r[i1][j]) - 
+				(eb[j1] * abs_r[i][j2] + eb[j2] * abs_r[i][j1]);
+			lanes.retire((length2 > Lanes(MT_EPSILON)) & (gap > zero_lanes), 
+						 select(dist < zero_lanes, gap, -gap) / length2, 6 + 3 * i + j);
+		}
+	}
+
+	LaneVector axis_a[3] = { a[0], a[1], a[2] };
+	LaneVector axis_b[3] = { b[0], b[1], b[2] };
+
+	// As intersectBoxBox, boxes without margins that no axis separates 
+	// intersect.
+	for (l = 0; l != count; ++l)
+	{
+		T_Item& item = items[l];
+		bool boxes = (closed >> l) & 1;
+		if (boxes && !((lanes.active() >> l) & 1))
+		{
+			item.m_type = retire(*item.m_encounter, cache_simplex, false, lanes.getValue(l, axis_a, axis_b));
+		}
+		else if (boxes)
+		{
+			item.m_type = retire(*item.m_encounter, cache_simplex, true, zero);
+		}
+		else
+		{
+			DT_CollData coll_data;
+			item.m_type = item.m_encounter->collide(DT_SIMPLE_RESPONSE, coll_data, cache_simplex);
+		}
+	}
+}
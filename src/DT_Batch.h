@@ -0,0 +1,102 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_BATCH_H
+#define DT_BATCH_H
+
+#include <vector>
+
+#include "SOLID.h"
+
+class DT_Encounter;
+
+// The lanes are SIMD registers, under the same switches as the MT tuples: SSE 
+// for floats and AVX for doubles. Without them a batch runs its lanes one by 
+// one, which is no faster than testing the pairs, so scenes do not batch.
+#if defined(USE_SSE) && !defined(USE_TRACER) && (!defined(USE_DOUBLES) || defined(__AVX__))
+#define DT_SIMD_LANES
+#endif
+
+// Tests the encounters that have a simple response in batches of one pair of 
+// primitive types: two spheres, a sphere and a box, or two boxes. A batch 
+// tests up to LANES encounters side by side in the lanes of SIMD registers, 
+// on the closed forms of DT_Primitive.h. For two boxes, a lane retires as 
+// soon as one of the 15 axes separates its boxes, and the batch ends when 
+// all lanes have retired or the axes run out. The lanes compute the same 
+// values as the scalar tests, so the results and the separating axes left in 
+// the encounters are the same with and without batching. Encounters whose 
+// transforms rule out the closed form are passed on to DT_Encounter::collide.
+// Pairs of boxes with margins need GJK when no axis separates them, so they 
+// are not batched.
+
+class DT_Batch {
+public:
+	enum { LANES = 4 };
+
+	// Queues 'e' and returns true if it has a batched test. 'type' is the 
+	// type of the response of 'e', and 'index' its position in the encounter
+	// table.
+	bool add(const DT_Encounter& e, DT_ResponseType type, DT_Index index);
+
+	// Splits the queued encounters into batches. The batches can then be run 
+	// concurrently.
+	void close();
+
+	DT_Count numBatches() const { return DT_Count(m_batches.size()); }
+	void run(DT_Index batch, bool cache_simplex);
+
+	// The encounters of all batches and the types of their responses.
+	DT_Count size() const { return DT_Count(m_items.size()); }
+	DT_Index getIndex(DT_Index i) const { return m_items[i].m_index; }
+	DT_ResponseType getType(DT_Index i) const { return m_items[i].m_type; }
+
+private:
+	enum T_Kind { 
+		SPHERE_SPHERE, 
+		SPHERE_BOX, 
+		BOX_BOX, 
+		NUM_KINDS 
+	};
+
+	struct T_Item {
+		const DT_Encounter *m_encounter;
+		DT_Index            m_index;
+		DT_ResponseType     m_type;
+	};
+
+	struct T_Batch {
+		T_Kind    m_kind;
+		DT_Index  m_begin;
+		DT_Index  m_end;
+	};
+
+	static void runSphereSphere(T_Item *items, int count, bool cache_simplex);
+	static void runSphereBox(T_Item *items, int count, bool cache_simplex);
+	static void runBoxBox(T_Item *items, int count, bool cache_simplex);
+
+	std::vector<T_Item>   m_queue[NUM_KINDS];
+	std::vector<T_Item>   m_items;
+	std::vector<T_Batch>  m_batches;
+};
+
+#endif
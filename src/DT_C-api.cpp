@@ -59,6 +59,7 @@ static T_PolyList polyList;
 static DT_Complex       *currentComplex    = 0;
 static DT_Polyhedron    *currentPolyhedron = 0;
 static DT_VertexBase    *currentBase = 0;
+static DT_BVHQuality     bvhQuality = DT_BVH_FAST;
 
 
 
@@ -126,8 +127,8 @@ DT_ShapeHandle DT_NewMinkowski(DT_ShapeHandle shape1, DT_ShapeHandle shape2)
 {
     assert(shape1);
     assert(shape2);
-    if ((reinterpret_cast<DT_Shape *>(shape1)->getType() & CONVEX) != CONVEX ||
-        (reinterpret_cast<DT_Shape *>(shape2)->getType() & CONVEX) != CONVEX) 
+    if (reinterpret_cast<DT_Shape *>(shape1)->getType() == COMPLEX ||
+        reinterpret_cast<DT_Shape *>(shape2)->getType() == COMPLEX) 
     {
         return 0;
     }
@@ -139,8 +140,8 @@ DT_ShapeHandle DT_NewHull(DT_ShapeHandle shape1, DT_ShapeHandle shape2)
 {
     assert(shape1);
     assert(shape2);
-    if ((reinterpret_cast<DT_Shape *>(shape1)->getType() & CONVEX) != CONVEX ||
-        (reinterpret_cast<DT_Shape *>(shape2)->getType() & CONVEX) != CONVEX) 
+    if (reinterpret_cast<DT_Shape *>(shape1)->getType() == COMPLEX ||
+        reinterpret_cast<DT_Shape *>(shape2)->getType() == COMPLEX) 
     {
         return 0;
     }
@@ -152,7 +153,7 @@ DT_ShapeHandle DT_NewComplexShape(const DT_VertexBaseHandle vertexBase)
 {
     if (!currentComplex) 
 	{
-		currentBase = vertexBase ? reinterpret_cast<DT_VertexBase *>(vertexBase) : new DT_VertexBase;
+		currentBase = vertexBase ? reinterpret_cast<DT_VertexBase *>(vertexBase) : new DT_VertexBase(0, sizeof(T_Vertex));
 		currentComplex = new DT_Complex(currentBase);
 	}
     return (DT_ShapeHandle)currentComplex;
@@ -172,18 +173,24 @@ void DT_EndComplexShape()
 		
 		vertexBuf.clear();
         
-        currentComplex->finish(polyList.size(), &polyList[0]);
+        currentComplex->finish(polyList.size(), &polyList[0], 
+							   bvhQuality == DT_BVH_SAH ? DT_BBoxNode::SAH : DT_BBoxNode::MIDPOINT);
         polyList.clear();
         currentComplex = 0;
         currentBase = 0; 
     }
 }
 
+void DT_SetBVHBuildQuality(DT_BVHQuality quality)
+{
+	bvhQuality = quality;
+}
+
 DT_ShapeHandle DT_NewPolytope(const DT_VertexBaseHandle vertexBase) 
 {
     if (!currentPolyhedron) 
 	{
-		currentBase = vertexBase ? reinterpret_cast<DT_VertexBase *>(vertexBase) : new DT_VertexBase;
+		currentBase = vertexBase ? reinterpret_cast<DT_VertexBase *>(vertexBase) : new DT_VertexBase(0, sizeof(T_Vertex));
         currentPolyhedron = new DT_Polyhedron;
 		
     }
@@ -296,6 +303,11 @@ DT_SceneHandle DT_CreateScene()
     return (DT_SceneHandle)new DT_Scene; 
 }
 
+DT_SceneHandle DT_CreateSceneOfType(DT_BroadPhase type) 
+{
+    return (DT_SceneHandle)new DT_Scene(type); 
+}
+
 void DT_DestroyScene(DT_SceneHandle scene) 
 {
     delete reinterpret_cast<DT_Scene *>(scene);
@@ -308,6 +320,13 @@ void DT_AddObject(DT_SceneHandle scene, DT_ObjectHandle object)
     reinterpret_cast<DT_Scene *>(scene)->addObject(*reinterpret_cast<DT_Object *>(object));
 }
 
+void DT_AddObjects(DT_SceneHandle scene, DT_Count count, const DT_ObjectHandle *objects) 
+{
+    assert(scene);
+    assert(count == 0 || objects);
+    reinterpret_cast<DT_Scene *>(scene)->addObjects(count, reinterpret_cast<DT_Object *const *>(objects));
+}
+
 void DT_RemoveObject(DT_SceneHandle scene, DT_ObjectHandle object) 
 {
     assert(scene);
@@ -315,6 +334,80 @@ void DT_RemoveObject(DT_SceneHandle scene, DT_ObjectHandle object)
     reinterpret_cast<DT_Scene *>(scene)->removeObject(*reinterpret_cast<DT_Object *>(object));
 }
 
+void DT_RemoveObjects(DT_SceneHandle scene, DT_Count count, const DT_ObjectHandle *objects) 
+{
+    assert(scene);
+    assert(count == 0 || objects);
+    reinterpret_cast<DT_Scene *>(scene)->removeObjects(count, reinterpret_cast<DT_Object *const *>(objects));
+}
+
+void DT_BeginUpdate(DT_SceneHandle scene) 
+{
+    assert(scene);
+    reinterpret_cast<DT_Scene *>(scene)->beginUpdate();
+}
+
+void DT_EndUpdate(DT_SceneHandle scene) 
+{
+    assert(scene);
+    reinterpret_cast<DT_Scene *>(scene)->endUpdate();
+}
+
+void DT_SetSimplexCaching(DT_SceneHandle scene, DT_Bool enable) 
+{
+    assert(scene);
+    reinterpret_cast<DT_Scene *>(scene)->setSimplexCaching(enable != DT_FALSE);
+}
+
+void DT_GetSimplexCacheStats(DT_SceneHandle scene, DT_Count *hits, 
+							 DT_Count *misses, DT_Count *iterations) 
+{
+    assert(scene);
+    reinterpret_cast<DT_Scene *>(scene)->getSimplexStats(*hits, *misses, *iterations);
+}
+
+void DT_SetPairBatching(DT_SceneHandle scene, DT_Bool enable) 
+{
+    assert(scene);
+    reinterpret_cast<DT_Scene *>(scene)->setBatching(enable != DT_FALSE);
+}
+
+template <typename T>
+static void setMatrices(DT_Scene& scene, DT_Count count, 
+						const DT_ObjectHandle *objects, const T *matrices)
+{
+	bool batch = !scene.isUpdating();
+	if (batch)
+	{
+		scene.beginUpdate();
+	}
+	
+	DT_Index i;
+	for (i = 0; i != count; ++i, matrices += 16)
+	{
+		assert(objects[i]);
+		reinterpret_cast<DT_Object *>(objects[i])->setMatrix(matrices);
+	}
+
+	if (batch)
+	{
+		scene.endUpdate();
+	}
+}
+
+void DT_SetMatricesf(DT_SceneHandle scene, DT_Count count, 
+					 const DT_ObjectHandle *objects, const float *matrices)
+{
+    assert(scene);
+    setMatrices(*reinterpret_cast<DT_Scene *>(scene), count, objects, matrices);
+}
+
+void DT_SetMatricesd(DT_SceneHandle scene, DT_Count count, 
+					 const DT_ObjectHandle *objects, const double *matrices)
+{
+    assert(scene);
+    setMatrices(*reinterpret_cast<DT_Scene *>(scene), count, objects, matrices);
+}
 
 // Object instantiation
 
@@ -337,6 +430,39 @@ void DT_SetMargin(DT_ObjectHandle object, DT_Scalar margin)
     reinterpret_cast<DT_Object *>(object)->setMargin(MT_Scalar(margin));
 }
 
+void DT_SetObjectStatic(DT_ObjectHandle object, DT_Bool is_static) 
+{
+	assert(object);
+    reinterpret_cast<DT_Object *>(object)->setStatic(is_static != DT_FALSE);
+}
+
+void DT_SetObjectFilter(DT_ObjectHandle object, DT_Mask category, DT_Mask mask) 
+{
+	assert(object);
+    reinterpret_cast<DT_Object *>(object)->setFilter(category, mask);
+}
+
+void DT_SetObjectSlack(DT_ObjectHandle object, DT_Scalar slack) 
+{
+	assert(object);
+	assert(slack >= 0.0f);
+    reinterpret_cast<DT_Object *>(object)->setSlack(MT_Scalar(slack));
+}
+
+void DT_SetObjectVelocity(DT_ObjectHandle object, const DT_Vector3 velocity) 
+{
+	assert(object);
+    reinterpret_cast<DT_Object *>(object)->setVelocity(MT_Vector3(velocity));
+}
+
+void DT_GetBBoxUpdates(DT_ObjectHandle object, DT_Count *updated, DT_Count *skipped) 
+{
+	assert(object);
+	DT_Object *obj = reinterpret_cast<DT_Object *>(object);
+	*updated = obj->getUpdated();
+	*skipped = obj->getSkipped();
+}
+
 
 void DT_SetScaling(DT_ObjectHandle object, const DT_Vector3 scaling) 
 {
@@ -459,11 +585,11 @@ DT_Bool DT_GetPenDepth(DT_ObjectHandle object1, DT_ObjectHandle object2,
     bool result;
     if (b->getType() < a->getType())
     { 
-        result = penetration_depth(*b, *a, v, p2, p1);
+        result = penetration_depth(*b, *a, v, p2, p1, 0, DT_Accuracy::depth_method);
     }
     else
     { 
-        result = penetration_depth(*a, *b, v, p1, p2);
+        result = penetration_depth(*a, *b, v, p1, p2, 0, DT_Accuracy::depth_method);
     }
 
 
@@ -590,11 +716,53 @@ void DT_SetTolerance(DT_Scalar tol_error)
 	}
 }
 
+void DT_SetPenDepthMethod(DT_PenDepthMethod method) 
+{ 
+	DT_Accuracy::setDepthMethod(method == DT_PENDEPTH_MPR ? DT_Accuracy::MPR : DT_Accuracy::EPA); 
+}
+
 DT_Count DT_Test(DT_SceneHandle scene, DT_RespTableHandle respTable) 
 { 
     return reinterpret_cast<DT_Scene *>(scene)->handleCollisions(reinterpret_cast<DT_RespTable *>(respTable));
 }
 
+DT_Count DT_TestParallel(DT_SceneHandle scene, DT_RespTableHandle respTable, 
+						 DT_Count num_threads) 
+{ 
+	assert(scene);
+	assert(num_threads != 0);
+    return reinterpret_cast<DT_Scene *>(scene)->handleCollisions(reinterpret_cast<DT_RespTable *>(respTable), 
+																 num_threads);
+}
+
+DT_ContactBuffer *DT_CreateContactBuffer() 
+{
+	DT_ContactBuffer *buffer = new DT_ContactBuffer;
+	buffer->contacts = 0;
+	buffer->capacity = 0;
+	buffer->count = 0;
+	buffer->storage = new std::vector<DT_Contact>;
+	return buffer;
+}
+
+void DT_DestroyContactBuffer(DT_ContactBuffer *buffer) 
+{
+	assert(buffer);
+	assert(buffer->storage);
+	delete (std::vector<DT_Contact> *)buffer->storage;
+	delete buffer;
+}
+
+DT_Count DT_TestCollect(DT_SceneHandle scene, DT_RespTableHandle respTable, 
+						DT_ContactBuffer *buffer) 
+{ 
+	assert(scene);
+	assert(buffer);
+	assert(buffer->storage || buffer->contacts || buffer->capacity == 0);
+    return reinterpret_cast<DT_Scene *>(scene)->collectCollisions(reinterpret_cast<DT_RespTable *>(respTable), 
+																  *buffer);
+}
+
 void *DT_RayCast(DT_SceneHandle scene, void *ignore_client,
 				 const DT_Vector3 source, const DT_Vector3 target,
 				 DT_Scalar max_param, DT_Scalar *param, DT_Vector3 normal) 
@@ -611,6 +779,15 @@ void *DT_RayCast(DT_SceneHandle scene, void *ignore_client,
 	return client_object;
 }
 
+DT_Count DT_QueryBox(DT_SceneHandle scene, 
+					 const DT_Vector3 min, const DT_Vector3 max,
+					 DT_QueryCallback callback, void *client_data) 
+{
+	assert(scene);
+	assert(callback);
+	return reinterpret_cast<DT_Scene *>(scene)->queryBox(min, max, callback, client_data);
+}
+
 DT_Bool DT_ObjectRayCast(DT_ObjectHandle object,
 	   				     const DT_Vector3 source, const DT_Vector3 target,
 					     DT_Scalar max_param, DT_Scalar *param, DT_Vector3 hit_normal) 
@@ -26,75 +26,55 @@
 #include "DT_Object.h"
 #include "GEN_MinMax.h"
 
-DT_Bool DT_Encounter::exactTest(const DT_RespTable *respTable, int& count) const 
+DT_ResponseType DT_Encounter::collide(const DT_RespTable *respTable, DT_CollData& coll_data, 
+									  bool cache_simplex) const 
 {
-	const DT_ResponseList& responseList = respTable->find(m_obj_ptr1, m_obj_ptr2);
+	return collide(respTable->find(m_obj_ptr1, m_obj_ptr2).getType(), coll_data, cache_simplex);
+}
+
+DT_ResponseType DT_Encounter::collide(DT_ResponseType type, DT_CollData& coll_data, 
+									  bool cache_simplex) const 
+{
+	DT_SimplexCache *cache = 0;
+	if (cache_simplex)
+	{
+		m_cache.m_start = DT_Simplex::UNUSED;
+		m_cache.m_iterations = 0;
+		cache = &m_cache;
+	}
 
-   switch (responseList.getType()) 
+   switch (type) 
    {
    case DT_SIMPLE_RESPONSE: 
-	   if (intersect(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis)) 
+	   if (intersect(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis, cache)) 
 	   {
-		   ++count;
-		   return (respTable->getResponseClass(m_obj_ptr1) < respTable->getResponseClass(m_obj_ptr2)) ?
-			   responseList(m_obj_ptr1->getClientObject(), m_obj_ptr2->getClientObject(), 0) :   
-			   responseList(m_obj_ptr2->getClientObject(), m_obj_ptr1->getClientObject(), 0);    
- 
+		   return type;
 	   }
 	   break;
    case DT_WITNESSED_RESPONSE: {
 	   MT_Point3  p1, p2;
 	   
-	   if (common_point(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis, p1, p2)) 
+	   if (common_point(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis, p1, p2, cache)) 
 	   { 
-		   ++count;
-           if (respTable->getResponseClass(m_obj_ptr1) < respTable->getResponseClass(m_obj_ptr2))
-           {
-			   DT_CollData coll_data;
-			   
-			   p1.getValue(coll_data.point1);
-			   p2.getValue(coll_data.point2);
-			   
-               return responseList(m_obj_ptr1->getClientObject(), m_obj_ptr2->getClientObject(), &coll_data);
-           }
-           else
-           {
-			   DT_CollData coll_data;
-			   
-			   p1.getValue(coll_data.point2);
-			   p2.getValue(coll_data.point1);
-			   
-               return responseList(m_obj_ptr2->getClientObject(), m_obj_ptr1->getClientObject(), &coll_data);
-           }
+		   p1.getValue(coll_data.point1);
+		   p2.getValue(coll_data.point2);
+		   MT_Vector3(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0)).getValue(coll_data.normal);
+		   return type;
 	   }
 	   break;
    }
-   case DT_DEPTH_RESPONSE: {
+   case DT_DEPTH_RESPONSE: 
+   case DT_APPROX_DEPTH_RESPONSE: {
 	   MT_Point3  p1, p2;
+	   DT_Accuracy::DepthMethod method = type == DT_APPROX_DEPTH_RESPONSE ? 
+		   DT_Accuracy::MPR : DT_Accuracy::depth_method;
 	   
-	   if (penetration_depth(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis, p1, p2)) 
+	   if (penetration_depth(*m_obj_ptr1, *m_obj_ptr2, m_sep_axis, p1, p2, cache, method)) 
 	   { 
-		   ++count;
-           if (respTable->getResponseClass(m_obj_ptr1) < respTable->getResponseClass(m_obj_ptr2))
-           {
-			   DT_CollData coll_data;
-			   
-			   p1.getValue(coll_data.point1);
-			   p2.getValue(coll_data.point2);	
-               (p2 - p1).getValue(coll_data.normal);
-			   
-               return responseList(m_obj_ptr1->getClientObject(), m_obj_ptr2->getClientObject(), &coll_data);
-           }
-           else
-           {
-			   DT_CollData coll_data;
-			   
-			   p1.getValue(coll_data.point2);
-			   p2.getValue(coll_data.point1); 
-               (p1 - p2).getValue(coll_data.normal);
-			   
-               return responseList(m_obj_ptr2->getClientObject(), m_obj_ptr1->getClientObject(), &coll_data);
-           }
+		   p1.getValue(coll_data.point1);
+		   p2.getValue(coll_data.point2);	
+		   (p2 - p1).getValue(coll_data.normal);
+		   return type;
 	   }
 	   break;
    }
@@ -103,5 +83,78 @@ DT_Bool DT_Encounter::exactTest(const DT_RespTable *respTable, int& count) const
    default:
 	   assert(false);
    }
-   return DT_CONTINUE;
+   return DT_NO_RESPONSE;
+}
+
+void DT_Encounter::getContact(const DT_RespTable *respTable, DT_ResponseType type, 
+							  const DT_CollData& coll_data, DT_Contact& contact) const 
+{
+	DT_ResponseClass class1 = respTable->getResponseClass(m_obj_ptr1);
+	DT_ResponseClass class2 = respTable->getResponseClass(m_obj_ptr2);
+
+	contact.type = type;
+
+	if (class1 < class2)
+	{
+		contact.client_object1 = m_obj_ptr1->getClientObject();
+		contact.client_object2 = m_obj_ptr2->getClientObject();
+		contact.responseClass1 = class1;
+		contact.responseClass2 = class2;
+	}
+	else
+	{
+		contact.client_object1 = m_obj_ptr2->getClientObject();
+		contact.client_object2 = m_obj_ptr1->getClientObject();
+		contact.responseClass1 = class2;
+		contact.responseClass2 = class1;
+	}
+
+	// A simple response computes no collision data.
+	int i;
+	for (i = 0; i != 3; ++i)
+	{
+		if (type == DT_SIMPLE_RESPONSE)
+		{
+			contact.coll_data.point1[i] = DT_Scalar(0.0);
+			contact.coll_data.point2[i] = DT_Scalar(0.0);
+			contact.coll_data.normal[i] = DT_Scalar(0.0);
+		}
+		else if (class1 < class2)
+		{
+			contact.coll_data.point1[i] = coll_data.point1[i];
+			contact.coll_data.point2[i] = coll_data.point2[i];
+			contact.coll_data.normal[i] = coll_data.normal[i];
+		}
+		else
+		{
+			contact.coll_data.point1[i] = coll_data.point2[i];
+			contact.coll_data.point2[i] = coll_data.point1[i];
+			contact.coll_data.normal[i] = -coll_data.normal[i];
+		}
+	}
+}
+
+DT_Bool DT_Encounter::respond(const DT_RespTable *respTable, DT_ResponseType type, 
+							  const DT_CollData& coll_data) const 
+{
+	DT_Contact contact;
+	getContact(respTable, type, coll_data, contact);
+
+	return respTable->find(m_obj_ptr1, m_obj_ptr2)(contact.client_object1, contact.client_object2, 
+												   type == DT_SIMPLE_RESPONSE ? 0 : &contact.coll_data);
+}
+
+DT_Bool DT_Encounter::exactTest(const DT_RespTable *respTable, int& count, 
+								bool cache_simplex) const 
+{
+	DT_CollData coll_data;
+	DT_ResponseType type = collide(respTable, coll_data, cache_simplex);
+
+	if (type == DT_NO_RESPONSE)
+	{
+		return DT_CONTINUE;
+	}
+
+	++count;
+	return respond(respTable, type, coll_data);
 }
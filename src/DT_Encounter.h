@@ -24,8 +24,6 @@
 #ifndef DT_ENCOUNTER_H
 #define DT_ENCOUNTER_H
 
-#include <set>
-
 #include "MT_Vector3.h"
 #include "DT_Object.h"
 #include "DT_Shape.h"
@@ -53,16 +51,49 @@ public:
         }
     }
 
-    DT_Object         *first()          const { return m_obj_ptr1; }
-    DT_Object         *second()         const { return m_obj_ptr2; }
-    const MT_Vector3&  separatingAxis() const { return m_sep_axis; }
-
- 	DT_Bool exactTest(const DT_RespTable *respTable, int& count) const;
+    DT_Object             *first()          const { return m_obj_ptr1; }
+    DT_Object             *second()         const { return m_obj_ptr2; }
+    const MT_Vector3&      separatingAxis() const { return m_sep_axis; }
+	const DT_SimplexCache& simplexCache()   const { return m_cache; }
+
+ 	DT_Bool exactTest(const DT_RespTable *respTable, int& count, bool cache_simplex = false) const;
+
+	// exactTest in two steps. collide runs the narrow phase and returns the 
+	// type of the response to call, or DT_NO_RESPONSE if there is none. The 
+	// collision data is in the order of first() and second(). It writes to 
+	// nothing but this encounter, so distinct encounters can be tested 
+	// concurrently. respond calls the response callbacks. With cache_simplex
+	// set, GJK starts from the simplex on which the last test ended.
+	DT_ResponseType collide(const DT_RespTable *respTable, DT_CollData& coll_data, 
+							bool cache_simplex = false) const;
+	// As collide, for a caller that has already looked up the type of the 
+	// response in the table.
+	DT_ResponseType collide(DT_ResponseType type, DT_CollData& coll_data, 
+							bool cache_simplex = false) const;
+	DT_Bool respond(const DT_RespTable *respTable, DT_ResponseType type, 
+					const DT_CollData& coll_data) const;
+
+	// Keeps the separating axis of a test that ran outside of collide, as 
+	// in a DT_Batch. The test does not use the simplex cache.
+	void setSeparatingAxis(const MT_Vector3& v, bool cache_simplex = false) const
+	{
+		m_sep_axis = v;
+		if (cache_simplex)
+		{
+			m_cache.m_start = DT_Simplex::UNUSED;
+			m_cache.m_iterations = 0;
+		}
+	}
+
+	// Orders the result of collide as respond passes it to the callbacks.
+	void getContact(const DT_RespTable *respTable, DT_ResponseType type, 
+					const DT_CollData& coll_data, DT_Contact& contact) const;
 
 private:
     DT_Object          *m_obj_ptr1;
     DT_Object          *m_obj_ptr2;
-    mutable MT_Vector3  m_sep_axis;
+    mutable MT_Vector3       m_sep_axis;
+	mutable DT_SimplexCache  m_cache;
 };
 
 inline bool operator<(const DT_Encounter& a, const DT_Encounter& b) 
@@ -77,8 +108,4 @@ inline std::ostream& operator<<(std::ostream& os, const DT_Encounter& a) {
     return os << '(' << a.first() << ", " << a.second() << ')';
 }
 
-
-
-typedef std::set<DT_Encounter> DT_EncounterTable;
-
 #endif
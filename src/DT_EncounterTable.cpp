@@ -0,0 +1,145 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include <algorithm>
+
+#include "DT_EncounterTable.h"
+
+static const DT_Count MinSlots = 16;
+
+inline bool operator==(const DT_Encounter& a, const DT_Encounter& b) 
+{ 
+    return a.first() == b.first() && a.second() == b.second(); 
+}
+
+DT_EncounterTable::DT_EncounterTable()
+  : m_slots(MinSlots, DT_Index(EMPTY)),
+	m_mask(MinSlots - 1)
+{}
+
+DT_Index DT_EncounterTable::lookup(const DT_Encounter& e) const
+{
+	DT_Index slot = hash(e) & m_mask;
+	while (m_slots[slot] != DT_Index(EMPTY) && !(m_encounterList[m_slots[slot]] == e))
+	{
+		slot = (slot + 1) & m_mask;
+	}
+	return slot;
+}
+
+DT_EncounterTable::iterator DT_EncounterTable::find(const DT_Encounter& e)
+{
+	DT_Index slot = lookup(e);
+	return m_slots[slot] != DT_Index(EMPTY) ? m_encounterList.begin() + m_slots[slot] : end();
+}
+
+std::pair<DT_EncounterTable::iterator, bool> DT_EncounterTable::insert(const DT_Encounter& e)
+{
+	DT_Index slot = lookup(e);
+	if (m_slots[slot] != DT_Index(EMPTY))
+	{
+		return std::make_pair(m_encounterList.begin() + m_slots[slot], false);
+	}
+
+	// Keep the table at most half full. Linear probing degrades quickly above that.
+	if (2 * (m_encounterList.size() + 1) > m_slots.size())
+	{
+		rehash(2 * m_slots.size());
+		slot = lookup(e);
+	}
+
+	m_slots[slot] = m_encounterList.size();
+	m_encounterList.push_back(e);
+	return std::make_pair(m_encounterList.end() - 1, true);
+}
+
+void DT_EncounterTable::erase(iterator it)
+{
+	DT_Index index = it - m_encounterList.begin();
+	DT_Index last = m_encounterList.size() - 1;
+
+	remove(lookup(*it));
+
+	if (index != last)
+	{
+		m_encounterList[index] = m_encounterList[last];
+		m_slots[lookup(m_encounterList[index])] = index;
+	}
+	m_encounterList.pop_back();
+}
+
+void DT_EncounterTable::clear()
+{
+	m_encounterList.clear();
+	std::fill(m_slots.begin(), m_slots.end(), DT_Index(EMPTY));
+}
+
+void DT_EncounterTable::reserve(DT_Count count)
+{
+	DT_Count num_slots = m_slots.size();
+	while (num_slots < 2 * count)
+	{
+		num_slots *= 2;
+	}
+
+	if (num_slots != m_slots.size())
+	{
+		rehash(num_slots);
+	}
+	m_encounterList.reserve(count);
+}
+
+void DT_EncounterTable::remove(DT_Index slot)
+{
+	// Shift back the entries of the probe sequence that follows the 
+	// vacated slot, so that no tombstones are needed.
+	DT_Index next = slot;
+	for (;;)
+	{
+		next = (next + 1) & m_mask;
+		if (m_slots[next] == DT_Index(EMPTY))
+		{
+			break;
+		}
+
+		DT_Index home = hash(m_encounterList[m_slots[next]]) & m_mask;
+		if (((next - home) & m_mask) >= ((next - slot) & m_mask))
+		{
+			m_slots[slot] = m_slots[next];
+			slot = next;
+		}
+	}
+	m_slots[slot] = EMPTY;
+}
+
+void DT_EncounterTable::rehash(DT_Count num_slots)
+{
+	m_slots.assign(num_slots, DT_Index(EMPTY));
+	m_mask = num_slots - 1;
+
+	DT_Index i;
+	for (i = 0; i != m_encounterList.size(); ++i)
+	{
+		m_slots[lookup(m_encounterList[i])] = i;
+	}
+}
@@ -0,0 +1,86 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_ENCOUNTERTABLE_H
+#define DT_ENCOUNTERTABLE_H
+
+#include <vector>
+
+#include "DT_Encounter.h"
+
+// The set of encounters of a scene. The encounters are stored in a dense 
+// array, so that iterating over them is a linear scan. An open-addressing 
+// hash table with linear probing maps each pair of objects to its position 
+// in the array. Erasing moves the last encounter into the vacated position, 
+// so the order of iteration is not preserved. Iterators are invalidated by 
+// insert and erase.
+
+class DT_EncounterTable {
+	enum { EMPTY = ~0u };
+
+	typedef std::vector<DT_Encounter> T_EncounterList;
+
+public:
+	typedef T_EncounterList::iterator       iterator;
+	typedef T_EncounterList::const_iterator const_iterator;
+
+	DT_EncounterTable();
+
+	iterator       begin()       { return m_encounterList.begin(); }
+	iterator       end()         { return m_encounterList.end(); }
+	const_iterator begin() const { return m_encounterList.begin(); }
+	const_iterator end()   const { return m_encounterList.end(); }
+
+	DT_Count size()  const { return m_encounterList.size(); }
+	bool     empty() const { return m_encounterList.empty(); }
+
+	const DT_Encounter& operator[](DT_Index i) const { return m_encounterList[i]; }
+
+	iterator find(const DT_Encounter& e);
+	std::pair<iterator, bool> insert(const DT_Encounter& e);
+	void erase(iterator it);
+	void clear();
+
+	// Makes room for count encounters, so that inserting them does not rehash.
+	void reserve(DT_Count count);
+
+private:
+	static DT_Index hash(const DT_Encounter& e)
+	{
+		// The objects are heap allocated, so the low bits carry no information.
+		DT_Index h = DT_Index(size_t(e.first()) >> 4) * 2654435761u ^ 
+		             DT_Index(size_t(e.second()) >> 4) * 2246822519u;
+		return h ^ (h >> 15);
+	}
+
+	// Returns the slot holding e, or the empty slot where e would go.
+	DT_Index lookup(const DT_Encounter& e) const;
+	void     remove(DT_Index slot);
+	void     rehash(DT_Count num_slots);
+
+	T_EncounterList        m_encounterList;
+	std::vector<DT_Index>  m_slots;
+	DT_Index               m_mask;
+};
+
+#endif
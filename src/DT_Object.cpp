@@ -29,21 +29,93 @@
 #include "DT_Transform.h"
 #include "DT_Minkowski.h"
 #include "DT_Sphere.h"
+#include "DT_Box.h"
+#include "DT_Primitive.h"
+#include "DT_PenDepth.h"
 
 void DT_Object::setBBox() 
 {
 	m_bbox = m_shape.bbox(m_xform, m_margin); 
+	if (isLoose() && m_bbox.inside(m_fatBBox))
+	{
+		++m_skipped;
+	}
+	else
+	{
+		++m_updated;
+		fattenBBox();
+	}
+}
+
+void DT_Object::fattenBBox() 
+{
+	MT_Point3 lower = m_bbox.getMin();
+	MT_Point3 upper = m_bbox.getMax();
+	int i;
+	for (i = 0; i != 3; ++i)
+	{
+		lower[i] -= m_slack;
+		upper[i] += m_slack;
+		if (m_velocity[i] < MT_Scalar(0.0))
+		{
+			lower[i] += m_velocity[i];
+		}
+		else
+		{
+			upper[i] += m_velocity[i];
+		}
+	}
+	m_fatBBox = MT_BBox(lower, upper);
+
 	DT_Vector3 min, max;
-	m_bbox.getMin().getValue(min);
-	m_bbox.getMax().getValue(max);
+	lower.getValue(min);
+	upper.getValue(max);
 	
 	T_ProxyList::const_iterator it;
 	for (it = m_proxies.begin(); it != m_proxies.end(); ++it) 
 	{
-		BP_SetBBox(*it, min, max);
+		BP_SetBBox((*it).second, min, max);
 	}
 }
 
+void DT_Object::setStatic(bool is_static)
+{
+	if (m_static != is_static)
+	{
+		m_static = is_static;
+
+		T_ProxyList::iterator it;
+		for (it = m_proxies.begin(); it != m_proxies.end(); ++it) 
+		{
+			BP_DestroyProxy((*it).first, (*it).second);
+			(*it).second = createProxy((*it).first);
+		}
+	}
+}
+
+void DT_Object::setFilter(DT_Mask category, DT_Mask mask)
+{
+	m_category = category;
+	m_mask = mask;
+
+	T_ProxyList::const_iterator it;
+	for (it = m_proxies.begin(); it != m_proxies.end(); ++it) 
+	{
+		BP_SetProxyFilter((*it).first, (*it).second, category, mask);
+	}
+}
+
+BP_ProxyHandle DT_Object::createProxy(BP_SceneHandle scene)
+{
+	DT_Vector3 min, max;
+	m_fatBBox.getMin().getValue(min);
+	m_fatBBox.getMax().getValue(max);
+
+	return m_static ? 
+		BP_CreateStaticProxy(scene, this, min, max, m_category, m_mask) :
+		BP_CreateFilteredProxy(scene, this, min, max, m_category, m_mask);
+}
+
 bool DT_Object::ray_cast(const MT_Point3& source, const MT_Point3& target, 
 						 MT_Scalar& lambda, MT_Vector3& normal) const 
 {	
@@ -67,17 +139,59 @@ bool DT_Object::ray_cast(const MT_Point3& source, const MT_Point3& target,
 	return result;
 }
 
+void DT_SimplexCache::seed(const MT_Transform& a2w, MT_Scalar a_margin, 
+						   const MT_Transform& b2w, MT_Scalar b_margin, 
+						   DT_Simplex& simplex) const
+{
+	simplex.m_num_verts = 0;
+	if (m_num_verts != 0 && m_a_margin == a_margin && m_b_margin == b_margin)
+	{
+		int i;
+		for (i = 0; i != m_num_verts; ++i)
+		{
+			simplex.m_p[i] = a2w(m_p[i]);
+			simplex.m_q[i] = b2w(m_q[i]);
+		}
+		simplex.m_num_verts = m_num_verts;
+	}
+}
+
+void DT_SimplexCache::store(const MT_Transform& a2w, MT_Scalar a_margin, 
+							const MT_Transform& b2w, MT_Scalar b_margin, 
+							const DT_Simplex& simplex)
+{
+	m_start = simplex.m_start;
+	m_iterations = simplex.m_iterations;
+	if (simplex.m_start == DT_Simplex::UNUSED)
+	{
+		return;
+	}
+
+	MT_Transform w2a = a2w.inverse();
+	MT_Transform w2b = b2w.inverse();
+	int i;
+	for (i = 0; i != simplex.m_num_verts; ++i)
+	{
+		m_p[i] = w2a(simplex.m_p[i]);
+		m_q[i] = w2b(simplex.m_q[i]);
+	}
+	m_num_verts = simplex.m_num_verts;
+	m_a_margin = a_margin;
+	m_b_margin = b_margin;
+}
+
 typedef bool (*Intersect)(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						  const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-						  MT_Vector3&);
+						  MT_Vector3&, DT_SimplexCache *);
 
 typedef bool (*Common_point)(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						     const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-			                 MT_Vector3&, MT_Point3&, MT_Point3&);
+			                 MT_Vector3&, MT_Point3&, MT_Point3&, DT_SimplexCache *);
 
 typedef bool (*Penetration_depth)(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						          const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                                  MT_Vector3&, MT_Point3&, MT_Point3&);
+                                  MT_Vector3&, MT_Point3&, MT_Point3&, DT_SimplexCache *, 
+								  DT_Accuracy::DepthMethod);
 
 typedef MT_Scalar (*Closest_points)(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						            const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
@@ -88,20 +202,50 @@ typedef AlgoTable<Common_point> Common_pointTable;
 typedef AlgoTable<Penetration_depth> Penetration_depthTable;
 typedef AlgoTable<Closest_points> Closest_pointsTable;
 
+// Fills the table with the general algorithms. For convex shapes these are 
+// based on GJK, which is also the fallback of the closed-form algorithms 
+// that are added for some pairs of primitives later.
+template <typename Function>
+void addGeneralEntries(AlgoTable<Function>& table, Function complexComplex, 
+					   Function complexConvex, Function convexConvex)
+{
+	table.addEntry(COMPLEX, COMPLEX, complexComplex);
+	int i, j;
+	for (i = CONVEX; i != NUM_SHAPE_TYPES; ++i)
+	{
+		table.addEntry(COMPLEX, DT_ShapeType(i), complexConvex);
+		for (j = i; j != NUM_SHAPE_TYPES; ++j)
+		{
+			table.addEntry(DT_ShapeType(i), DT_ShapeType(j), convexConvex);
+		}
+	}
+}
+
 
 bool intersectConvexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						   const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                           MT_Vector3& v) 
+                           MT_Vector3& v, DT_SimplexCache *cache) 
 {
 	DT_Transform ta(a2w, (const DT_Convex&)a);
 	DT_Transform tb(b2w, (const DT_Convex&)b);
-    return intersect((a_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(ta, DT_Sphere(a_margin))) : static_cast<const DT_Convex&>(ta)), 
-			         (b_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(tb, DT_Sphere(b_margin))) : static_cast<const DT_Convex&>(tb)), v);
+	DT_Simplex simplex;
+	if (cache)
+	{
+		cache->seed(a2w, a_margin, b2w, b_margin, simplex);
+	}
+    bool result = intersect((a_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(ta, DT_Sphere(a_margin))) : static_cast<const DT_Convex&>(ta)), 
+							(b_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(tb, DT_Sphere(b_margin))) : static_cast<const DT_Convex&>(tb)), v, 
+							cache ? &simplex : 0);
+	if (cache)
+	{
+		cache->store(a2w, a_margin, b2w, b_margin, simplex);
+	}
+	return result;
 }
 
 bool intersectComplexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 						    const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                            MT_Vector3& v) 
+                            MT_Vector3& v, DT_SimplexCache *) 
 {
 	DT_Transform tb(b2w, (const DT_Convex&)b);
     return intersect((const DT_Complex&)a, a2w, a_margin, 
@@ -110,42 +254,91 @@ bool intersectComplexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scala
 
 bool intersectComplexComplex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 							 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                             MT_Vector3& v) 
+                             MT_Vector3& v, DT_SimplexCache *) 
 {
     return intersect((const DT_Complex&)a, a2w, a_margin, 
 					 (const DT_Complex&)b, b2w, b_margin, v);
 }
 
+template <typename Primitive1, typename Primitive2>
+bool intersectPrimitives(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+						 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+						 MT_Vector3& v, DT_SimplexCache *cache) 
+{
+	Primitive1 wa;
+	Primitive2 wb;
+	if (wa.setValue((const typename Primitive1::Shape&)a, a2w, a_margin) && 
+		wb.setValue((const typename Primitive2::Shape&)b, b2w, b_margin))
+	{
+		return intersect(wa, wb, v);
+	}
+	return intersectConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, cache);
+}
+
+bool intersectBoxBox(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+					 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+					 MT_Vector3& v, DT_SimplexCache *cache) 
+{
+	DT_WorldBox wa, wb;
+	if (wa.setValue((const DT_Box&)a, a2w, a_margin) && 
+		wb.setValue((const DT_Box&)b, b2w, b_margin))
+	{
+		if (separated(wa, wb, v))
+		{
+			return false;
+		}
+		if (a_margin + b_margin == MT_Scalar(0.0))
+		{
+			v.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+			return true;
+		}
+	}
+	return intersectConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, cache);
+}
+
 IntersectTable& intersectInitialize() 
 {
     static IntersectTable table;
-    table.addEntry(COMPLEX, COMPLEX, intersectComplexComplex);
-    table.addEntry(COMPLEX, CONVEX, intersectComplexConvex);
-    table.addEntry(CONVEX, CONVEX, intersectConvexConvex);
+    addGeneralEntries<Intersect>(table, intersectComplexComplex, intersectComplexConvex, intersectConvexConvex);
+    table.addEntry(SPHERE, SPHERE, intersectPrimitives<DT_WorldSphere, DT_WorldSphere>);
+    table.addEntry(SPHERE, BOX, intersectPrimitives<DT_WorldSphere, DT_WorldBox>);
+    table.addEntry(SPHERE, LINESEGMENT, intersectPrimitives<DT_WorldSphere, DT_WorldSegment>);
+    table.addEntry(BOX, BOX, intersectBoxBox);
     return table;
 }
 
-bool intersect(const DT_Object& a, const DT_Object& b, MT_Vector3& v) 
+bool intersect(const DT_Object& a, const DT_Object& b, MT_Vector3& v, DT_SimplexCache *cache) 
 {
     static const IntersectTable& intersectTable = intersectInitialize();
     Intersect intersect = intersectTable.lookup(a.getType(), b.getType());
     return intersect(a.m_shape, a.m_xform, a.m_margin, 
-		             b.m_shape, b.m_xform, b.m_margin, v);
+		             b.m_shape, b.m_xform, b.m_margin, v, cache);
 }
 
 bool common_pointConvexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 							  const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-							  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+							  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache) 
 {
 	DT_Transform ta(a2w, (const DT_Convex&)a);
 	DT_Transform tb(b2w, (const DT_Convex&)b);
-    return common_point((a_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(ta, DT_Sphere(a_margin))) : static_cast<const DT_Convex&>(ta)), 
-						(b_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(tb, DT_Sphere(b_margin))) : static_cast<const DT_Convex&>(tb)), v, pa, pb);
+	DT_Simplex simplex;
+	if (cache)
+	{
+		cache->seed(a2w, a_margin, b2w, b_margin, simplex);
+	}
+    bool result = common_point((a_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(ta, DT_Sphere(a_margin))) : static_cast<const DT_Convex&>(ta)), 
+							   (b_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(DT_Minkowski(tb, DT_Sphere(b_margin))) : static_cast<const DT_Convex&>(tb)), v, pa, pb, 
+							   cache ? &simplex : 0);
+	if (cache)
+	{
+		cache->store(a2w, a_margin, b2w, b_margin, simplex);
+	}
+	return result;
 }
 
 bool common_pointComplexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 							   const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-							   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+							   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *) 
 {
  	DT_Transform tb(b2w, (const DT_Convex&)b);
 	return common_point((const DT_Complex&)a, a2w, a_margin,
@@ -154,69 +347,152 @@ bool common_pointComplexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Sc
 
 bool common_pointComplexComplex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 								const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-								MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+								MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *) 
 {
     return common_point((const DT_Complex&)a, a2w, a_margin, 
 						(const DT_Complex&)b, b2w, b_margin, v, pa, pb);
 }
 
+template <typename Primitive1, typename Primitive2>
+bool common_pointPrimitives(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+							const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+							MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache) 
+{
+	Primitive1 wa;
+	Primitive2 wb;
+	if (wa.setValue((const typename Primitive1::Shape&)a, a2w, a_margin) && 
+		wb.setValue((const typename Primitive2::Shape&)b, b2w, b_margin))
+	{
+		return common_point(wa, wb, v, pa, pb);
+	}
+	return common_pointConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, pa, pb, cache);
+}
+
+// Only separated boxes have a closed form. For boxes that intersect, GJK
+// finds the common point.
+bool common_pointBoxBox(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+						const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+						MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache) 
+{
+	DT_WorldBox wa, wb;
+	if (wa.setValue((const DT_Box&)a, a2w, a_margin) && 
+		wb.setValue((const DT_Box&)b, b2w, b_margin) &&
+		separated(wa, wb, v))
+	{
+		return false;
+	}
+	return common_pointConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, pa, pb, cache);
+}
+
 const Common_pointTable& common_pointInitialize() 
 {
     static Common_pointTable table;
-    table.addEntry(COMPLEX, COMPLEX, common_pointComplexComplex);
-    table.addEntry(COMPLEX, CONVEX, common_pointComplexConvex);
-    table.addEntry(CONVEX, CONVEX, common_pointConvexConvex);
+    addGeneralEntries<Common_point>(table, common_pointComplexComplex, common_pointComplexConvex, common_pointConvexConvex);
+    table.addEntry(SPHERE, SPHERE, common_pointPrimitives<DT_WorldSphere, DT_WorldSphere>);
+    table.addEntry(SPHERE, BOX, common_pointPrimitives<DT_WorldSphere, DT_WorldBox>);
+    table.addEntry(SPHERE, LINESEGMENT, common_pointPrimitives<DT_WorldSphere, DT_WorldSegment>);
+    table.addEntry(BOX, BOX, common_pointBoxBox);
     return table;
 }
 
-bool common_point(const DT_Object& a, const DT_Object& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+bool common_point(const DT_Object& a, const DT_Object& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, 
+				  DT_SimplexCache *cache) 
 {
     static const Common_pointTable& common_pointTable = common_pointInitialize();
     Common_point common_point = common_pointTable.lookup(a.getType(), b.getType());
     return common_point(a.m_shape, a.m_xform, a.m_margin, 
-						b.m_shape, b.m_xform, b.m_margin, v, pa, pb);
+						b.m_shape, b.m_xform, b.m_margin, v, pa, pb, cache);
 }
 
 
 
 bool penetration_depthConvexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 								   const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                                   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+                                   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache,
+								   DT_Accuracy::DepthMethod method) 
 {
-    return hybrid_penetration_depth(DT_Transform(a2w, (const DT_Convex&)a), a_margin, 
-									DT_Transform(b2w, (const DT_Convex&)b), b_margin, v, pa, pb);
+	if (cache == 0)
+	{
+		return hybrid_penetration_depth(DT_Transform(a2w, (const DT_Convex&)a), a_margin, 
+										DT_Transform(b2w, (const DT_Convex&)b), b_margin, v, pa, pb,
+										DT_EPAWorkspace::local(), 0, method);
+	}
+
+	DT_Simplex simplex;
+	cache->seed(a2w, a_margin, b2w, b_margin, simplex);
+    bool result = hybrid_penetration_depth(DT_Transform(a2w, (const DT_Convex&)a), a_margin, 
+										   DT_Transform(b2w, (const DT_Convex&)b), b_margin, v, pa, pb,
+										   DT_EPAWorkspace::local(), &simplex, method);
+	cache->store(a2w, a_margin, b2w, b_margin, simplex);
+	return result;
 }
 
 bool penetration_depthComplexConvex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 									const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                                    MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+                                    MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *,
+									DT_Accuracy::DepthMethod method) 
 {
     return penetration_depth((const DT_Complex&)a, a2w, a_margin,
-							 DT_Transform(b2w, (const DT_Convex&)b), b_margin, v, pa, pb);
+							 DT_Transform(b2w, (const DT_Convex&)b), b_margin, v, pa, pb, method);
 }
 
 bool penetration_depthComplexComplex(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
 									 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
-                                     MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+                                     MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *,
+									 DT_Accuracy::DepthMethod method) 
+{
+    return penetration_depth((const DT_Complex&)a, a2w, a_margin, (const DT_Complex&)b, b2w, b_margin, v, pa, pb, method);
+}
+
+template <typename Primitive1, typename Primitive2>
+bool penetration_depthPrimitives(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+								 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+								 MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache,
+								 DT_Accuracy::DepthMethod method) 
+{
+	Primitive1 wa;
+	Primitive2 wb;
+	if (wa.setValue((const typename Primitive1::Shape&)a, a2w, a_margin) && 
+		wb.setValue((const typename Primitive2::Shape&)b, b2w, b_margin))
+	{
+		return penetration_depth(wa, wb, v, pa, pb);
+	}
+	return penetration_depthConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, pa, pb, cache, method);
+}
+
+bool penetration_depthBoxBox(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+							 const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+							 MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache,
+							 DT_Accuracy::DepthMethod method) 
 {
-    return penetration_depth((const DT_Complex&)a, a2w, a_margin, (const DT_Complex&)b, b2w, b_margin, v, pa, pb);
+	DT_WorldBox wa, wb;
+	if (wa.setValue((const DT_Box&)a, a2w, a_margin) && 
+		wb.setValue((const DT_Box&)b, b2w, b_margin) &&
+		separated(wa, wb, v))
+	{
+		return false;
+	}
+	return penetration_depthConvexConvex(a, a2w, a_margin, b, b2w, b_margin, v, pa, pb, cache, method);
 }
 
 const Penetration_depthTable& penetration_depthInitialize() 
 {
     static Penetration_depthTable table;
-    table.addEntry(COMPLEX, COMPLEX, penetration_depthComplexComplex);
-    table.addEntry(COMPLEX, CONVEX, penetration_depthComplexConvex);
-    table.addEntry(CONVEX, CONVEX, penetration_depthConvexConvex);
+    addGeneralEntries<Penetration_depth>(table, penetration_depthComplexComplex, penetration_depthComplexConvex, penetration_depthConvexConvex);
+    table.addEntry(SPHERE, SPHERE, penetration_depthPrimitives<DT_WorldSphere, DT_WorldSphere>);
+    table.addEntry(SPHERE, BOX, penetration_depthPrimitives<DT_WorldSphere, DT_WorldBox>);
+    table.addEntry(SPHERE, LINESEGMENT, penetration_depthPrimitives<DT_WorldSphere, DT_WorldSegment>);
+    table.addEntry(BOX, BOX, penetration_depthBoxBox);
     return table;
 }
 
-bool penetration_depth(const DT_Object& a, const DT_Object& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+bool penetration_depth(const DT_Object& a, const DT_Object& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, 
+					   DT_SimplexCache *cache, DT_Accuracy::DepthMethod method) 
 {
     static const Penetration_depthTable& penetration_depthTable = penetration_depthInitialize();
     Penetration_depth penetration_depth = penetration_depthTable.lookup(a.getType(), b.getType());
     return penetration_depth(a.m_shape, a.m_xform, a.m_margin, 
-		                     b.m_shape, b.m_xform, b.m_margin, v, pa, pb);
+		                     b.m_shape, b.m_xform, b.m_margin, v, pa, pb, cache, method);
 }
 
 
@@ -247,12 +523,30 @@ MT_Scalar closest_pointsComplexComplex(const DT_Shape& a, const MT_Transform& a2
 						  (const DT_Complex&)b, b2w, b_margin, pa, pb);
 }
 
+template <typename Primitive1, typename Primitive2>
+MT_Scalar closest_pointsPrimitives(const DT_Shape& a, const MT_Transform& a2w, MT_Scalar a_margin,
+								   const DT_Shape& b, const MT_Transform& b2w, MT_Scalar b_margin,
+								   MT_Point3& pa, MT_Point3& pb) 
+{
+	Primitive1 wa;
+	Primitive2 wb;
+	if (wa.setValue((const typename Primitive1::Shape&)a, a2w, a_margin) && 
+		wb.setValue((const typename Primitive2::Shape&)b, b2w, b_margin))
+	{
+		return closest_points(wa, wb, pa, pb);
+	}
+	return closest_pointsConvexConvex(a, a2w, a_margin, b, b2w, b_margin, pa, pb);
+}
+
+// The closest points of two boxes have no simple closed form, so these are
+// left to GJK.
 const Closest_pointsTable& closest_pointsInitialize()
 {
     static Closest_pointsTable table;
-    table.addEntry(COMPLEX, COMPLEX, closest_pointsComplexComplex);
-    table.addEntry(COMPLEX, CONVEX, closest_pointsComplexConvex);
-    table.addEntry(CONVEX, CONVEX, closest_pointsConvexConvex);
+    addGeneralEntries<Closest_points>(table, closest_pointsComplexComplex, closest_pointsComplexConvex, closest_pointsConvexConvex);
+    table.addEntry(SPHERE, SPHERE, closest_pointsPrimitives<DT_WorldSphere, DT_WorldSphere>);
+    table.addEntry(SPHERE, BOX, closest_pointsPrimitives<DT_WorldSphere, DT_WorldBox>);
+    table.addEntry(SPHERE, LINESEGMENT, closest_pointsPrimitives<DT_WorldSphere, DT_WorldSegment>);
     return table;
 }
 
@@ -34,16 +34,56 @@
 #include "MT_BBox.h"
 #include "DT_Shape.h"
 #include "DT_Complex.h"
+#include "DT_GJK.h"
+#include "DT_Accuracy.h"
 
 class DT_Convex;
 
+// The last simplex of GJK for a pair of objects. The vertices are kept in the 
+// coordinates of the objects, so that they follow the objects. For objects 
+// that move rigidly and keep their margins, the vertices remain support 
+// points of the objects, and the next test of the pair starts from them.
+struct DT_SimplexCache {
+	DT_SimplexCache() :
+		m_num_verts(0),
+		m_start(DT_Simplex::UNUSED),
+		m_iterations(0)
+	{}
+
+	// Leaves 'simplex' empty if there are no vertices for the margins.
+	void seed(const MT_Transform& a2w, MT_Scalar a_margin, 
+			  const MT_Transform& b2w, MT_Scalar b_margin, 
+			  DT_Simplex& simplex) const;
+	void store(const MT_Transform& a2w, MT_Scalar a_margin, 
+			   const MT_Transform& b2w, MT_Scalar b_margin, 
+			   const DT_Simplex& simplex);
+
+	int        m_num_verts;
+	MT_Point3  m_p[4];
+	MT_Point3  m_q[4];
+	MT_Scalar  m_a_margin;
+	MT_Scalar  m_b_margin;
+
+	// How the last test started and its number of iterations. Tests that do 
+	// not run GJK leave the start unused.
+	DT_Simplex::T_Start  m_start;
+	int                  m_iterations;
+};
+
 class DT_Object {
 public:
     DT_Object(void *client_object, const DT_Shape& shape) :
 		m_client_object(client_object),
 		m_responseClass(0),
 		m_shape(shape), 
-		m_margin(MT_Scalar(0.0))
+		m_margin(MT_Scalar(0.0)),
+		m_static(false),
+		m_category(BP_ALL_BITS),
+		m_mask(BP_ALL_BITS),
+		m_slack(MT_Scalar(0.0)),
+		m_velocity(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0)),
+		m_updated(0),
+		m_skipped(0)
 	{
 		m_xform.setIdentity();
 		if (m_shape.getType() == COMPLEX)
@@ -67,6 +107,36 @@ public:
 		setBBox();
 	}
 
+	// Replaces the proxies of the object, so the overlaps of the object 
+	// end and begin again.
+	void setStatic(bool is_static);
+	bool isStatic() const { return m_static; }
+
+	void setFilter(DT_Mask category, DT_Mask mask);
+	DT_Mask getCategory() const { return m_category; }
+	DT_Mask getMask() const { return m_mask; }
+
+	// Creates a proxy with the box, filter and static flag of the object.
+	BP_ProxyHandle createProxy(BP_SceneHandle scene);
+
+	// The broad phase gets the box of the object enlarged by the slack and 
+	// stretched along the velocity. The box in the broad phase is updated 
+	// only when the actual box leaves it.
+	void setSlack(MT_Scalar slack) 
+	{
+		m_slack = slack;
+		fattenBBox();
+	}
+
+	void setVelocity(const MT_Vector3& velocity) 
+	{
+		m_velocity = velocity;
+		fattenBBox();
+	}
+
+	DT_Count getUpdated() const { return m_updated; }
+	DT_Count getSkipped() const { return m_skipped; }
+
 	void setScaling(const MT_Vector3& scaling)
 	{
         m_xform.scale(scaling);
@@ -112,6 +182,9 @@ public:
 	void setBBox();
 
 	const MT_BBox& getBBox() const { return m_bbox; }	
+
+	// The box of the object in the broad phase.
+	const MT_BBox& getFatBBox() const { return m_fatBBox; }	
 	
     DT_ResponseClass getResponseClass() const { return m_responseClass; }
     
@@ -127,40 +200,91 @@ public:
 	bool ray_cast(const MT_Point3& source, const MT_Point3& target, 
 				  MT_Scalar& param, MT_Vector3& normal) const; 
 
-	void addProxy(BP_ProxyHandle proxy) { m_proxies.push_back(proxy); }
+	// The proxies are kept per scene. An object is in few scenes, so finding
+	// the proxy of a scene takes constant time.
+	void addProxy(BP_SceneHandle scene, BP_ProxyHandle proxy) 
+	{ 
+		m_proxies.push_back(std::make_pair(scene, proxy)); 
+	}
 
-	void removeProxy(BP_ProxyHandle proxy) 
+	// Returns the proxy of the object in 'scene', or 0 if the object is not in
+	// the scene.
+	BP_ProxyHandle removeProxy(BP_SceneHandle scene) 
 	{ 
-		T_ProxyList::iterator it = std::find(m_proxies.begin(), m_proxies.end(), proxy);
-		if (it != m_proxies.end()) {
-			m_proxies.erase(it);
+		T_ProxyList::iterator it;
+		for (it = m_proxies.begin(); it != m_proxies.end(); ++it) 
+		{
+			if ((*it).first == scene)
+			{
+				BP_ProxyHandle proxy = (*it).second;
+				*it = m_proxies.back();
+				m_proxies.pop_back();
+				return proxy;
+			}
 		}
+		return 0;
 	}
 
 
-	friend bool intersect(const DT_Object&, const DT_Object&, MT_Vector3& v);
+	friend bool intersect(const DT_Object&, const DT_Object&, MT_Vector3& v, 
+						  DT_SimplexCache *);
 	
 	friend bool common_point(const DT_Object&, const DT_Object&, MT_Vector3&, 
-							 MT_Point3&, MT_Point3&);
+							 MT_Point3&, MT_Point3&, DT_SimplexCache *);
 	
 	friend bool penetration_depth(const DT_Object&, const DT_Object&, 
-								  MT_Vector3&, MT_Point3&, MT_Point3&);
+								  MT_Vector3&, MT_Point3&, MT_Point3&, 
+								  DT_SimplexCache *, DT_Accuracy::DepthMethod);
 	
 	friend MT_Scalar closest_points(const DT_Object&, const DT_Object&, 
 									MT_Point3&, MT_Point3&);
 
+	friend class DT_Batch;
+
 private:
-	typedef std::vector<BP_ProxyHandle> T_ProxyList;
+	typedef std::vector<std::pair<BP_SceneHandle, BP_ProxyHandle> > T_ProxyList;
+
+	bool isLoose() const 
+	{
+		return m_slack != MT_Scalar(0.0) || m_velocity.length2() != MT_Scalar(0.0);
+	}
+
+	// Computes the box in the broad phase from the actual box, and passes 
+	// it to the proxies.
+	void fattenBBox();
 
 	void              *m_client_object;
 	DT_ResponseClass   m_responseClass;
     const DT_Shape&    m_shape;
     MT_Scalar          m_margin;
+	bool               m_static;
+	DT_Mask            m_category;
+	DT_Mask            m_mask;
+	MT_Scalar          m_slack;
+	MT_Vector3         m_velocity;
+	DT_Count           m_updated;
+	DT_Count           m_skipped;
 	MT_Transform       m_xform;
 	T_ProxyList		   m_proxies;
 	MT_BBox            m_bbox;
+	MT_BBox            m_fatBBox;
 };
 
+// Without a cache, the tests start from the separating axis 'v' only.
+
+bool intersect(const DT_Object& a, const DT_Object& b, MT_Vector3& v, 
+			   DT_SimplexCache *cache = 0);
+
+bool common_point(const DT_Object& a, const DT_Object& b, MT_Vector3& v, 
+				  MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache = 0);
+
+// The depth of a sphere and a sphere, box or line segment has a closed 
+// form, so 'method' applies to the other pairs only.
+
+bool penetration_depth(const DT_Object& a, const DT_Object& b, MT_Vector3& v, 
+					   MT_Point3& pa, MT_Point3& pb, DT_SimplexCache *cache = 0,
+					   DT_Accuracy::DepthMethod method = DT_Accuracy::EPA);
+
 #endif
 
 
@@ -42,7 +42,7 @@ public:
         if (response.getType() != DT_NO_RESPONSE) 
 		{
             push_back(response);
-            GEN_set_max(m_type, response.getType());
+            combine(response.getType());
         }
     }
 
@@ -55,7 +55,7 @@ public:
 			m_type = DT_NO_RESPONSE;
 			for (it = begin(); it != end(); ++it) 
 			{
-				GEN_set_max(m_type, (*it).getType());
+				combine((*it).getType());
 			}
 		}
     }
@@ -84,6 +84,22 @@ public:
     }
     
 private:
+	// The type of a list is the type of the response that needs the most 
+	// collision data. An exact depth serves the approximate depth responses 
+	// as well, so DT_DEPTH_RESPONSE wins over DT_APPROX_DEPTH_RESPONSE.
+	static int rank(DT_ResponseType type)
+	{
+		return type == DT_DEPTH_RESPONSE ? DT_APPROX_DEPTH_RESPONSE + 1 : type;
+	}
+
+	void combine(DT_ResponseType type)
+	{
+		if (rank(type) > rank(m_type))
+		{
+			m_type = type;
+		}
+	}
+
 	DT_ResponseType    m_type;
 };
 
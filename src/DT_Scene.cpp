@@ -24,32 +24,10 @@
 #include "DT_Scene.h"
 #include "DT_Object.h"
 #include "DT_Convex.h"
+#include "DT_RespTable.h"
 
 //#define DEBUG
 
-static void beginOverlap(void *client_data, void *object1, void *object2) 
-{
-	DT_Encounter e(reinterpret_cast<DT_Object *>(object1), reinterpret_cast<DT_Object *>(object2));
-
-#ifdef DEBUG	
-	std::cout << "Begin: " << e << std::endl; 
-#endif
-
-	reinterpret_cast<DT_Scene *>(client_data)->addEncounter(e);
-}
-
-
-static void endOverlap(void *client_data, void *object1, void *object2) 
-{
-	DT_Encounter e((DT_Object *)object1, (DT_Object *)object2);
-
-#ifdef DEBUG
-	std::cout << "End:   " << e << std::endl; 
-#endif
-	
-	reinterpret_cast<DT_Scene *>(client_data)->removeEncounter(e);
-}
-
 struct DT_RayCastData {
 	DT_RayCastData(const void *ignore) 
 	  : m_ignore(ignore) 
@@ -80,23 +58,88 @@ static bool objectRayCast(void *client_data,
 	return false;
 }
 
-DT_Scene::DT_Scene() 
-	: m_broadphase(BP_CreateScene(this, &beginOverlap, &endOverlap)),
-	  m_state(0x0)
-{}
+struct DT_QueryData {
+	DT_QueryData(const MT_BBox& bbox, DT_QueryCallback callback, void *client_data) 
+	  : m_bbox(bbox),
+		m_callback(callback),
+		m_client_data(client_data),
+		m_count(0)
+	{}
+
+	MT_BBox           m_bbox;
+	DT_QueryCallback  m_callback;
+	void             *m_client_data;
+	DT_Count          m_count;
+};
+
+// The broad phase holds the loose boxes of the objects, so the actual box 
+// is tested here.
+static void objectQuery(void *client_data, void *object) 
+{
+	DT_QueryData *data = static_cast<DT_QueryData *>(client_data); 
+	if (((DT_Object *)object)->getBBox().overlaps(data->m_bbox))
+	{
+		(*data->m_callback)(data->m_client_data, ((DT_Object *)object)->getClientObject());
+		++data->m_count;
+	}
+}
+
+DT_Scene::DT_Scene(DT_BroadPhase type) 
+	: m_broadphase(BP_CreateSceneOfType(type == DT_DYNAMIC_TREE ? BP_DYNAMIC_TREE : BP_SWEEP_AND_PRUNE,
+										this, 0, 0)),
+	  m_state(0x0),
+	  m_simplexCaching(false),
+	  m_simplexHits(0),
+	  m_simplexMisses(0),
+	  m_simplexIterations(0),
+	  m_batching(false)
+{
+	// The overlap changes are applied in bulk, so a pair that begins and ends 
+	// between two tests never touches the encounter table.
+	BP_SetReportMode(m_broadphase, BP_REPORT_DELTA);
+}
 
 DT_Scene::~DT_Scene()
 {
 	BP_DestroyScene(m_broadphase);
 }
 
+void DT_Scene::applyPairDelta()
+{
+	const BP_Pair *begins, *ends;
+	DT_Count num_begins, num_ends;
+	BP_GetPairDelta(m_broadphase, &begins, &num_begins, &ends, &num_ends);
+
+	DT_Index i;
+	for (i = 0; i != num_ends; ++i)
+	{
+		DT_Encounter e((DT_Object *)ends[i].object1, (DT_Object *)ends[i].object2);
+
+#ifdef DEBUG
+		std::cout << "End:   " << e << std::endl; 
+#endif
+
+		removeEncounter(e);
+	}
+
+	m_encounterTable.reserve(m_encounterTable.size() + num_begins);
+
+	for (i = 0; i != num_begins; ++i)
+	{
+		DT_Encounter e((DT_Object *)begins[i].object1, (DT_Object *)begins[i].object2);
+
+#ifdef DEBUG	
+		std::cout << "Begin: " << e << std::endl; 
+#endif
+
+		addEncounter(e);
+	}
+}
+
 void DT_Scene::addObject(DT_Object &object)
 {
-	const MT_BBox& bbox = object.getBBox();
-	DT_Vector3 min, max;
-	bbox.getMin().getValue(min);
-	bbox.getMax().getValue(max);
-    BP_ProxyHandle proxy = BP_CreateProxy(m_broadphase, &object, min, max);
+    BP_ProxyHandle proxy = object.createProxy(m_broadphase);
+	applyPairDelta();
 	
 #ifdef DEBUG
 	DT_EncounterTable::iterator it;	
@@ -106,26 +149,70 @@ void DT_Scene::addObject(DT_Object &object)
 	}
 	std::cout << std::endl;
 #endif
-	object.addProxy(proxy);
-    m_objectList.push_back(std::make_pair(&object, proxy));
+	object.addProxy(m_broadphase, proxy);
 }
 
 
 
-void DT_Scene::removeObject(DT_Object& object)
+void DT_Scene::addObjects(DT_Count count, DT_Object *const *objects)
 {
-    T_ObjectList::iterator it = m_objectList.begin();
+	// Static objects are added one by one. The others are added in bulk.
+	std::vector<DT_Object *> moving;
+	moving.reserve(count);
+	DT_Count i;
+	for (i = 0; i != count; ++i)
+	{
+		if (objects[i]->isStatic())
+		{
+			addObject(*objects[i]);
+		}
+		else
+		{
+			moving.push_back(objects[i]);
+		}
+	}
 
-    while (it != m_objectList.end() && &object != (*it).first)
+	count = DT_Count(moving.size());
+	if (count == 0)
 	{
-        ++it;
-    }
+		return;
+	}
 
-    if (it != m_objectList.end())
+	std::vector<void *> clients(count);
+	std::vector<DT_Scalar> min(3 * count), max(3 * count);
+	std::vector<DT_Mask> categories(count), masks(count);
+	for (i = 0; i != count; ++i)
 	{
-		object.removeProxy((*it).second);
-        BP_DestroyProxy(m_broadphase, (*it).second);
-		m_objectList.erase(it);
+		const MT_BBox& bbox = moving[i]->getFatBBox();
+		bbox.getMin().getValue(&min[3 * i]);
+		bbox.getMax().getValue(&max[3 * i]);
+		categories[i] = moving[i]->getCategory();
+		masks[i] = moving[i]->getMask();
+		clients[i] = moving[i];
+	}
+
+	std::vector<BP_ProxyHandle> proxies(count);
+	BP_CreateProxies(m_broadphase, count, &clients[0], 
+					 reinterpret_cast<const DT_Vector3 *>(&min[0]), 
+					 reinterpret_cast<const DT_Vector3 *>(&max[0]), 
+					 &categories[0], &masks[0],
+					 &proxies[0]);
+	
+	for (i = 0; i != count; ++i)
+	{
+		moving[i]->addProxy(m_broadphase, proxies[i]);
+	}
+	applyPairDelta();
+}
+
+void DT_Scene::removeObject(DT_Object& object)
+{
+	BP_ProxyHandle proxy = object.removeProxy(m_broadphase);
+
+    if (proxy)
+	{
+        BP_DestroyProxy(m_broadphase, proxy);
+		applyPairDelta();
 
 #ifdef DEBUG
 		std::cout << "Remove " << &object << ':';
@@ -141,20 +228,72 @@ void DT_Scene::removeObject(DT_Object& object)
     }
 }
 
+void DT_Scene::removeObjects(DT_Count count, DT_Object *const *objects)
+{
+	std::vector<BP_ProxyHandle> proxies;
+	proxies.reserve(count);
+	DT_Count i;
+	for (i = 0; i != count; ++i)
+	{
+		BP_ProxyHandle proxy = objects[i]->removeProxy(m_broadphase);
+		if (proxy)
+		{
+			proxies.push_back(proxy);
+		}
+	}
+
+	if (!proxies.empty())
+	{
+		BP_DestroyProxies(m_broadphase, DT_Count(proxies.size()), &proxies[0]);
+		applyPairDelta();
+	}
+}
+
+void DT_Scene::endUpdate()
+{
+	BP_EndUpdate(m_broadphase);
+	applyPairDelta();
+}
 
 
+
+void DT_Scene::countSimplex(const DT_Encounter& e)
+{
+	const DT_SimplexCache& cache = e.simplexCache();
+	if (cache.m_start == DT_Simplex::WARM)
+	{
+		++m_simplexHits;
+	}
+	else if (cache.m_start == DT_Simplex::COLD)
+	{
+		++m_simplexMisses;
+	}
+	m_simplexIterations += cache.m_iterations;
+}
+
 int DT_Scene::handleCollisions(const DT_RespTable *respTable)
 {
     int count = 0;
 
     assert(respTable);
 
+	if (m_batching)
+	{
+		return handleCollisions(respTable, 1);
+	}
+
+	applyPairDelta();
 	m_state |= TESTING;
 
 	DT_EncounterTable::iterator it;	
 	for (it = m_encounterTable.begin(); it != m_encounterTable.end(); ++it)
 	{
-		if ((*it).exactTest(respTable, count))
+		DT_Bool done = (*it).exactTest(respTable, count, m_simplexCaching);
+		if (m_simplexCaching)
+		{
+			countSimplex(*it);
+		}
+		if (done)
 		{
 			break;
         }
@@ -165,6 +304,167 @@ int DT_Scene::handleCollisions(const DT_RespTable *respTable)
     return count;
 }
 
+void DT_Scene::collide(void *client_data, DT_Index i)
+{
+	DT_Scene& scene = *(DT_Scene *)client_data;
+	if (i < scene.m_batch.numBatches())
+	{
+		scene.m_batch.run(i, scene.m_simplexCaching);
+		return;
+	}
+
+	// The result holds the type of the response until the test is run.
+	DT_Index k = scene.m_pending[i - scene.m_batch.numBatches()];
+	T_Result& result = scene.m_results[k];
+	
+	result.m_type = scene.m_encounterTable[k].collide(result.m_type, result.m_coll_data, 
+													  scene.m_simplexCaching);
+}
+
+void DT_Scene::collideAll(const DT_RespTable *respTable, DT_Count num_threads)
+{
+	m_results.resize(m_encounterTable.size());
+
+	m_pending.clear();
+	DT_Index i;
+	for (i = 0; i != m_encounterTable.size(); ++i)
+	{
+		const DT_Encounter& e = m_encounterTable[i];
+		DT_ResponseType type = respTable->find(e.first(), e.second()).getType();
+		m_results[i].m_type = type;
+		if (!(m_batching && m_batch.add(e, type, i)))
+		{
+			m_pending.push_back(i);
+		}
+	}
+	m_batch.close();
+
+	m_workerPool.resize(num_threads - 1);
+	m_workerPool.run(m_batch.numBatches() + DT_Count(m_pending.size()), &DT_Scene::collide, this);
+
+	for (i = 0; i != m_batch.size(); ++i)
+	{
+		m_results[m_batch.getIndex(i)].m_type = m_batch.getType(i);
+	}
+
+	if (m_simplexCaching)
+	{
+		for (i = 0; i != m_encounterTable.size(); ++i)
+		{
+			countSimplex(m_encounterTable[i]);
+		}
+	}
+}
+
+int DT_Scene::handleCollisions(const DT_RespTable *respTable, DT_Count num_threads)
+{
+    int count = 0;
+
+    assert(respTable);
+	assert(num_threads != 0);
+
+	applyPairDelta();
+	m_state |= TESTING;
+
+	// The narrow phase runs on all threads; the responses are called from 
+	// this thread in the same order as in the serial version.
+	collideAll(respTable, num_threads);
+
+	DT_Index i;
+	for (i = 0; i != m_encounterTable.size(); ++i)
+	{
+		if (m_results[i].m_type != DT_NO_RESPONSE)
+		{
+			++count;
+			if (m_encounterTable[i].respond(respTable, m_results[i].m_type, m_results[i].m_coll_data))
+			{
+				break;
+			}
+		}
+	}
+
+	m_state &= ~TESTING;
+
+    return count;
+}
+
+int DT_Scene::collectCollisions(const DT_RespTable *respTable, DT_ContactBuffer& buffer)
+{
+    int count = 0;
+
+    assert(respTable);
+
+	applyPairDelta();
+	m_state |= TESTING;
+
+	// A buffer created by the library owns a vector that grows as needed.
+	std::vector<DT_Contact> *storage = (std::vector<DT_Contact> *)buffer.storage;
+	if (storage)
+	{
+		storage->clear();
+	}
+	buffer.count = 0;
+
+	if (m_batching)
+	{
+		collideAll(respTable, 1);
+	}
+
+	DT_Index i;
+	for (i = 0; i != m_encounterTable.size(); ++i)
+	{
+		const DT_Encounter& e = m_encounterTable[i];
+		DT_CollData coll_data;
+		DT_ResponseType type;
+		if (m_batching)
+		{
+			type = m_results[i].m_type;
+			coll_data = m_results[i].m_coll_data;
+		}
+		else
+		{
+			type = e.collide(respTable, coll_data, m_simplexCaching);
+			if (m_simplexCaching)
+			{
+				countSimplex(e);
+			}
+		}
+		
+		if (type != DT_NO_RESPONSE)
+		{
+			++count;
+			if (storage)
+			{
+				storage->push_back(DT_Contact());
+				e.getContact(respTable, type, coll_data, storage->back());
+			}
+			else if (buffer.count != buffer.capacity)
+			{
+				e.getContact(respTable, type, coll_data, buffer.contacts[buffer.count++]);
+			}
+		}
+	}
+
+	if (storage)
+	{
+		buffer.contacts = storage->empty() ? 0 : &(*storage)[0];
+		buffer.capacity = storage->capacity();
+		buffer.count = storage->size();
+	}
+
+	m_state &= ~TESTING;
+
+    return count;
+}
+
+DT_Count DT_Scene::queryBox(const DT_Vector3 min, const DT_Vector3 max,
+							DT_QueryCallback callback, void *client_data) const 
+{
+	DT_QueryData data(MT_BBox(MT_Point3(min), MT_Point3(max)), callback, client_data);
+	BP_QueryBox(m_broadphase, min, max, &objectQuery, &data);
+	return data.m_count;
+}
+
 void *DT_Scene::rayCast(const void *ignore_client,
 						const DT_Vector3 source, const DT_Vector3 target, 
 						DT_Scalar& lambda, DT_Vector3 normal) const 
@@ -27,7 +27,9 @@
 #include <vector>
 
 #include "SOLID_broad.h"
-#include "DT_Encounter.h"
+#include "DT_EncounterTable.h"
+#include "DT_WorkerPool.h"
+#include "DT_Batch.h"
 
 class DT_Object;
 class DT_RespTable;
@@ -35,11 +37,13 @@ class DT_RespTable;
 class DT_Scene {
 	enum { TESTING = 0x4 };
 public:
-    DT_Scene();
+    DT_Scene(DT_BroadPhase type = DT_SWEEP_AND_PRUNE);
     ~DT_Scene();
 
     void addObject(DT_Object& object);
+    void addObjects(DT_Count count, DT_Object *const *objects);
     void removeObject(DT_Object& object);
+    void removeObjects(DT_Count count, DT_Object *const *objects);
 
     void addEncounter(const DT_Encounter& e)
     {
@@ -59,19 +63,74 @@ public:
 
 
 
+	void beginUpdate() { BP_BeginUpdate(m_broadphase); }
+	void endUpdate();
+	bool isUpdating() const { return BP_IsUpdating(m_broadphase); }
+
+	// With simplex caching on, the encounters keep the last simplex of GJK, 
+	// and the next test starts from it. The counts are kept from then on.
+	void setSimplexCaching(bool enable) { m_simplexCaching = enable; }
+	void getSimplexStats(DT_Count& hits, DT_Count& misses, DT_Count& iterations) const
+	{
+		hits = m_simplexHits;
+		misses = m_simplexMisses;
+		iterations = m_simplexIterations;
+	}
+
+	// With batching on, the tests of pairs of spheres and boxes with a simple
+	// response run in SIMD batches, and all pairs are tested before the first
+	// response is called, as with multiple threads. Without SIMD lanes, 
+	// batching stays off.
+#ifdef DT_SIMD_LANES
+	void setBatching(bool enable) { m_batching = enable; }
+#else
+	void setBatching(bool) {}
+#endif
+
     int  handleCollisions(const DT_RespTable *respTable);
+    int  handleCollisions(const DT_RespTable *respTable, DT_Count num_threads);
+    int  collectCollisions(const DT_RespTable *respTable, DT_ContactBuffer& buffer);
 
 	void *rayCast(const void *ignore_client, 
 				  const DT_Vector3 source, const DT_Vector3 target, 
 				  DT_Scalar& lambda, DT_Vector3 normal) const;
 
+	DT_Count queryBox(const DT_Vector3 min, const DT_Vector3 max,
+					  DT_QueryCallback callback, void *client_data) const;
+
 private:
-	typedef std::vector<std::pair<DT_Object *, BP_ProxyHandle> > T_ObjectList;
+	struct T_Result {
+		DT_ResponseType  m_type;
+		DT_CollData      m_coll_data;
+	};
+
+	static void collide(void *client_data, DT_Index i);
+
+	// Tests all encounters into m_results, on num_threads threads. The 
+	// batches run first, then the encounters without a batched test.
+	void collideAll(const DT_RespTable *respTable, DT_Count num_threads);
+
+	// Applies the pairs that began or ended overlapping in the broad phase 
+	// since the last call to the encounter table.
+	void applyPairDelta();
+
+	void countSimplex(const DT_Encounter& e);
 
 	BP_SceneHandle      m_broadphase;
-	T_ObjectList        m_objectList;
     DT_EncounterTable   m_encounterTable;
 	unsigned int        m_state;
+
+	bool                m_simplexCaching;
+	DT_Count            m_simplexHits;
+	DT_Count            m_simplexMisses;
+	DT_Count            m_simplexIterations;
+
+	bool                m_batching;
+	DT_Batch            m_batch;
+	std::vector<DT_Index>  m_pending;
+
+	DT_WorkerPool                        m_workerPool;
+	std::vector<T_Result>                m_results;
 };
 
 #endif
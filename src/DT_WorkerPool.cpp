@@ -0,0 +1,159 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "DT_WorkerPool.h"
+
+#include <assert.h>
+
+// Indices are handed out in small batches to keep the contention on 
+// m_next low while still balancing pairs of very different cost.
+static const DT_Count BatchSize = 8;
+
+DT_WorkerPool::DT_WorkerPool()
+  : m_generation(0),
+	m_busy(0),
+	m_quit(false),
+	m_job(0),
+	m_client_data(0),
+	m_count(0),
+	m_next(0)
+{}
+
+DT_WorkerPool::~DT_WorkerPool()
+{
+	stop();
+}
+
+void DT_WorkerPool::resize(DT_Count num_workers)
+{
+	if (num_workers != m_workers.size())
+	{
+		stop();
+		m_quit = false;
+
+		DT_Index i;
+		for (i = 0; i != num_workers; ++i)
+		{
+			m_workers.push_back(std::thread(&DT_WorkerPool::loop, this, m_generation));
+		}
+	}
+}
+
+void DT_WorkerPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_start.notify_all();
+
+	std::vector<std::thread>::iterator it;
+	for (it = m_workers.begin(); it != m_workers.end(); ++it)
+	{
+		(*it).join();
+	}
+	m_workers.clear();
+}
+
+void DT_WorkerPool::run(DT_Count count, Job job, void *client_data)
+{
+	if (m_workers.empty() || count <= BatchSize)
+	{
+		DT_Index i;
+		for (i = 0; i != count; ++i)
+		{
+			(*job)(client_data, i);
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_job = job;
+		m_client_data = client_data;
+		m_count = count;
+		m_next = 0;
+		m_busy = m_workers.size();
+		++m_generation;
+	}
+	m_start.notify_all();
+
+	work();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_busy != 0)
+	{
+		m_done.wait(lock);
+	}
+}
+
+void DT_WorkerPool::work()
+{
+	for (;;)
+	{
+		DT_Index first = m_next.fetch_add(BatchSize);
+		if (first >= m_count)
+		{
+			break;
+		}
+
+		DT_Index last = first + BatchSize < m_count ? first + BatchSize : m_count;
+		DT_Index i;
+		for (i = first; i != last; ++i)
+		{
+			(*m_job)(m_client_data, i);
+		}
+	}
+}
+
+void DT_WorkerPool::loop(unsigned int generation)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (!m_quit && generation == m_generation)
+			{
+				m_start.wait(lock);
+			}
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+		}
+
+		work();
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			assert(m_busy != 0);
+			last = --m_busy == 0;
+		}
+		if (last)
+		{
+			m_done.notify_one();
+		}
+	}
+}
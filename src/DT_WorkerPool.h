@@ -0,0 +1,75 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_WORKERPOOL_H
+#define DT_WORKERPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "SOLID_types.h"
+
+// A small pool of worker threads for running the same job on a range of 
+// indices. The calling thread takes part in the work, so a pool of n - 1 
+// workers keeps n threads busy.
+
+class DT_WorkerPool {
+public:
+	typedef void (*Job)(void *client_data, DT_Index i);
+
+	DT_WorkerPool();
+	~DT_WorkerPool();
+
+	void resize(DT_Count num_workers);
+	DT_Count size() const { return m_workers.size(); }
+
+	// Calls job(client_data, i) for i in [0, count) and returns when all 
+	// calls have finished. 
+	void run(DT_Count count, Job job, void *client_data);
+
+private:
+	DT_WorkerPool(const DT_WorkerPool&);
+	DT_WorkerPool& operator=(const DT_WorkerPool&);
+
+	void work();
+	void loop(unsigned int generation);
+	void stop();
+
+	std::vector<std::thread>  m_workers;
+	std::mutex                m_mutex;
+	std::condition_variable   m_start;
+	std::condition_variable   m_done;
+	unsigned int              m_generation;
+	DT_Count                  m_busy;
+	bool                      m_quit;
+
+	Job                       m_job;
+	void                     *m_client_data;
+	DT_Count                  m_count;
+	std::atomic<DT_Index>     m_next;
+};
+
+#endif
@@ -25,20 +25,39 @@
 
 #include "BP_Scene.h"
 #include "BP_Proxy.h"
+#include "BP_TreeScene.h"
 
 BP_SceneHandle BP_CreateScene(void *client_data,
 							  BP_Callback beginOverlap,
 							  BP_Callback endOverlap)
 {
-	return (BP_SceneHandle)new BP_Scene(client_data, 
-										beginOverlap, 
-										endOverlap);
+	return BP_CreateSceneOfType(BP_SWEEP_AND_PRUNE, 
+								client_data, 
+								beginOverlap, 
+								endOverlap);
+}
+
+BP_SceneHandle BP_CreateSceneOfType(BP_SceneType type,
+									void *client_data,
+									BP_Callback beginOverlap,
+									BP_Callback endOverlap)
+{
+	BP_SceneBase *scene;
+	if (type == BP_DYNAMIC_TREE)
+	{
+		scene = new BP_TreeScene(client_data, beginOverlap, endOverlap);
+	}
+	else
+	{
+		scene = new BP_Scene(client_data, beginOverlap, endOverlap);
+	}
+	return (BP_SceneHandle)scene;
 }
 
  
 void BP_DestroyScene(BP_SceneHandle scene)
 {
-	delete (BP_Scene *)scene;
+	delete (BP_SceneBase *)scene;
 }
 	
 
@@ -46,20 +65,105 @@ BP_ProxyHandle BP_CreateProxy(BP_SceneHandle scene, void *object,
 							  const DT_Vector3 min, const DT_Vector3 max)
 {
 	return (BP_ProxyHandle)
-		((BP_Scene *)scene)->createProxy(object, min, max);
+		((BP_SceneBase *)scene)->createProxy(object, min, max, 
+											 BP_ALL_BITS, BP_ALL_BITS);
+}
+
+BP_ProxyHandle BP_CreateFilteredProxy(BP_SceneHandle scene, void *object,
+									  const DT_Vector3 min, const DT_Vector3 max,
+									  DT_Mask category, DT_Mask mask)
+{
+	return (BP_ProxyHandle)
+		((BP_SceneBase *)scene)->createProxy(object, min, max, category, mask);
+}
+
+BP_ProxyHandle BP_CreateStaticProxy(BP_SceneHandle scene, void *object,
+									const DT_Vector3 min, const DT_Vector3 max,
+									DT_Mask category, DT_Mask mask)
+{
+	return (BP_ProxyHandle)
+		((BP_SceneBase *)scene)->createStaticProxy(object, min, max, category, mask);
+}
+
+void BP_CreateProxies(BP_SceneHandle scene, DT_Count count, void *const *objects,
+					  const DT_Vector3 *min, const DT_Vector3 *max, 
+					  const DT_Mask *categories, const DT_Mask *masks,
+					  BP_ProxyHandle *proxies)
+{
+	std::vector<DT_Mask> all_bits;
+	if (!categories || !masks)
+	{
+		all_bits.assign(count, BP_ALL_BITS);
+	}
+	((BP_SceneBase *)scene)->createProxies(count, objects, min, max, 
+										   categories ? categories : &all_bits[0],
+										   masks ? masks : &all_bits[0],
+										   (BP_ProxyBase **)proxies);
 }
 
 
 void BP_DestroyProxy(BP_SceneHandle scene, BP_ProxyHandle proxy) 
 {
-	((BP_Scene *)scene)->destroyProxy((BP_Proxy *)proxy);
+	((BP_SceneBase *)scene)->destroyProxy((BP_ProxyBase *)proxy);
+}
+
+void BP_DestroyProxies(BP_SceneHandle scene, DT_Count count, 
+					   const BP_ProxyHandle *proxies)
+{
+	((BP_SceneBase *)scene)->destroyProxies(count, 
+											(BP_ProxyBase *const *)proxies);
 }
 
 
 
 void BP_SetBBox(BP_ProxyHandle proxy, const DT_Vector3 min, const DT_Vector3 max)	
 {
-	((BP_Proxy *)proxy)->setBBox(min, max);
+	((BP_ProxyBase *)proxy)->setBBox(min, max);
+}
+
+void BP_SetProxyFilter(BP_SceneHandle scene, BP_ProxyHandle proxy, 
+					   DT_Mask category, DT_Mask mask)
+{
+	((BP_SceneBase *)scene)->setFilter((BP_ProxyBase *)proxy, category, mask);
+}
+
+void BP_BeginUpdate(BP_SceneHandle scene)
+{
+	((BP_SceneBase *)scene)->beginUpdate();
+}
+
+void BP_EndUpdate(BP_SceneHandle scene)
+{
+	((BP_SceneBase *)scene)->endUpdate();
+}
+
+DT_Bool BP_IsUpdating(BP_SceneHandle scene)
+{
+	return ((BP_SceneBase *)scene)->isUpdating();
+}
+
+void BP_SetUpdateMode(BP_SceneHandle scene, BP_UpdateMode mode)
+{
+	((BP_SceneBase *)scene)->setUpdateMode(mode);
+}
+
+void BP_SetReportMode(BP_SceneHandle scene, BP_ReportMode mode)
+{
+	((BP_SceneBase *)scene)->setReportMode(mode);
+}
+
+void BP_GetPairDelta(BP_SceneHandle scene,
+					 const BP_Pair **begins, DT_Count *num_begins,
+					 const BP_Pair **ends, DT_Count *num_ends)
+{
+	((BP_SceneBase *)scene)->getPairDelta(*begins, *num_begins, *ends, *num_ends);
+}
+
+DT_Count BP_QueryBox(BP_SceneHandle scene, 
+					 const DT_Vector3 min, const DT_Vector3 max,
+					 BP_QueryCallback callback, void *client_data)
+{
+	return ((BP_SceneBase *)scene)->queryBox(min, max, callback, client_data);
 }
 
 void *BP_RayCast(BP_SceneHandle scene, 
@@ -69,9 +173,9 @@ void *BP_RayCast(BP_SceneHandle scene,
 				 const DT_Vector3 target,
 				 DT_Scalar *lambda) 
 {
-	return ((BP_Scene *)scene)->rayCast(objectRayCast,
-										client_data,
-										source,	target,
-										*lambda);
+	return ((BP_SceneBase *)scene)->rayCast(objectRayCast,
+											client_data,
+											source,	target,
+											*lambda);
 }
 
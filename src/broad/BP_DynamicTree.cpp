@@ -0,0 +1,262 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "BP_DynamicTree.h"
+
+int BP_DynamicTree::allocateNode()
+{
+	int node;
+	if (m_free != NIL)
+	{
+		node = m_free;
+		m_free = m_nodes[node].m_parent;
+	}
+	else
+	{
+		node = int(m_nodes.size());
+		m_nodes.push_back(Node());
+	}
+	m_nodes[node].m_data = 0;
+	m_nodes[node].m_parent = NIL;
+	m_nodes[node].m_child[0] = NIL;
+	m_nodes[node].m_child[1] = NIL;
+	m_nodes[node].m_height = 0;
+	return node;
+}
+
+void BP_DynamicTree::freeNode(int node)
+{
+	m_nodes[node].m_parent = m_free;
+	m_free = node;
+}
+
+int BP_DynamicTree::insert(const BP_Box& box, void *data)
+{
+	int leaf = allocateNode();
+	m_nodes[leaf].m_box = box;
+	m_nodes[leaf].m_data = data;
+	insertLeaf(leaf);
+	return leaf;
+}
+
+void BP_DynamicTree::remove(int leaf)
+{
+	assert(m_nodes[leaf].isLeaf());
+	removeLeaf(leaf);
+	freeNode(leaf);
+}
+
+void BP_DynamicTree::move(int leaf, const BP_Box& box)
+{
+	assert(m_nodes[leaf].isLeaf());
+	removeLeaf(leaf);
+	m_nodes[leaf].m_box = box;
+	insertLeaf(leaf);
+}
+
+void BP_DynamicTree::insertLeaf(int leaf)
+{
+	if (m_root == NIL)
+	{
+		m_root = leaf;
+		m_nodes[leaf].m_parent = NIL;
+		return;
+	}
+
+	// Descend to the sibling for which the sum of the areas of the new 
+	// node and the enlargement of its ancestors is least.
+	const BP_Box box = m_nodes[leaf].m_box;
+	int sibling = m_root;
+	while (!m_nodes[sibling].isLeaf())
+	{
+		const Node& node = m_nodes[sibling];
+		BP_Box merged;
+		merged.merge(node.m_box, box);
+		DT_Scalar area = merged.area();
+
+		// The cost of making the leaf a sibling of this node, and the 
+		// enlargement of this node if the leaf goes further down.
+		DT_Scalar cost = DT_Scalar(2.0) * area;
+		DT_Scalar inherited = DT_Scalar(2.0) * (area - node.m_box.area());
+
+		DT_Scalar child_cost[2];
+		int i;
+		for (i = 0; i < 2; ++i)
+		{
+			const Node& child = m_nodes[node.m_child[i]];
+			merged.merge(child.m_box, box);
+			child_cost[i] = inherited + (child.isLeaf() ? merged.area() : merged.area() - child.m_box.area());
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1])
+		{
+			break;
+		}
+		sibling = node.m_child[child_cost[0] < child_cost[1] ? 0 : 1];
+	}
+
+	int old_parent = m_nodes[sibling].m_parent;
+	int parent = allocateNode();
+	Node& node = m_nodes[parent];
+	node.m_parent = old_parent;
+	node.m_box.merge(m_nodes[sibling].m_box, box);
+	node.m_height = m_nodes[sibling].m_height + 1;
+	node.m_child[0] = sibling;
+	node.m_child[1] = leaf;
+	m_nodes[sibling].m_parent = parent;
+	m_nodes[leaf].m_parent = parent;
+
+	if (old_parent != NIL)
+	{
+		Node& grand_parent = m_nodes[old_parent];
+		grand_parent.m_child[grand_parent.m_child[0] == sibling ? 0 : 1] = parent;
+	}
+	else
+	{
+		m_root = parent;
+	}
+
+	refit(parent);
+}
+
+void BP_DynamicTree::removeLeaf(int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NIL;
+		return;
+	}
+
+	int parent = m_nodes[leaf].m_parent;
+	int grand_parent = m_nodes[parent].m_parent;
+	int sibling = m_nodes[parent].m_child[m_nodes[parent].m_child[0] == leaf ? 1 : 0];
+
+	m_nodes[sibling].m_parent = grand_parent;
+	if (grand_parent != NIL)
+	{
+		Node& node = m_nodes[grand_parent];
+		node.m_child[node.m_child[0] == parent ? 0 : 1] = sibling;
+	}
+	else
+	{
+		m_root = sibling;
+	}
+	freeNode(parent);
+
+	refit(grand_parent);
+}
+
+// Restores the boxes and heights of the nodes on the path to the root, 
+// balancing the nodes on the way.
+void BP_DynamicTree::refit(int index)
+{
+	while (index != NIL)
+	{
+		index = balance(index);
+
+		Node& node = m_nodes[index];
+		const Node& left = m_nodes[node.m_child[0]];
+		const Node& right = m_nodes[node.m_child[1]];
+		node.m_box.merge(left.m_box, right.m_box);
+		node.m_height = 1 + (left.m_height > right.m_height ? left.m_height : right.m_height);
+
+		index = node.m_parent;
+	}
+}
+
+// If the heights of the children of a node differ by more than one, the 
+// higher child is rotated up. Of the children of the higher child, the lower 
+// one goes down to the node. If they are equally high, the one that gives 
+// the smaller box together with the other child of the node goes down. 
+// Returns the node that took the place of the given node.
+int BP_DynamicTree::balance(int a)
+{
+	Node& node_a = m_nodes[a];
+	if (node_a.isLeaf() || node_a.m_height < 2)
+	{
+		return a;
+	}
+
+	int diff = m_nodes[node_a.m_child[1]].m_height - m_nodes[node_a.m_child[0]].m_height;
+	if (-1 <= diff && diff <= 1)
+	{
+		return a;
+	}
+
+	// c is the higher child, on side i of a. b is the other child. 
+	int i = diff > 1 ? 1 : 0;
+	int b = node_a.m_child[1 - i];
+	int c = node_a.m_child[i];
+	Node& node_b = m_nodes[b];
+	Node& node_c = m_nodes[c];
+
+	// g goes down to a, f stays with c. 
+	int f = node_c.m_child[0];
+	int g = node_c.m_child[1];
+	bool swap;
+	if (m_nodes[f].m_height != m_nodes[g].m_height)
+	{
+		swap = m_nodes[f].m_height < m_nodes[g].m_height;
+	}
+	else
+	{
+		BP_Box box_f, box_g;
+		box_f.merge(node_b.m_box, m_nodes[f].m_box);
+		box_g.merge(node_b.m_box, m_nodes[g].m_box);
+		swap = box_f.area() < box_g.area();
+	}
+	if (swap)
+	{
+		int t = f;
+		f = g;
+		g = t;
+	}
+	Node& node_f = m_nodes[f];
+	Node& node_g = m_nodes[g];
+
+	// c takes the place of a, with a and f as children.
+	node_c.m_parent = node_a.m_parent;
+	if (node_c.m_parent != NIL)
+	{
+		Node& parent = m_nodes[node_c.m_parent];
+		parent.m_child[parent.m_child[0] == a ? 0 : 1] = c;
+	}
+	else
+	{
+		m_root = c;
+	}
+	node_c.m_child[0] = a;
+	node_c.m_child[1] = f;
+	node_a.m_parent = c;
+
+	// a keeps b and gets g in the place of c.
+	node_a.m_child[i] = g;
+	node_g.m_parent = a;
+
+	node_a.m_box.merge(node_b.m_box, node_g.m_box);
+	node_a.m_height = 1 + (node_b.m_height > node_g.m_height ? node_b.m_height : node_g.m_height);
+	node_c.m_box.merge(node_a.m_box, node_f.m_box);
+	node_c.m_height = 1 + (node_a.m_height > node_f.m_height ? node_a.m_height : node_f.m_height);
+
+	return c;
+}
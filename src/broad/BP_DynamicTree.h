@@ -0,0 +1,266 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef BP_DYNAMICTREE_H
+#define BP_DYNAMICTREE_H
+
+#include <assert.h>
+#include <float.h>
+
+#include <vector>
+
+#include "SOLID_types.h"
+
+class BP_Box {
+public:
+	BP_Box() {}
+	BP_Box(const DT_Vector3 min, const DT_Vector3 max)
+	{
+		int i;
+		for (i = 0; i < 3; ++i)
+		{
+			m_min[i] = min[i];
+			m_max[i] = max[i];
+		}
+	}
+
+	bool overlaps(const BP_Box& b) const
+	{
+		return m_min[0] <= b.m_max[0] && b.m_min[0] <= m_max[0] && 
+			   m_min[1] <= b.m_max[1] && b.m_min[1] <= m_max[1] &&
+			   m_min[2] <= b.m_max[2] && b.m_min[2] <= m_max[2];
+	}
+
+	bool contains(const BP_Box& b) const
+	{
+		return m_min[0] <= b.m_min[0] && b.m_max[0] <= m_max[0] && 
+			   m_min[1] <= b.m_min[1] && b.m_max[1] <= m_max[1] &&
+			   m_min[2] <= b.m_min[2] && b.m_max[2] <= m_max[2];
+	}
+
+	// Half the surface area. 
+	DT_Scalar area() const
+	{
+		DT_Scalar x = m_max[0] - m_min[0];
+		DT_Scalar y = m_max[1] - m_min[1];
+		DT_Scalar z = m_max[2] - m_min[2];
+		return x * y + y * z + z * x;
+	}
+
+	void merge(const BP_Box& a, const BP_Box& b)
+	{
+		int i;
+		for (i = 0; i < 3; ++i)
+		{
+			m_min[i] = a.m_min[i] < b.m_min[i] ? a.m_min[i] : b.m_min[i];
+			m_max[i] = a.m_max[i] > b.m_max[i] ? a.m_max[i] : b.m_max[i];
+		}
+	}
+
+	void fatten(DT_Scalar margin)
+	{
+		int i;
+		for (i = 0; i < 3; ++i)
+		{
+			m_min[i] -= margin;
+			m_max[i] += margin;
+		}
+	}
+
+	// Clips the parameter interval [0, lambda] of the ray source + t * delta
+	// against the box. Returns false if the ray misses the box in the interval. 
+	bool clip(const DT_Vector3 source, const DT_Vector3 delta, DT_Scalar lambda) const
+	{
+		DT_Scalar lo = DT_Scalar(0.0);
+		DT_Scalar hi = lambda;
+		int i;
+		for (i = 0; i < 3; ++i)
+		{
+			if (delta[i] == DT_Scalar(0.0))
+			{
+				if (source[i] < m_min[i] || m_max[i] < source[i])
+				{
+					return false;
+				}
+			}
+			else
+			{
+				DT_Scalar t1 = (m_min[i] - source[i]) / delta[i];
+				DT_Scalar t2 = (m_max[i] - source[i]) / delta[i];
+				if (t2 < t1)
+				{
+					DT_Scalar t = t1;
+					t1 = t2;
+					t2 = t;
+				}
+				if (lo < t1) 
+				{
+					lo = t1;
+				}
+				if (t2 < hi) 
+				{
+					hi = t2;
+				}
+				if (hi < lo)
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	DT_Scalar m_min[3];
+	DT_Scalar m_max[3];
+};
+
+// A binary tree of boxes that is updated incrementally. Leaves are inserted 
+// next to the sibling that gives the least increase in surface area, and 
+// the tree is kept balanced by rotating nodes on the path to the root, as 
+// in an AVL tree. The nodes are stored in an array; removed nodes are kept 
+// in a free list.
+
+class BP_DynamicTree {
+public:
+	enum { NIL = -1 };
+
+	BP_DynamicTree() : m_root(NIL), m_free(NIL) {}
+
+	int  insert(const BP_Box& box, void *data);
+	void remove(int leaf);
+
+	// Moves a leaf to a new box. The leaf keeps its index.
+	void move(int leaf, const BP_Box& box);
+
+	bool empty() const { return m_root == NIL; }
+
+	const BP_Box& getBox(int node) const { return m_nodes[node].m_box; }
+	void *getData(int leaf) const { return m_nodes[leaf].m_data; }
+
+	// Calls callback(data) for each leaf whose box overlaps the given box.
+	template <typename Callback>
+	void query(const BP_Box& box, Callback& callback) const;
+
+	// Calls callback(data, lambda) for each leaf whose box is hit by the 
+	// ray from source to source + lambda * (target - source). The callback
+	// may shorten the ray by lowering lambda.
+	template <typename Callback>
+	void rayCast(const DT_Vector3 source, const DT_Vector3 target, 
+				 DT_Scalar& lambda, Callback& callback) const;
+
+private:
+	struct Node {
+		bool isLeaf() const { return m_child[0] == NIL; }
+
+		BP_Box  m_box;
+		void   *m_data;
+		int     m_parent;  // the next free node if the node is free
+		int     m_child[2];
+		int     m_height;
+	};
+
+	int  allocateNode();
+	void freeNode(int node);
+
+	void insertLeaf(int leaf);
+	void removeLeaf(int leaf);
+	void refit(int node);
+	int  balance(int node);
+
+	// The traversals keep their stacks on the call stack, so that several 
+	// threads can query the tree at once. A tree of height MAX_HEIGHT that 
+	// is balanced as an AVL tree has over a billion leaves.
+	enum { MAX_HEIGHT = 64 };
+
+	std::vector<Node>  m_nodes;
+	int                m_root;
+	int                m_free;
+};
+
+template <typename Callback>
+void BP_DynamicTree::query(const BP_Box& box, Callback& callback) const
+{
+	if (m_root == NIL)
+	{
+		return;
+	}
+
+	assert(m_nodes[m_root].m_height < MAX_HEIGHT);
+	int stack[MAX_HEIGHT + 1];
+	int top = 0;
+	stack[top++] = m_root;
+	while (top != 0)
+	{
+		const Node& node = m_nodes[stack[--top]];
+		if (node.m_box.overlaps(box))
+		{
+			if (node.isLeaf())
+			{
+				callback(node.m_data);
+			}
+			else
+			{
+				stack[top++] = node.m_child[1];
+				stack[top++] = node.m_child[0];
+			}
+		}
+	}
+}
+
+template <typename Callback>
+void BP_DynamicTree::rayCast(const DT_Vector3 source, const DT_Vector3 target, 
+							 DT_Scalar& lambda, Callback& callback) const
+{
+	if (m_root == NIL)
+	{
+		return;
+	}
+
+	DT_Vector3 delta;
+	delta[0] = target[0] - source[0];
+	delta[1] = target[1] - source[1];
+	delta[2] = target[2] - source[2];
+
+	assert(m_nodes[m_root].m_height < MAX_HEIGHT);
+	int stack[MAX_HEIGHT + 1];
+	int top = 0;
+	stack[top++] = m_root;
+	while (top != 0)
+	{
+		const Node& node = m_nodes[stack[--top]];
+		if (node.m_box.clip(source, delta, lambda))
+		{
+			if (node.isLeaf())
+			{
+				callback(node.m_data, lambda);
+			}
+			else
+			{
+				stack[top++] = node.m_child[1];
+				stack[top++] = node.m_child[0];
+			}
+		}
+	}
+}
+
+#endif
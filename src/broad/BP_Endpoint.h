@@ -28,6 +28,11 @@
 
 class BP_Proxy;
 
+typedef unsigned int Uint32;
+
+// The link of an endpoint is kept in the proxy. Besides the place of the 
+// endpoint in its list, it holds a copy of the key, so that the proxy has 
+// its box at hand for overlap tests.
 class BP_Link {
 public:
 	BP_Link() {}
@@ -37,62 +42,79 @@ public:
 
 	DT_Index  m_index;
 	DT_Count  m_count;
+	Uint32    m_key;
 	BP_Proxy *m_proxy;
 };
 
-typedef unsigned int Uint32;
-
+// An endpoint is a 32-bit key that sorts as the position does, and a link. 
+// The bits of a float order as unsigned integers once the sign bit of a 
+// positive float or all bits of a negative float are flipped. The lowest 
+// bit holds the type, so a minimum is rounded down and a maximum up, and a 
+// minimum comes before a maximum at the same position. 
 class BP_Endpoint {
 public:
     enum { 
 		MINIMUM = 0x00000000, 
-		MAXIMUM = 0x80000000,	
-		TYPEBIT = 0x00000001
+		MAXIMUM = 0x00000001,	
+		TYPEBIT = 0x00000001,
+		SIGNBIT = 0x80000000
 	};
 
     BP_Endpoint() {}
+    BP_Endpoint(Uint32 key, BP_Link *link) 
+	  :	m_key(key),
+		m_link(link)
+	{}
+
     BP_Endpoint(DT_Scalar pos, Uint32 type, BP_Link *link) 
-	  :	m_link(link)
+	  :	m_key(encode(pos, type)),
+		m_link(link)
+	{}
+
+	static Uint32 encode(DT_Scalar pos, Uint32 type)
 	{
-		setPos(pos, type);
+		union {
+			DT_Scalar m_pos;
+			Uint32    m_bits;
+		} value;
+		value.m_pos = pos;
+		Uint32 bits = (value.m_bits & SIGNBIT) ? ~value.m_bits : (value.m_bits | SIGNBIT);
+		return (bits & ~TYPEBIT) | type;
+	}
+
+	static DT_Scalar decode(Uint32 key)
+	{
+		union {
+			DT_Scalar m_pos;
+			Uint32    m_bits;
+		} value;
+		value.m_bits = (key & SIGNBIT) ? (key & ~SIGNBIT) : ~key;
+		return value.m_pos;
 	}
  
-	DT_Scalar getPos()   const { return m_pos; }
+	Uint32    getKey()   const { return m_key; }
+	DT_Scalar getPos()   const { return decode(m_key); }
+	BP_Link  *getLink()  const { return m_link; }
 	DT_Index&   getIndex() const { return m_link->m_index; }
 	DT_Count&   getCount() const { return m_link->m_count; }
 	BP_Proxy *getProxy() const { return m_link->m_proxy; }
+
+	// The endpoints of a destroyed proxy stay in the list until the list 
+	// is compacted. They are skipped and do not count as open intervals.
+	bool isDead() const { return m_link->m_proxy == 0; }
 	
 	DT_Index   getEndIndex()   const { return (m_link + 1)->m_index; }
 	
-	Uint32 getType() const 
-	{ 
-		return (m_bits & TYPEBIT) ? (~m_bits & MAXIMUM) : (m_bits & MAXIMUM);
-	}
-
-	void setPos(DT_Scalar pos, Uint32 type) 
-	{
-		m_pos = pos; 
-		if ((m_bits & MAXIMUM) == type) 
-		{
-			m_bits &= ~TYPEBIT;
-		}
-		else 
-		{
-			m_bits |= TYPEBIT;
-		}
-	}
+	Uint32 getType() const { return m_key & TYPEBIT; }
 
 private:
-	union {
-		DT_Scalar    m_pos;
-		Uint32       m_bits;
-	};
-	BP_Link        *m_link;
+	Uint32    m_key;
+	BP_Link  *m_link;
 };
 
 inline bool operator<(const BP_Endpoint& a, const BP_Endpoint& b) 
 {
-    return a.getPos() < b.getPos(); 
+    return a.getKey() < b.getKey(); 
 }
 
 #endif
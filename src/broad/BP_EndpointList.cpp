@@ -31,7 +31,7 @@
 
 DT_Index BP_EndpointList::stab(const BP_Endpoint& pos, BP_ProxyList& proxies) const 
 {
-	DT_Index result = std::upper_bound(begin(), end(), pos) - begin();
+	DT_Index result = std::upper_bound(m_keys.begin(), m_keys.end(), pos.getKey()) - m_keys.begin();
 	
 	if (result != 0) 
 	{
@@ -40,7 +40,8 @@ DT_Index BP_EndpointList::stab(const BP_Endpoint& pos, BP_ProxyList& proxies) co
 		while (count) 
 		{
 			const BP_Endpoint& endpoint = (*this)[i];
-			if (endpoint.getType() == BP_Endpoint::MINIMUM &&
+			if (!endpoint.isDead() &&
+				endpoint.getType() == BP_Endpoint::MINIMUM &&
 				pos < (*this)[endpoint.getEndIndex()]) 
 			{
 				proxies.add(endpoint.getProxy());
@@ -53,6 +54,31 @@ DT_Index BP_EndpointList::stab(const BP_Endpoint& pos, BP_ProxyList& proxies) co
 	return result;
 }
 
+DT_Index BP_EndpointList::position(Uint32 key, DT_Index index) const
+{
+	DT_Index first, last;
+	DT_Count step = 1;
+	if (key < m_keys[index]) 
+	{
+		last = index;
+		while (step < last && key < m_keys[last - step]) 
+		{
+			step *= 2;
+		}
+		first = step < last ? last - step : 0;
+	}
+	else 
+	{
+		first = index + 1;
+		while (step < size() - first && !(key < m_keys[first + step - 1])) 
+		{
+			step *= 2;
+		}
+		last = step < size() - first ? first + step : size();
+	}
+	return std::upper_bound(m_keys.begin() + first, m_keys.begin() + last, key) - m_keys.begin();
+}
+
 DT_Scalar BP_EndpointList::nextLambda(DT_Index& index, 
 									  DT_Scalar source, 
 									  DT_Scalar delta) const
@@ -84,13 +110,13 @@ void BP_EndpointList::range(const BP_Endpoint& min,
 							BP_ProxyList& proxies) const 
 {
 	first = stab(min, proxies);
-	last  = std::upper_bound(begin(), end(), max) - begin();
+	last  = std::upper_bound(m_keys.begin(), m_keys.end(), max.getKey()) - m_keys.begin();
 	
 	DT_Index i;
 	for (i = first; i != last; ++i) 
 	{
 		const BP_Endpoint& endpoint = (*this)[i];
-		if (endpoint.getType() == BP_Endpoint::MINIMUM) 
+		if (!endpoint.isDead() && endpoint.getType() == BP_Endpoint::MINIMUM) 
 		{
 			proxies.add(endpoint.getProxy());
 		}
@@ -104,9 +130,13 @@ void BP_EndpointList::addInterval(const BP_Endpoint& min,
 	assert(invariant());
 	DT_Index first, last;
 	range(min, max, first, last, proxies);
-	insert(begin() + last, max);
-	insert(begin() + first, min);
+	m_keys.insert(m_keys.begin() + last, max.getKey());
+	m_links.insert(m_links.begin() + last, max.getLink());
+	m_keys.insert(m_keys.begin() + first, min.getKey());
+	m_links.insert(m_links.begin() + first, min.getLink());
 	++last; 
+	min.getLink()->m_key = min.getKey();
+	max.getLink()->m_key = max.getKey();
 	
 	(*this)[first].getCount() = first != 0 ? (*this)[first - 1].getCount() : 0;
 	(*this)[last].getCount() = (*this)[last - 1].getCount();
@@ -126,31 +156,102 @@ void BP_EndpointList::addInterval(const BP_Endpoint& min,
 	assert(invariant());
 }
 
-void BP_EndpointList::removeInterval(DT_Index first, DT_Index last,
-									 BP_ProxyList& proxies) 
+void BP_EndpointList::query(DT_Scalar lb, DT_Scalar ub, 
+							std::vector<BP_Proxy *>& proxies) const
+{
+	DT_Index first = position(BP_Endpoint::encode(lb, BP_Endpoint::MINIMUM));
+	DT_Index last = position(BP_Endpoint::encode(ub, BP_Endpoint::MAXIMUM));
+
+	// The intervals open in front of first start in front of it.
+	if (first != 0)
+	{
+		DT_Index i = first - 1;
+		DT_Count count = (*this)[i].getCount();
+		while (count) 
+		{
+			const BP_Endpoint& endpoint = (*this)[i];
+			if (!endpoint.isDead() &&
+				endpoint.getType() == BP_Endpoint::MINIMUM &&
+				endpoint.getEndIndex() >= first) 
+			{
+				proxies.push_back(endpoint.getProxy());
+				--count;
+			}
+			assert(i != 0 || count == 0);
+			--i;
+		}
+	}
+
+	DT_Index i;
+	for (i = first; i < last; ++i) 
+	{
+		const BP_Endpoint& endpoint = (*this)[i];
+		if (!endpoint.isDead() && endpoint.getType() == BP_Endpoint::MINIMUM) 
+		{
+			proxies.push_back(endpoint.getProxy());
+		}
+	}
+}
+
+void BP_EndpointList::overlapping(DT_Index first, DT_Index last, 
+								  std::vector<BP_Proxy *>& proxies) const
+{
+	// The intervals open at first, except the interval itself, start in 
+	// front of it.
+	DT_Count count = (*this)[first].getCount() - 1;
+	DT_Index i = first;
+	while (count) 
+	{
+		assert(i != 0);
+		--i;
+		const BP_Endpoint& endpoint = (*this)[i];
+		if (!endpoint.isDead() &&
+			endpoint.getType() == BP_Endpoint::MINIMUM &&
+			endpoint.getEndIndex() > first) 
+		{
+			proxies.push_back(endpoint.getProxy());
+			--count;
+		}
+	}
+
+	for (i = first + 1; i != last; ++i) 
+	{
+		const BP_Endpoint& endpoint = (*this)[i];
+		if (!endpoint.isDead() && endpoint.getType() == BP_Endpoint::MINIMUM) 
+		{
+			proxies.push_back(endpoint.getProxy());
+		}
+	}
+}
+
+void BP_EndpointList::removeInterval(DT_Index first, DT_Index last) 
 { 
-	assert(invariant());
-	
-	BP_Endpoint min = (*this)[first];
-	BP_Endpoint max = (*this)[last]; 
-	
-	erase(begin() + last);
-	erase(begin() + first);
-	--last;
+	assert((*this)[first].isDead() && (*this)[last].isDead());
 	
 	DT_Index i;
-	for (i = first; i != last; ++i) 
+	for (i = first; i != last; ++i)
 	{
 		--(*this)[i].getCount();
-		(*this)[i].getIndex() = i;
-	} 
-	for (; i != size(); ++i) 
-	{
-		(*this)[i].getIndex() = i;
 	} 
 	
-	range(min, max, first, last, proxies);
-	
+	assert(invariant());
+}
+
+void BP_EndpointList::compact()
+{
+	DT_Index index = 0;
+	DT_Index i;
+	for (i = 0; i != size(); ++i) 
+	{
+		if (!(*this)[i].isDead())
+		{
+			set(index, m_keys[i], m_links[i]);
+			++index;
+		}
+	}
+	m_keys.resize(index);
+	m_links.resize(index);
+
 	assert(invariant());
 }
 
@@ -159,18 +260,17 @@ void BP_EndpointList::move(DT_Index index, DT_Scalar pos, Uint32 type,
 {
 	assert(invariant());
 	
-	BP_Endpoint endpoint = (*this)[index];
-    DT_Scalar delta = pos - endpoint.getPos();
+	BP_Endpoint endpoint(pos, type, m_links[index]);
+	Uint32 key = endpoint.getKey();
 	
-    if (delta != DT_Scalar(0.0)) 
+    if (key != m_keys[index]) 
 	{
-		endpoint.setPos(pos, type);
-		if (delta < DT_Scalar(0.0)) 
+		endpoint.getLink()->m_key = key;
+		if (key < m_keys[index]) 
 		{
-			while (index != 0 && endpoint < (*this)[index - 1]) 
+			while (index != 0 && key < m_keys[index - 1]) 
 			{
-				(*this)[index] = (*this)[index - 1];
-				(*this)[index].getIndex() = index;
+				set(index, m_keys[index - 1], m_links[index - 1]);
 				encounters((*this)[index], endpoint, scene, overlap);
 				--index;
 			}
@@ -178,31 +278,201 @@ void BP_EndpointList::move(DT_Index index, DT_Scalar pos, Uint32 type,
 		else 
 		{
 			DT_Index last = size() - 1;
-			while (index != last && (*this)[index + 1] < endpoint) 
+			while (index != last && m_keys[index + 1] < key) 
 			{
-				(*this)[index] = (*this)[index + 1];
-				(*this)[index].getIndex() = index;
+				set(index, m_keys[index + 1], m_links[index + 1]);
 				encounters(endpoint, (*this)[index], scene, overlap);
 				++index;
 			}
 		}
-		(*this)[index] = endpoint;
-		(*this)[index].getIndex() = index;
+		set(index, key, endpoint.getLink());
     }
 
 	assert(invariant());
 }
 
+void BP_EndpointList::sort(BP_Scene& scene, T_Overlap overlap)
+{
+	DT_Index last = size();
+	DT_Index i;
+	for (i = 1; i < last; ++i) 
+	{
+		Uint32 key = m_keys[i];
+		if (key < m_keys[i - 1]) 
+		{
+			BP_Endpoint endpoint = (*this)[i];
+			DT_Index index = i;
+			while (index != 0 && key < m_keys[index - 1]) 
+			{
+				set(index, m_keys[index - 1], m_links[index - 1]);
+				encounters((*this)[index], endpoint, scene, overlap);
+				--index;
+			}
+			set(index, key, endpoint.getLink());
+		}
+	}
+
+	assert(invariant());
+}
+
+DT_Count BP_EndpointList::merge(DT_Index first)
+{
+	std::vector<BP_Endpoint> endpoints(size());
+	DT_Index i;
+	for (i = 0; i != size(); ++i) 
+	{
+		endpoints[i] = (*this)[i];
+	}
+
+	std::stable_sort(endpoints.begin() + first, endpoints.end());
+	std::inplace_merge(endpoints.begin(), endpoints.begin() + first, endpoints.end());
+
+	for (i = 0; i != size(); ++i) 
+	{
+		m_keys[i] = endpoints[i].getKey();
+		m_links[i] = endpoints[i].getLink();
+		m_links[i]->m_key = m_keys[i];
+	}
+
+	return relink();
+}
+
+DT_Count BP_EndpointList::radixSort()
+{
+	enum { BITS = 11, RADIX = 1 << BITS };
+
+	DT_Count n = size();
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	std::vector<Uint32>    keys(n);
+	std::vector<BP_Link *> links(n);
+	std::vector<DT_Count>  offset(RADIX);
+
+	int shift;
+	for (shift = 0; shift < 32; shift += BITS) 
+	{
+		std::fill(offset.begin(), offset.end(), 0);
+		DT_Index i;
+		for (i = 0; i != n; ++i) 
+		{
+			++offset[(m_keys[i] >> shift) & (RADIX - 1)];
+		}
+
+		// A pass in which all keys have the same digit changes nothing.
+		if (offset[(m_keys[0] >> shift) & (RADIX - 1)] == n) 
+		{
+			continue;
+		}
+
+		DT_Count sum = 0;
+		int digit;
+		for (digit = 0; digit != RADIX; ++digit) 
+		{
+			DT_Count count = offset[digit];
+			offset[digit] = sum;
+			sum += count;
+		}
+		
+		for (i = 0; i != n; ++i) 
+		{
+			DT_Index index = offset[(m_keys[i] >> shift) & (RADIX - 1)]++;
+			keys[index] = m_keys[i];
+			links[index] = m_links[i];
+		}
+		m_keys.swap(keys);
+		m_links.swap(links);
+	}
+
+	return relink();
+}
+
+DT_Count BP_EndpointList::relink()
+{
+	DT_Count count = 0;
+	DT_Count overlaps = 0;
+	DT_Index i;
+	for (i = 0; i != size(); ++i) 
+	{
+		BP_Link *link = m_links[i];
+		if (link->m_proxy == 0)
+		{
+		}
+		else if ((m_keys[i] & BP_Endpoint::TYPEBIT) == BP_Endpoint::MINIMUM) 
+		{
+			overlaps += count;
+			++count;
+		}
+		else 
+		{
+			--count;
+		}
+		link->m_count = count;
+		link->m_index = i;
+	}
+
+	assert(invariant());
+	return overlaps;
+}
+
+DT_Count BP_EndpointList::overlaps() const
+{
+	DT_Count overlaps = 0;
+	DT_Index i;
+	for (i = 0; i != size(); ++i) 
+	{
+		const BP_Link *link = m_links[i];
+		if (link->m_proxy != 0 && 
+			(m_keys[i] & BP_Endpoint::TYPEBIT) == BP_Endpoint::MINIMUM) 
+		{
+			overlaps += link->m_count - 1;
+		}
+	}
+	return overlaps;
+}
+
 void BP_EndpointList::encounters(const BP_Endpoint& a, const BP_Endpoint& b,
 								 BP_Scene& scene, T_Overlap overlap)
 {
+	// a was in front of b. A dead endpoint does not change the count of 
+	// the other one.
+	if (a.isDead() || b.isDead())
+	{
+		if (!b.isDead())
+		{
+			if (b.getType() == BP_Endpoint::MINIMUM)
+			{
+				++a.getCount();
+			}
+			else
+			{
+				--a.getCount();
+			}
+		}
+		else if (!a.isDead())
+		{
+			if (a.getType() == BP_Endpoint::MINIMUM)
+			{
+				--b.getCount();
+			}
+			else
+			{
+				++b.getCount();
+			}
+		}
+		return;
+	}
+
 	assert(a.getProxy() != b.getProxy());
 	
 	if (a.getType() != b.getType()) 
 	{
 		if (a.getType() == BP_Endpoint::MAXIMUM) 
 		{
-			if (overlap(*a.getProxy(), *b.getProxy())) 
+			if (a.getProxy()->accepts(*b.getProxy()) &&
+				overlap(*a.getProxy(), *b.getProxy())) 
 			{
 				scene.callBeginOverlap(a.getProxy()->getObject(), 
 									   b.getProxy()->getObject());
@@ -212,7 +482,8 @@ void BP_EndpointList::encounters(const BP_Endpoint& a, const BP_Endpoint& b,
 		}
 		else 
 		{
-			if (overlap(*a.getProxy(), *b.getProxy())) 
+			if (a.getProxy()->accepts(*b.getProxy()) &&
+				overlap(*a.getProxy(), *b.getProxy())) 
 			{
 				scene.callEndOverlap(a.getProxy()->getObject(), 
 									 b.getProxy()->getObject());
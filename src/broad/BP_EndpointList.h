@@ -27,6 +27,7 @@
 //#define PARANOID
 
 #include <vector>
+#include <algorithm>
 
 #include "BP_Endpoint.h"
 #include "BP_ProxyList.h"
@@ -35,9 +36,43 @@ class BP_Scene;
 
 typedef bool (*T_Overlap)(const BP_Proxy& a, const BP_Proxy& b);
 
-class BP_EndpointList : public std::vector<BP_Endpoint> {
+// The keys and the links of the endpoints are kept in separate arrays, so 
+// that the searches and the sorting loops compare keys that are packed 
+// together.
+class BP_EndpointList {
 public:
 	BP_EndpointList() {}
+
+	DT_Count size() const { return DT_Count(m_keys.size()); }
+
+	BP_Endpoint operator[](DT_Index i) const 
+	{ 
+		return BP_Endpoint(m_keys[i], m_links[i]); 
+	}
+
+	void push_back(const BP_Endpoint& endpoint)
+	{
+		m_keys.push_back(endpoint.getKey());
+		m_links.push_back(endpoint.getLink());
+	}
+
+	// Returns the index at which an endpoint with the given key would be 
+	// inserted.
+	DT_Index position(Uint32 key) const
+	{
+		return std::upper_bound(m_keys.begin(), m_keys.end(), key) - m_keys.begin();
+	}
+
+	// Same, but searches outward from the endpoint at index, so that the 
+	// cost grows with the log of the distance.
+	DT_Index position(Uint32 key, DT_Index index) const;
+
+	// Sets the key of the endpoint at index, without moving it.
+	void setKey(DT_Index index, Uint32 key)
+	{
+		m_keys[index] = key;
+		m_links[index]->m_key = key;
+	}
 	
 	DT_Index stab(const BP_Endpoint& pos, BP_ProxyList& proxies) const;
 	
@@ -58,14 +93,48 @@ public:
 	}
 	
 	void addInterval(const BP_Endpoint& min, const BP_Endpoint& max, BP_ProxyList& proxies);
-	void removeInterval(DT_Index first, DT_Index last, BP_ProxyList& proxies);
+
+	// Collects the proxies whose intervals overlap the live interval with 
+	// endpoints at first and last.
+	void overlapping(DT_Index first, DT_Index last, 
+					 std::vector<BP_Proxy *>& proxies) const;
+
+	// Collects the proxies whose intervals overlap the interval [lb, ub]. 
+	// Only reads the list, so it may be called from several threads at once.
+	void query(DT_Scalar lb, DT_Scalar ub, std::vector<BP_Proxy *>& proxies) const;
+
+	// The endpoints at first and last must be dead. They are left in place. 
+	void removeInterval(DT_Index first, DT_Index last);
+
+	// Erases the dead endpoints and renumbers the list.
+	void compact();
 
 	void move(DT_Index index, DT_Scalar pos, Uint32 type, BP_Scene& scene, T_Overlap overlap);	
+
+	// Restores the order after endpoint positions were changed in place.
+	void sort(BP_Scene& scene, T_Overlap overlap);
+
+	// Sorts the endpoints from index first on, which were appended without 
+	// order, into the list and renumbers the list. Ties keep the endpoints 
+	// already in the list in front, as addInterval does. Returns the number 
+	// of pairs of intervals that overlap. 
+	DT_Count merge(DT_Index first);
+
+	// Sorts the list with a radix sort on the keys and renumbers it. Returns
+	// the number of pairs of intervals that overlap.
+	DT_Count radixSort();
+
+	// Returns the number of pairs of intervals that overlap.
+	DT_Count overlaps() const;
    
    DT_Scalar nextLambda(DT_Index& index, DT_Scalar source, DT_Scalar target) const;
 	
 
 private:
+	// Renumbers the list and recounts the open intervals. Returns the 
+	// number of pairs of intervals that overlap.
+	DT_Count relink();
+
 	void encounters(const BP_Endpoint& a, const BP_Endpoint& b,
 					    BP_Scene& scene, T_Overlap overlap);
 
@@ -79,7 +148,10 @@ private:
 		{
          const BP_Endpoint& endpoint = (*this)[i];
 
-			if (endpoint.getType() == BP_Endpoint::MINIMUM) 
+			if (endpoint.isDead())
+			{
+			}
+			else if (endpoint.getType() == BP_Endpoint::MINIMUM) 
 			{
 				++count;
 			}
@@ -102,6 +174,17 @@ private:
 	bool invariant() const { return true; }
 #endif
 
+	// Puts the endpoint at index.
+	void set(DT_Index index, Uint32 key, BP_Link *link)
+	{
+		m_keys[index] = key;
+		m_links[index] = link;
+		link->m_index = index;
+	}
+
+	std::vector<Uint32>     m_keys;
+	std::vector<BP_Link *>  m_links;
+
 };
 
 
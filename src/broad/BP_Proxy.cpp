@@ -27,9 +27,12 @@
 #include "BP_Scene.h"
 
 BP_Proxy::BP_Proxy(void *object, 
-				   BP_Scene& scene) 
-  :	m_object(object),
-	m_scene(scene)
+				   BP_Scene& scene,
+				   DT_Mask category,
+				   DT_Mask mask) 
+  :	BP_ProxyBase(object, category, mask),
+	m_scene(scene),
+	m_dirty(false)
 {
 	int i;
 	for (i = 0; i < 3; ++i) 
@@ -52,54 +55,82 @@ void BP_Proxy::add(const DT_Vector3 min,
 	}
 }
 
-void BP_Proxy::remove(BP_ProxyList& proxies) 
+void BP_Proxy::remove() 
 {
 	int i;
 	for (i = 0; i < 3; ++i) 
+	{
+		m_interval[i].m_min.m_proxy = 0;
+		m_interval[i].m_max.m_proxy = 0;
+	}
+	for (i = 0; i < 3; ++i) 
 	{
 		m_scene.getList(i).removeInterval(
 			m_interval[i].m_min.m_index,
-			m_interval[i].m_max.m_index,
-			proxies);
+			m_interval[i].m_max.m_index);
+	}
+}
+
+void BP_Proxy::append(const DT_Vector3 min, const DT_Vector3 max) 
+{
+	int i;
+	for (i = 0; i < 3; ++i) 
+	{
+		BP_EndpointList& list = m_scene.getList(i);
+		list.push_back(BP_Endpoint(min[i], BP_Endpoint::MINIMUM, &m_interval[i].m_min));
+		list.push_back(BP_Endpoint(max[i], BP_Endpoint::MAXIMUM, &m_interval[i].m_max));
 	}
 }
 
 DT_Scalar BP_Proxy::getMin(int i) const 
 { 
-	return m_scene.getList(i)[m_interval[i].m_min.m_index].getPos(); 
+	return BP_Endpoint::decode(m_interval[i].m_min.m_key); 
 }
 
 DT_Scalar BP_Proxy::getMax(int i) const 
 { 
-	return m_scene.getList(i)[m_interval[i].m_max.m_index].getPos(); 
+	return BP_Endpoint::decode(m_interval[i].m_max.m_key); 
 }
 
 bool overlapXY(const BP_Proxy& a, const BP_Proxy& b)
 {
-	return a.getMin(0) <= b.getMax(0) && b.getMin(0) <= a.getMax(0) && 
-		   a.getMin(1) <= b.getMax(1) && b.getMin(1) <= a.getMax(1);
+	return a.overlaps(b, 0) && a.overlaps(b, 1);
 }
 
 bool overlapXZ(const BP_Proxy& a, const BP_Proxy& b)
 {
-	return a.getMin(0) <= b.getMax(0) && b.getMin(0) <= a.getMax(0) && 
-		   a.getMin(2) <= b.getMax(2) && b.getMin(2) <= a.getMax(2); 
+	return a.overlaps(b, 0) && a.overlaps(b, 2);
 }
 
 bool overlapYZ(const BP_Proxy& a, const BP_Proxy& b)
 {
-	return a.getMin(1) <= b.getMax(1) && b.getMin(1) <= a.getMax(1) && 
-		   a.getMin(2) <= b.getMax(2) && b.getMin(2) <= a.getMax(2); 
+	return a.overlaps(b, 1) && a.overlaps(b, 2);
 }
 
 void BP_Proxy::setBBox(const DT_Vector3 min, const DT_Vector3 max)
 {	
 	static T_Overlap overlap[3] = { overlapYZ, overlapXZ, overlapXY };
 
+	if (m_scene.isUpdating())
+	{
+		int i;
+		for (i = 0; i < 3; ++i) 
+		{
+			m_pending_min[i] = min[i];
+			m_pending_max[i] = max[i];
+		}
+		if (!m_dirty)
+		{
+			m_dirty = true;
+			m_scene.addDirty(this);
+		}
+		return;
+	}
+
 	int i;
 	for (i = 0; i < 3; ++i) 
 	{
-		if (min[i] > getMax(i)) 
+		if (BP_Endpoint::encode(min[i], BP_Endpoint::MINIMUM) > m_interval[i].m_max.m_key) 
 		{
 			m_scene.getList(i).move(m_interval[i].m_max.m_index, max[i], 
 									BP_Endpoint::MAXIMUM, m_scene, overlap[i]);
@@ -114,7 +145,39 @@ void BP_Proxy::setBBox(const DT_Vector3 min, const DT_Vector3 max)
 									BP_Endpoint::MAXIMUM, m_scene, overlap[i]);
 		}
 	}
+
+	m_scene.updateStatics(this);
 }
 
+static DT_Count distance(DT_Index index, DT_Index position)
+{
+	// An endpoint that moves up is inserted after itself.
+	return index < position ? position - index - 1 : index - position;
+}
 
+DT_Count BP_Proxy::getTravel() const
+{
+	DT_Count travel = 0;
+	int i;
+	for (i = 0; i < 3; ++i) 
+	{
+		const BP_EndpointList& list = m_scene.getList(i);
+		DT_Index min = m_interval[i].m_min.m_index;
+		DT_Index max = m_interval[i].m_max.m_index;
+		travel += distance(min, list.position(BP_Endpoint::encode(m_pending_min[i], BP_Endpoint::MINIMUM), min));
+		travel += distance(max, list.position(BP_Endpoint::encode(m_pending_max[i], BP_Endpoint::MAXIMUM), max));
+	}
+	return travel;
+}
 
+void BP_Proxy::commitBBox(int i)
+{
+	assert(m_dirty);
+	assert(m_pending_min[i] <= m_pending_max[i]);
+	
+	BP_EndpointList& list = m_scene.getList(i);
+	list.setKey(m_interval[i].m_min.m_index, 
+				BP_Endpoint::encode(m_pending_min[i], BP_Endpoint::MINIMUM));
+	list.setKey(m_interval[i].m_max.m_index, 
+				BP_Endpoint::encode(m_pending_max[i], BP_Endpoint::MAXIMUM));
+}
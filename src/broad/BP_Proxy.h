@@ -24,6 +24,7 @@
 #ifndef BP_PROXY_H
 #define BP_PROXY_H
 
+#include "BP_SceneBase.h"
 #include "BP_Endpoint.h"
 #include "BP_ProxyList.h"
 
@@ -40,35 +41,68 @@ public:
 };
 
 class BP_Scene;
+class BP_StaticProxy;
 
-class BP_Proxy {
+class BP_Proxy : public BP_ProxyBase {
 public:
-    BP_Proxy(void *object, BP_Scene& scene);
+    BP_Proxy(void *object, BP_Scene& scene, DT_Mask category, DT_Mask mask);
 
 	void add(const DT_Vector3 min,
 			 const DT_Vector3 max,
 			 BP_ProxyList& proxies);
 	
-    void remove(BP_ProxyList& proxies);
+	// Kills the endpoints. They are erased when the lists are compacted. 
+    void remove();
+	bool isDead() const { return m_interval[0].m_min.m_proxy == 0; }
+
+	// Appends the endpoints to the lists, without keeping them sorted.
+	void append(const DT_Vector3 min, const DT_Vector3 max);
 	
-	void setBBox(const DT_Vector3 min, const DT_Vector3 max);
-    
-    void *getObject() { return m_object; }
+	virtual void setBBox(const DT_Vector3 min, const DT_Vector3 max);
+
+	// Writes the box recorded during a batch update into the endpoints 
+	// on axis i. The endpoint list is left unsorted.
+	void commitBBox(int i);
+	void clearDirty() { m_dirty = false; }
+
+	// Estimates the number of endpoints that the endpoints of this proxy 
+	// pass when the recorded box is committed, from the current lists.
+	DT_Count getTravel() const;
+	bool isDirty() const { return m_dirty; }
 
 	DT_Scalar getMin(int i) const;
 	DT_Scalar getMax(int i) const;
 
+	DT_Index getMinIndex(int i) const { return m_interval[i].m_min.m_index; }
+	DT_Index getMaxIndex(int i) const { return m_interval[i].m_max.m_index; }
+
+	// The static proxies that overlap this proxy, in order of address.
+	std::vector<BP_StaticProxy *>& getStatics() { return m_statics; }
+
+	// Tests the keys kept in the links, so the lists are not touched. A 
+	// minimum and a maximum never have the same key.
+	bool overlaps(const BP_Proxy& proxy, int i) const
+	{
+		return m_interval[i].m_min.m_key < proxy.m_interval[i].m_max.m_key && 
+			   proxy.m_interval[i].m_min.m_key < m_interval[i].m_max.m_key;
+	}
+
 private:
 	BP_Interval  m_interval[3];
-    void        *m_object;
 	BP_Scene&    m_scene;
+	std::vector<BP_StaticProxy *>  m_statics;
+	DT_Vector3   m_pending_min;
+	DT_Vector3   m_pending_max;
+	bool         m_dirty;
 };
 
+bool overlapXY(const BP_Proxy& a, const BP_Proxy& b);
+bool overlapXZ(const BP_Proxy& a, const BP_Proxy& b);
+bool overlapYZ(const BP_Proxy& a, const BP_Proxy& b);
+
 inline bool BP_overlap(const BP_Proxy *a, const BP_Proxy *b)
 {
-	return a->getMin(0) <= b->getMax(0) && b->getMin(0) <= a->getMax(0) && 
-		   a->getMin(1) <= b->getMax(1) && b->getMin(1) <= a->getMax(1) &&
-		   a->getMin(2) <= b->getMax(2) && b->getMin(2) <= a->getMax(2);
+	return a->overlaps(*b, 0) && a->overlaps(*b, 1) && a->overlaps(*b, 2);
 }
 
 #endif
@@ -26,11 +26,130 @@
 
 #include <algorithm>
 
-BP_Proxy *BP_Scene::createProxy(void *object, 
-								const DT_Vector3 min,
-								const DT_Vector3 max)
+// Collects the static proxies whose boxes overlap the query box.
+class BP_Scene::StaticCallback {
+public:
+	StaticCallback(std::vector<BP_StaticProxy *>& proxies, 
+				   const BP_StaticProxy *ignore = 0) 
+	  : m_proxies(proxies),
+		m_ignore(ignore)
+	{}
+
+	void operator()(void *data)
+	{
+		BP_StaticProxy *proxy = static_cast<BP_StaticProxy *>(data);
+		if (proxy != m_ignore)
+		{
+			m_proxies.push_back(proxy);
+		}
+	}
+
+private:
+	std::vector<BP_StaticProxy *>&  m_proxies;
+	const BP_StaticProxy           *m_ignore;
+};
+
+// The leaves of the static tree hold the boxes themselves, so a leaf that 
+// is hit is passed on to the client.
+class BP_Scene::RayCastCallback {
+public:
+	RayCastCallback(BP_RayCastCallback objectRayCast, void *client_data, 
+					const DT_Vector3 source, const DT_Vector3 target) 
+	  : m_objectRayCast(objectRayCast),
+		m_client_data(client_data),
+		m_source(source),
+		m_target(target),
+		m_client_object(0)
+	{}
+
+	void operator()(void *data, DT_Scalar& lambda)
+	{
+		BP_StaticProxy *proxy = static_cast<BP_StaticProxy *>(data);
+		if ((*m_objectRayCast)(m_client_data, proxy->getObject(), m_source, m_target, &lambda))
+		{
+			m_client_object = proxy->getObject();
+		}
+	}
+
+	void *getClientObject() const { return m_client_object; }
+
+private:
+	BP_RayCastCallback  m_objectRayCast;
+	void               *m_client_data;
+	const DT_Scalar    *m_source;
+	const DT_Scalar    *m_target;
+	void               *m_client_object;
+};
+
+// Passes the static proxies whose boxes overlap the query box on to the
+// client.
+class BP_Scene::QueryCallback {
+public:
+	QueryCallback(BP_QueryCallback callback, void *client_data) 
+	  : m_callback(callback),
+		m_client_data(client_data),
+		m_count(0)
+	{}
+
+	void operator()(void *data)
+	{
+		(*m_callback)(m_client_data, static_cast<BP_StaticProxy *>(data)->getObject());
+		++m_count;
+	}
+
+	DT_Count getCount() const { return m_count; }
+
+private:
+	BP_QueryCallback  m_callback;
+	void             *m_client_data;
+	DT_Count          m_count;
+};
+
+void BP_StaticProxy::setBBox(const DT_Vector3 min, const DT_Vector3 max)
+{
+	m_scene.moveStatic(this, BP_Box(min, max));
+}
+
+// The box of a moving proxy as it is in the endpoint lists.
+static BP_Box getBox(const BP_Proxy *proxy)
+{
+	BP_Box box;
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		box.m_min[i] = proxy->getMin(i);
+		box.m_max[i] = proxy->getMax(i);
+	}
+	return box;
+}
+
+template <typename T>
+static void insertSorted(std::vector<T *>& proxies, T *proxy)
+{
+	proxies.insert(std::lower_bound(proxies.begin(), proxies.end(), proxy), proxy);
+}
+
+template <typename T>
+static void eraseSorted(std::vector<T *>& proxies, T *proxy)
+{
+	proxies.erase(std::lower_bound(proxies.begin(), proxies.end(), proxy));
+}
+
+template <typename T>
+static void erase(std::vector<T *>& proxies, T *proxy)
+{
+	typename std::vector<T *>::iterator it = std::find(proxies.begin(), proxies.end(), proxy);
+	*it = proxies.back();
+	proxies.pop_back();
+}
+
+BP_ProxyBase *BP_Scene::createProxy(void *object, 
+									const DT_Vector3 min,
+									const DT_Vector3 max,
+									DT_Mask category,
+									DT_Mask mask)
 {
-	BP_Proxy *proxy = new BP_Proxy(object, *this);
+	BP_Proxy *proxy = new BP_Proxy(object, *this, category, mask);
 
 	proxy->add(min, max, m_proxies);
 	
@@ -39,33 +158,614 @@ BP_Proxy *BP_Scene::createProxy(void *object,
 	{
 		if ((*it).second == 3)
 		{
-			callBeginOverlap(proxy->getObject(), (*it).first->getObject());
+			beginOverlap(proxy, (*it).first);
 		}
 	}
 
 	m_proxies.clear();
 
+	updateStatics(proxy);
+
 	return proxy;
 }
 
-void BP_Scene::destroyProxy(BP_Proxy *proxy)
+BP_ProxyBase *BP_Scene::createStaticProxy(void *object, 
+										  const DT_Vector3 min,
+										  const DT_Vector3 max,
+										  DT_Mask category,
+										  DT_Mask mask)
 {
-	proxy->remove(m_proxies);
-	
-	BP_ProxyList::iterator it;
-	for (it = m_proxies.begin(); it != m_proxies.end(); ++it)
+	BP_StaticProxy *proxy = new BP_StaticProxy(object, *this, BP_Box(min, max), 
+											   category, mask);
+
+	StaticCallback callback(m_statics);
+	m_staticTree.query(proxy->m_box, callback);
+
+	std::vector<BP_StaticProxy *>::const_iterator it;
+	for (it = m_statics.begin(); it != m_statics.end(); ++it)
 	{
-		if ((*it).second == 3)
+		beginOverlap(proxy, *it);
+	}
+	m_statics.clear();
+
+	findMoving(proxy->m_box, proxy->m_partners);
+
+	std::vector<BP_Proxy *>::const_iterator jt;
+	for (jt = proxy->m_partners.begin(); jt != proxy->m_partners.end(); ++jt)
+	{
+		beginOverlap(*jt, proxy);
+		insertSorted((*jt)->getStatics(), proxy);
+	}
+
+	proxy->m_leaf = m_staticTree.insert(proxy->m_box, proxy);
+
+	return proxy;
+}
+
+// The candidates are the intervals that overlap the box on the axis on 
+// which the box spans the fewest endpoints.
+void BP_Scene::findMoving(const BP_Box& box, std::vector<BP_Proxy *>& proxies) const
+{
+	int axis = 0;
+	DT_Count span[3];
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		const BP_EndpointList& list = m_endpointList[i];
+		span[i] = list.position(BP_Endpoint::encode(box.m_max[i], BP_Endpoint::MAXIMUM)) - 
+			list.position(BP_Endpoint::encode(box.m_min[i], BP_Endpoint::MINIMUM));
+		if (span[i] < span[axis])
 		{
-			callEndOverlap(proxy->getObject(), (*it).first->getObject());
+			axis = i;
 		}
 	}
+
+	DT_Count count = DT_Count(proxies.size());
+	m_endpointList[axis].query(box.m_min[axis], box.m_max[axis], proxies);
+
+	std::vector<BP_Proxy *>::iterator first = proxies.begin() + count;
+	std::vector<BP_Proxy *>::const_iterator it;
+	for (it = first; it != proxies.end(); ++it)
+	{
+		if (getBox(*it).overlaps(box))
+		{
+			*first++ = *it;
+		}
+	}
+	proxies.erase(first, proxies.end());
+}
+
+void BP_Scene::updateStatics(BP_Proxy *proxy)
+{
+	std::vector<BP_StaticProxy *>& before = proxy->getStatics();
+	if (m_staticTree.empty() && before.empty())
+	{
+		return;
+	}
+
+	std::vector<BP_StaticProxy *>& after = m_statics;
+	StaticCallback callback(after);
+	m_staticTree.query(getBox(proxy), callback);
+	std::sort(after.begin(), after.end());
+
+	std::vector<BP_StaticProxy *>::const_iterator first = before.begin();
+	std::vector<BP_StaticProxy *>::const_iterator second = after.begin();
+	while (first != before.end() || second != after.end())
+	{
+		if (second == after.end() || (first != before.end() && *first < *second))
+		{
+			endOverlap(proxy, *first);
+			erase((*first)->m_partners, proxy);
+			++first;
+		}
+		else if (first == before.end() || *second < *first)
+		{
+			beginOverlap(proxy, *second);
+			(*second)->m_partners.push_back(proxy);
+			++second;
+		}
+		else
+		{
+			++first;
+			++second;
+		}
+	}
+
+	before.swap(after);
+	after.clear();
+}
+
+void BP_Scene::moveStatic(BP_StaticProxy *proxy, const BP_Box& box)
+{
+	StaticCallback callback(m_statics, proxy);
+	m_staticTree.query(proxy->m_box, callback);
+	DT_Count count = DT_Count(m_statics.size());
+	m_staticTree.query(box, callback);
 	
-	m_proxies.clear();
+	std::sort(m_statics.begin(), m_statics.begin() + count);
+	std::sort(m_statics.begin() + count, m_statics.end());
+
+	std::vector<BP_StaticProxy *>::const_iterator first = m_statics.begin();
+	std::vector<BP_StaticProxy *>::const_iterator second = m_statics.begin() + count;
+	while (first != m_statics.begin() + count || second != m_statics.end())
+	{
+		if (second == m_statics.end() || (first != m_statics.begin() + count && *first < *second))
+		{
+			endOverlap(proxy, *first);
+			++first;
+		}
+		else if (first == m_statics.begin() + count || *second < *first)
+		{
+			beginOverlap(proxy, *second);
+			++second;
+		}
+		else
+		{
+			++first;
+			++second;
+		}
+	}
+	m_statics.clear();
+
+	std::vector<BP_Proxy *>& before = proxy->m_partners;
+	std::vector<BP_Proxy *>& after = m_partners;
+	findMoving(box, after);
+	std::sort(before.begin(), before.end());
+	std::sort(after.begin(), after.end());
+
+	std::vector<BP_Proxy *>::const_iterator it = before.begin();
+	std::vector<BP_Proxy *>::const_iterator jt = after.begin();
+	while (it != before.end() || jt != after.end())
+	{
+		if (jt == after.end() || (it != before.end() && *it < *jt))
+		{
+			endOverlap(*it, proxy);
+			eraseSorted((*it)->getStatics(), proxy);
+			++it;
+		}
+		else if (it == before.end() || *jt < *it)
+		{
+			beginOverlap(*jt, proxy);
+			insertSorted((*jt)->getStatics(), proxy);
+			++jt;
+		}
+		else
+		{
+			++it;
+			++jt;
+		}
+	}
+
+	before.swap(after);
+	after.clear();
+
+	proxy->m_box = box;
+	m_staticTree.move(proxy->m_leaf, box);
+}
+
+void BP_Scene::removeStatic(BP_StaticProxy *proxy)
+{
+	m_staticTree.remove(proxy->m_leaf);
+
+	StaticCallback callback(m_statics);
+	m_staticTree.query(proxy->m_box, callback);
+
+	std::vector<BP_StaticProxy *>::const_iterator it;
+	for (it = m_statics.begin(); it != m_statics.end(); ++it)
+	{
+		endOverlap(proxy, *it);
+	}
+	m_statics.clear();
+
+	std::vector<BP_Proxy *>::const_iterator jt;
+	for (jt = proxy->m_partners.begin(); jt != proxy->m_partners.end(); ++jt)
+	{
+		endOverlap(*jt, proxy);
+		eraseSorted((*jt)->getStatics(), proxy);
+	}
 
 	delete proxy;
 }
 
+void BP_Scene::createProxies(DT_Count count, void *const *objects,
+							 const DT_Vector3 *min, const DT_Vector3 *max,
+							 const DT_Mask *categories, const DT_Mask *masks,
+							 BP_ProxyBase **proxies)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	DT_Index first = m_endpointList[0].size();
+
+	std::vector<BP_Proxy *> added(count);
+	DT_Count k;
+	for (k = 0; k != count; ++k)
+	{
+		added[k] = new BP_Proxy(objects[k], *this, categories[k], masks[k]);
+		added[k]->append(min[k], max[k]);
+		proxies[k] = added[k];
+	}
+
+	DT_Count overlaps[3];
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		overlaps[i] = m_endpointList[i].merge(first);
+	}
+
+	// Sweep the axis on which the fewest intervals overlap, and test the 
+	// other two axes for the pairs found. Pairs of old proxies are skipped. 
+	int axis = overlaps[0] < overlaps[1] ? (overlaps[0] < overlaps[2] ? 0 : 2) : (overlaps[1] < overlaps[2] ? 1 : 2);
+	int j = (axis + 1) % 3;
+	int l = (axis + 2) % 3;
+	std::sort(added.begin(), added.end());
+
+	std::vector<BP_Proxy *> active;
+	const BP_EndpointList& list = m_endpointList[axis];
+	DT_Index index;
+	for (index = 0; index != list.size(); ++index)
+	{
+		const BP_Endpoint& endpoint = list[index];
+		BP_Proxy *proxy = endpoint.getProxy();
+		if (endpoint.isDead())
+		{
+		}
+		else if (endpoint.getType() == BP_Endpoint::MINIMUM)
+		{
+			bool is_new = first == 0 || std::binary_search(added.begin(), added.end(), proxy);
+			std::vector<BP_Proxy *>::const_iterator jt;
+			for (jt = active.begin(); jt != active.end(); ++jt)
+			{
+				if (proxy->accepts(**jt) &&
+					(is_new || std::binary_search(added.begin(), added.end(), *jt)) &&
+					proxy->overlaps(**jt, j) && proxy->overlaps(**jt, l))
+				{
+					callBeginOverlap(proxy->getObject(), (*jt)->getObject());
+				}
+			}
+			active.push_back(proxy);
+		}
+		else
+		{
+			std::vector<BP_Proxy *>::iterator jt = std::find(active.begin(), active.end(), proxy);
+			*jt = active.back();
+			active.pop_back();
+		}
+	}
+
+	for (k = 0; k != count; ++k)
+	{
+		updateStatics(added[k]);
+	}
+}
+
+BP_Scene::~BP_Scene()
+{
+	std::vector<BP_Proxy *>::iterator it;
+	for (it = m_deadList.begin(); it != m_deadList.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+void BP_Scene::findOverlapping(BP_Proxy *proxy, std::vector<BP_Proxy *>& proxies)
+{
+	int axis = 0;
+	int i;
+	for (i = 1; i < 3; ++i)
+	{
+		if (proxy->getMaxIndex(i) - proxy->getMinIndex(i) < 
+			proxy->getMaxIndex(axis) - proxy->getMinIndex(axis))
+		{
+			axis = i;
+		}
+	}
+	int j = (axis + 1) % 3;
+	int l = (axis + 2) % 3;
+
+	DT_Count count = DT_Count(proxies.size());
+	m_endpointList[axis].overlapping(proxy->getMinIndex(axis), 
+									 proxy->getMaxIndex(axis), proxies);
+
+	std::vector<BP_Proxy *>::iterator first = proxies.begin() + count;
+	std::vector<BP_Proxy *>::const_iterator it;
+	for (it = first; it != proxies.end(); ++it)
+	{
+		if (proxy->overlaps(**it, j) && proxy->overlaps(**it, l))
+		{
+			*first++ = *it;
+		}
+	}
+	proxies.erase(first, proxies.end());
+}
+
+void BP_Scene::findPartners(BP_ProxyBase *base, 
+							std::vector<BP_ProxyBase *>& partners)
+{
+	if (base->isStatic())
+	{
+		BP_StaticProxy *proxy = static_cast<BP_StaticProxy *>(base);
+
+		StaticCallback callback(m_statics, proxy);
+		m_staticTree.query(proxy->m_box, callback);
+		partners.insert(partners.end(), m_statics.begin(), m_statics.end());
+		partners.insert(partners.end(), proxy->m_partners.begin(), proxy->m_partners.end());
+		m_statics.clear();
+	}
+	else
+	{
+		BP_Proxy *proxy = static_cast<BP_Proxy *>(base);
+
+		findOverlapping(proxy, m_partners);
+		partners.insert(partners.end(), m_partners.begin(), m_partners.end());
+		partners.insert(partners.end(), proxy->getStatics().begin(), proxy->getStatics().end());
+		m_partners.clear();
+	}
+}
+
+// The overlaps are found on the axis on which the proxy spans the fewest 
+// endpoints, and the other two axes are tested. A destroyed proxy that is 
+// in the dirty list stays there. endUpdate skips it.
+void BP_Scene::removeProxy(BP_Proxy *proxy)
+{
+	findOverlapping(proxy, m_partners);
+
+	std::vector<BP_Proxy *>::const_iterator it;
+	for (it = m_partners.begin(); it != m_partners.end(); ++it)
+	{
+		endOverlap(proxy, *it);
+	}
+
+	m_partners.clear();
+
+	std::vector<BP_StaticProxy *>& statics = proxy->getStatics();
+	std::vector<BP_StaticProxy *>::const_iterator jt;
+	for (jt = statics.begin(); jt != statics.end(); ++jt)
+	{
+		endOverlap(proxy, *jt);
+		erase((*jt)->m_partners, proxy);
+	}
+	statics.clear();
+
+	proxy->remove();
+	m_deadList.push_back(proxy);
+}
+
+void BP_Scene::destroyProxy(BP_ProxyBase *proxy)
+{
+	if (proxy->isStatic())
+	{
+		removeStatic(static_cast<BP_StaticProxy *>(proxy));
+	}
+	else
+	{
+		removeProxy(static_cast<BP_Proxy *>(proxy));
+	}
+	collectGarbage();
+}
+
+void BP_Scene::destroyProxies(DT_Count count, BP_ProxyBase *const *proxies)
+{
+	DT_Count i;
+	for (i = 0; i != count; ++i)
+	{
+		if (proxies[i]->isStatic())
+		{
+			removeStatic(static_cast<BP_StaticProxy *>(proxies[i]));
+		}
+		else
+		{
+			removeProxy(static_cast<BP_Proxy *>(proxies[i]));
+		}
+	}
+	collectGarbage();
+}
+
+void BP_Scene::collectGarbage()
+{
+	if (!m_updating && 4 * m_deadList.size() > m_endpointList[0].size())
+	{
+		int i;
+		for (i = 0; i < 3; ++i)
+		{
+			m_endpointList[i].compact();
+		}
+
+		std::vector<BP_Proxy *>::iterator it;
+		for (it = m_deadList.begin(); it != m_deadList.end(); ++it)
+		{
+			delete *it;
+		}
+		m_deadList.clear();
+	}
+}
+
+DT_Count BP_Scene::estimateSwaps(DT_Count limit) const
+{
+	DT_Count stride = DT_Count(m_dirtyList.size()) / NUM_SAMPLES + 1;
+	DT_Count swaps = 0;
+	DT_Index i;
+	for (i = 0; i < m_dirtyList.size() && swaps <= limit; i += stride)
+	{
+		if (!m_dirtyList[i]->isDead())
+		{
+			swaps += m_dirtyList[i]->getTravel() * stride;
+		}
+	}
+	return swaps;
+}
+
+void BP_Scene::endUpdate()
+{
+	m_updating = false;
+
+	if (!m_dirtyList.empty())
+	{
+		DT_Count limit = REBUILD_SWAPS * 3 * m_endpointList[0].size();
+		if (m_updateMode == BP_UPDATE_REBUILD ||
+			(m_updateMode == BP_UPDATE_AUTO && estimateSwaps(limit) > limit))
+		{
+			rebuildLists();
+		}
+		else
+		{
+			resortLists();
+		}
+		
+		std::vector<BP_Proxy *>::iterator it;
+		for (it = m_dirtyList.begin(); it != m_dirtyList.end(); ++it)
+		{
+			if (!(*it)->isDead())
+			{
+				updateStatics(*it);
+			}
+			(*it)->clearDirty();
+		}
+		m_dirtyList.clear();
+	}
+
+	collectGarbage();
+}
+
+void BP_Scene::resortLists()
+{
+	static T_Overlap overlap[3] = { overlapYZ, overlapXZ, overlapXY };
+
+	// One axis at a time, so that the overlap tests see a sorted snapshot 
+	// of the other two axes.
+	int i;
+	for (i = 0; i < 3; ++i) 
+	{
+		std::vector<BP_Proxy *>::iterator it;
+		for (it = m_dirtyList.begin(); it != m_dirtyList.end(); ++it)
+		{
+			if (!(*it)->isDead())
+			{
+				(*it)->commitBBox(i);
+			}
+		}
+		m_endpointList[i].sort(*this, overlap[i]);
+	}
+}
+
+void BP_Scene::rebuildLists()
+{
+	std::vector<BP_ProxyPair> before;
+	findPairs(before);
+
+	std::vector<BP_Proxy *>::iterator it;
+	for (it = m_dirtyList.begin(); it != m_dirtyList.end(); ++it)
+	{
+		if (!(*it)->isDead())
+		{
+			int i;
+			for (i = 0; i < 3; ++i) 
+			{
+				(*it)->commitBBox(i);
+			}
+		}
+	}
+
+	int i;
+	for (i = 0; i < 3; ++i) 
+	{
+		m_endpointList[i].radixSort();
+	}
+
+	std::vector<BP_ProxyPair> after;
+	findPairs(after);
+
+	std::vector<BP_ProxyPair>::const_iterator first = before.begin();
+	std::vector<BP_ProxyPair>::const_iterator second = after.begin();
+	while (first != before.end() || second != after.end())
+	{
+		if (second == after.end() || (first != before.end() && *first < *second))
+		{
+			callEndOverlap((*first).first->getObject(), (*first).second->getObject());
+			++first;
+		}
+		else if (first == before.end() || *second < *first)
+		{
+			callBeginOverlap((*second).first->getObject(), (*second).second->getObject());
+			++second;
+		}
+		else
+		{
+			++first;
+			++second;
+		}
+	}
+}
+
+void BP_Scene::findPairs(std::vector<BP_ProxyPair>& pairs) const
+{
+	DT_Count overlaps[3];
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		overlaps[i] = m_endpointList[i].overlaps();
+	}
+
+	int axis = overlaps[0] < overlaps[1] ? (overlaps[0] < overlaps[2] ? 0 : 2) : (overlaps[1] < overlaps[2] ? 1 : 2);
+	int j = (axis + 1) % 3;
+	int l = (axis + 2) % 3;
+
+	std::vector<BP_Proxy *> active;
+	const BP_EndpointList& list = m_endpointList[axis];
+	DT_Index index;
+	for (index = 0; index != list.size(); ++index)
+	{
+		const BP_Endpoint& endpoint = list[index];
+		BP_Proxy *proxy = endpoint.getProxy();
+		if (endpoint.isDead())
+		{
+		}
+		else if (endpoint.getType() == BP_Endpoint::MINIMUM)
+		{
+			std::vector<BP_Proxy *>::const_iterator it;
+			for (it = active.begin(); it != active.end(); ++it)
+			{
+				if (proxy->accepts(**it) && 
+					proxy->overlaps(**it, j) && proxy->overlaps(**it, l))
+				{
+					pairs.push_back(proxy < *it ? BP_ProxyPair(proxy, *it) : BP_ProxyPair(*it, proxy));
+				}
+			}
+			active.push_back(proxy);
+		}
+		else
+		{
+			std::vector<BP_Proxy *>::iterator it = std::find(active.begin(), active.end(), proxy);
+			*it = active.back();
+			active.pop_back();
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end());
+}
+
+DT_Count BP_Scene::queryBox(const DT_Vector3 min, const DT_Vector3 max,
+							BP_QueryCallback callback, void *client_data) const
+{
+	BP_Box box(min, max);
+
+	QueryCallback static_callback(callback, client_data);
+	m_staticTree.query(box, static_callback);
+
+	std::vector<BP_Proxy *> proxies;
+	findMoving(box, proxies);
+
+	std::vector<BP_Proxy *>::const_iterator it;
+	for (it = proxies.begin(); it != proxies.end(); ++it)
+	{
+		(*callback)(client_data, (*it)->getObject());
+	}
+
+	return static_callback.getCount() + DT_Count(proxies.size());
+}
+
 void *BP_Scene::rayCast(BP_RayCastCallback objectRayCast,
 						void *client_data,
 						const DT_Vector3 source, 
@@ -73,6 +773,14 @@ void *BP_Scene::rayCast(BP_RayCastCallback objectRayCast,
 						DT_Scalar& lambda) const 
 {
 	void *client_object = 0;
+
+	// The static proxies first, so that a hit shortens the sweep.
+	if (!m_staticTree.empty())
+	{
+		RayCastCallback callback(objectRayCast, client_data, source, target);
+		m_staticTree.rayCast(source, target, lambda, callback);
+		client_object = callback.getClientObject();
+	}
 	
 	DT_Index index[3];
 	index[0] = m_endpointList[0].stab(source[0], m_proxies);
@@ -106,7 +814,10 @@ void *BP_Scene::rayCast(BP_RayCastCallback objectRayCast,
 		{
 			const BP_Endpoint& endpoint = m_endpointList[closest][index[closest]];
 
-			if (endpoint.getType() == BP_Endpoint::MAXIMUM) 
+			if (endpoint.isDead())
+			{
+			}
+			else if (endpoint.getType() == BP_Endpoint::MAXIMUM) 
 			{
 				it = m_proxies.add(endpoint.getProxy());
 				if ((*it).second == 3 &&
@@ -124,7 +835,10 @@ void *BP_Scene::rayCast(BP_RayCastCallback objectRayCast,
 		{
 			const BP_Endpoint& endpoint = m_endpointList[closest][index[closest] - 1];
 			
-			if (endpoint.getType() == BP_Endpoint::MINIMUM) 
+			if (endpoint.isDead())
+			{
+			}
+			else if (endpoint.getType() == BP_Endpoint::MINIMUM) 
 			{
 				it = m_proxies.add(endpoint.getProxy());
 				if ((*it).second == 3 &&
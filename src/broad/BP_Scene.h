@@ -24,56 +24,165 @@
 #ifndef BP_SCENE_H
 #define BP_SCENE_H
 
-#include <SOLID_broad.h>
+#include <vector>
 
+#include "BP_SceneBase.h"
 #include "BP_EndpointList.h"
 #include "BP_ProxyList.h"
+#include "BP_DynamicTree.h"
 
 class BP_Proxy;
+class BP_Scene;
 
-class BP_Scene {
+// A proxy of an object that rarely moves, such as a wall. Static proxies 
+// are kept in a tree of their boxes instead of in the endpoint lists, so 
+// that the endpoints of moving proxies do not have to pass them. Overlaps 
+// with moving proxies are found by querying the tree for the proxies that 
+// moved. A static proxy keeps the moving proxies it overlaps.
+
+class BP_StaticProxy : public BP_ProxyBase {
+public:
+	BP_StaticProxy(void *object, BP_Scene& scene, const BP_Box& box,
+				   DT_Mask category, DT_Mask mask) 
+	  : BP_ProxyBase(object, category, mask),
+		m_scene(scene),
+		m_box(box),
+		m_leaf(BP_DynamicTree::NIL)
+	{}
+
+	virtual void setBBox(const DT_Vector3 min, const DT_Vector3 max);
+	
+	virtual bool isStatic() const { return true; }
+
+	const BP_Box& getBox() const { return m_box; }
+
+private:
+	friend class BP_Scene;
+
+	BP_Scene&                m_scene;
+	BP_Box                   m_box;
+	int                      m_leaf;
+	std::vector<BP_Proxy *>  m_partners;
+};
+
+typedef std::pair<BP_Proxy *, BP_Proxy *> BP_ProxyPair;
+
+// Sweep and prune: the intervals of the boxes on each axis are kept in a 
+// sorted list of endpoints. Pairs start or stop overlapping as endpoints 
+// pass each other.
+
+class BP_Scene : public BP_SceneBase {
 public:
     BP_Scene(void *client_data,
 			 BP_Callback beginOverlap,
 			 BP_Callback endOverlap) 
-      :	m_client_data(client_data),
-		m_beginOverlap(beginOverlap),
-		m_endOverlap(endOverlap),
-		m_proxies(20)
+      :	BP_SceneBase(client_data, beginOverlap, endOverlap),
+		m_proxies(20),
+		m_updating(false),
+		m_updateMode(BP_UPDATE_AUTO)
 	{}
 
-    ~BP_Scene() {}
+	virtual ~BP_Scene();
 
-    BP_Proxy *createProxy(void *object, 
-						  const DT_Vector3 min,
-						  const DT_Vector3 max);
+    virtual BP_ProxyBase *createProxy(void *object, 
+									  const DT_Vector3 min,
+									  const DT_Vector3 max,
+									  DT_Mask category,
+									  DT_Mask mask);
 
-    void destroyProxy(BP_Proxy *proxy);
-	
-	void *rayCast(BP_RayCastCallback objectRayCast,
-				  void *client_data,
-				  const DT_Vector3 source, 
-				  const DT_Vector3 target, 
-				  DT_Scalar& lambda) const;
-	
-  	void callBeginOverlap(void *object1, void *object2) 
-	{
-		(*m_beginOverlap)(m_client_data, object1, object2);
-	}
+    virtual BP_ProxyBase *createStaticProxy(void *object, 
+											const DT_Vector3 min,
+											const DT_Vector3 max,
+											DT_Mask category,
+											DT_Mask mask);
+
+	virtual void createProxies(DT_Count count, void *const *objects,
+							   const DT_Vector3 *min, const DT_Vector3 *max,
+							   const DT_Mask *categories, const DT_Mask *masks,
+							   BP_ProxyBase **proxies);
+
+    virtual void destroyProxy(BP_ProxyBase *proxy);
+	virtual void destroyProxies(DT_Count count, BP_ProxyBase *const *proxies);
+
+	virtual void beginUpdate() { m_updating = true; }
+	virtual void endUpdate();
+
+	virtual bool isUpdating() const { return m_updating; }
+
+	virtual void setUpdateMode(BP_UpdateMode mode) { m_updateMode = mode; }
+
+	void addDirty(BP_Proxy *proxy) { m_dirtyList.push_back(proxy); }
 	
-	void callEndOverlap(void *object1, void *object2) 
-	{
-		(*m_endOverlap)(m_client_data, object1, object2);
-	}
+	virtual void *rayCast(BP_RayCastCallback objectRayCast,
+						  void *client_data,
+						  const DT_Vector3 source, 
+						  const DT_Vector3 target, 
+						  DT_Scalar& lambda) const;
+
+	virtual DT_Count queryBox(const DT_Vector3 min, const DT_Vector3 max,
+							  BP_QueryCallback callback, 
+							  void *client_data) const;
 	
 	BP_EndpointList& getList(int i) { return m_endpointList[i]; }
 
+	// Begins and ends the overlaps of a moving proxy with the static 
+	// proxies, after the proxy has moved.
+	void updateStatics(BP_Proxy *proxy);
+
+	void moveStatic(BP_StaticProxy *proxy, const BP_Box& box);
+
+protected:
+	virtual void findPartners(BP_ProxyBase *proxy, 
+							  std::vector<BP_ProxyBase *>& partners);
+
 private:
-	void                    *m_client_data;
-	BP_Callback              m_beginOverlap; 
-	BP_Callback              m_endOverlap; 
+	class StaticCallback;
+	class RayCastCallback;
+	class QueryCallback;
+
+	// Collects the moving proxies whose boxes overlap the box of a moving
+	// proxy, on the axis on which the proxy spans the fewest endpoints.
+	void findOverlapping(BP_Proxy *proxy, std::vector<BP_Proxy *>& proxies);
+
+	void removeProxy(BP_Proxy *proxy);
+	void removeStatic(BP_StaticProxy *proxy);
+
+	// Collects the moving proxies whose boxes overlap the given box.
+	void findMoving(const BP_Box& box, std::vector<BP_Proxy *>& proxies) const;
+
+	// Erases the endpoints of the destroyed proxies once they make up half
+	// of the lists. Not during an update, since the dirty list may still 
+	// hold destroyed proxies.
+	void collectGarbage();
+
+	// Re-sorting is cheaper than a rebuild as long as the endpoints pass 
+	// fewer than REBUILD_SWAPS other endpoints per endpoint on average.
+	enum { REBUILD_SWAPS = 32, NUM_SAMPLES = 1024 };
+
+	// Estimates the number of swaps re-sorting the lists would take, from 
+	// at most NUM_SAMPLES dirty proxies. Stops counting once limit is 
+	// exceeded.
+	DT_Count estimateSwaps(DT_Count limit) const;
+
+	void resortLists();
+
+	// Sorts the lists with a radix sort, and reports the difference between 
+	// the overlapping pairs found by a sweep before and after.
+	void rebuildLists();
+
+	// Collects the overlapping pairs that the filters accept by a sweep 
+	// along the axis on which the fewest intervals overlap. 
+	void findPairs(std::vector<BP_ProxyPair>& pairs) const;
+
     BP_EndpointList          m_endpointList[3];
 	mutable BP_ProxyList     m_proxies;
+	std::vector<BP_Proxy *>  m_dirtyList;
+	std::vector<BP_Proxy *>  m_deadList;
+	std::vector<BP_Proxy *>  m_partners;
+	BP_DynamicTree           m_staticTree;
+	std::vector<BP_StaticProxy *>  m_statics;
+	bool                     m_updating;
+	BP_UpdateMode            m_updateMode;
 };
 
 #endif
@@ -0,0 +1,84 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "BP_SceneBase.h"
+
+#include <algorithm>
+
+static bool operator<(const BP_Pair& a, const BP_Pair& b)
+{
+	return a.object1 < b.object1 || 
+		(a.object1 == b.object1 && a.object2 < b.object2);
+}
+
+// The begins and ends of a pair alternate, so the pairs that are in both 
+// lists as often cancel out. What remains of a pair is one begin or one end.
+void BP_SceneBase::foldPairs()
+{
+	std::sort(m_begins.begin(), m_begins.end());
+	std::sort(m_ends.begin(), m_ends.end());
+
+	std::vector<BP_Pair>::iterator begin_out = m_begins.begin();
+	std::vector<BP_Pair>::iterator end_out = m_ends.begin();
+	std::vector<BP_Pair>::const_iterator first = m_begins.begin();
+	std::vector<BP_Pair>::const_iterator second = m_ends.begin();
+	while (first != m_begins.end() || second != m_ends.end())
+	{
+		if (second == m_ends.end() || (first != m_begins.end() && *first < *second))
+		{
+			*begin_out++ = *first;
+			++first;
+		}
+		else if (first == m_begins.end() || *second < *first)
+		{
+			*end_out++ = *second;
+			++second;
+		}
+		else
+		{
+			++first;
+			++second;
+		}
+	}
+
+	m_begins.erase(begin_out, m_begins.end());
+	m_ends.erase(end_out, m_ends.end());
+	m_foldLimit = 2 * DT_Count(m_begins.size() + m_ends.size()) + MinFoldLimit;
+}
+
+void BP_SceneBase::getPairDelta(const BP_Pair *& begins, DT_Count& num_begins,
+								const BP_Pair *& ends, DT_Count& num_ends)
+{
+	foldPairs();
+
+	m_beginDelta.assign(m_begins.begin(), m_begins.end());
+	m_endDelta.assign(m_ends.begin(), m_ends.end());
+	m_begins.clear();
+	m_ends.clear();
+	m_foldLimit = MinFoldLimit;
+
+	begins = m_beginDelta.empty() ? 0 : &m_beginDelta[0];
+	num_begins = DT_Count(m_beginDelta.size());
+	ends = m_endDelta.empty() ? 0 : &m_endDelta[0];
+	num_ends = DT_Count(m_endDelta.size());
+}
@@ -0,0 +1,279 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef BP_SCENEBASE_H
+#define BP_SCENEBASE_H
+
+#include <SOLID_broad.h>
+
+#include <vector>
+
+// A pair of proxies is reported only if the category of each proxy shares 
+// a bit with the mask of the other.
+inline bool BP_accepts(DT_Mask category1, DT_Mask mask1, 
+					   DT_Mask category2, DT_Mask mask2)
+{
+	return (category1 & mask2) != 0 && (category2 & mask1) != 0;
+}
+
+// The interface shared by the broad phase methods. A proxy is the box of a 
+// client object in a scene. A scene reports the pairs of proxies whose 
+// boxes start or stop overlapping through its callbacks.
+
+class BP_ProxyBase {
+public:
+	BP_ProxyBase(void *object, DT_Mask category, DT_Mask mask) 
+	  : m_object(object),
+		m_category(category),
+		m_mask(mask)
+	{}
+
+	virtual ~BP_ProxyBase() {}
+
+	virtual void setBBox(const DT_Vector3 min, const DT_Vector3 max) = 0;
+
+	virtual bool isStatic() const { return false; }
+
+    void *getObject() { return m_object; }
+
+	DT_Mask getCategory() const { return m_category; }
+	DT_Mask getMask() const { return m_mask; }
+
+	// Only the scene may change the filter, since it has to report the 
+	// pairs that the change lets through or holds back.
+	void setFilter(DT_Mask category, DT_Mask mask) 
+	{
+		m_category = category;
+		m_mask = mask;
+	}
+
+	bool accepts(const BP_ProxyBase& proxy) const
+	{
+		return BP_accepts(m_category, m_mask, proxy.m_category, proxy.m_mask);
+	}
+
+private:
+    void    *m_object;
+	DT_Mask  m_category;
+	DT_Mask  m_mask;
+};
+
+class BP_SceneBase {
+public:
+    BP_SceneBase(void *client_data,
+				 BP_Callback beginOverlap,
+				 BP_Callback endOverlap) 
+      :	m_client_data(client_data),
+		m_beginOverlap(beginOverlap),
+		m_endOverlap(endOverlap),
+		m_reportMode(BP_REPORT_CALLBACKS),
+		m_foldLimit(MinFoldLimit)
+	{}
+
+	virtual ~BP_SceneBase() {}
+
+    virtual BP_ProxyBase *createProxy(void *object, 
+									  const DT_Vector3 min,
+									  const DT_Vector3 max,
+									  DT_Mask category,
+									  DT_Mask mask) = 0;
+
+	// A scene that does not keep static proxies apart creates an ordinary 
+	// proxy.
+	virtual BP_ProxyBase *createStaticProxy(void *object, 
+											const DT_Vector3 min,
+											const DT_Vector3 max,
+											DT_Mask category,
+											DT_Mask mask)
+	{
+		return createProxy(object, min, max, category, mask);
+	}
+
+	// Creates the proxies one by one. 
+	virtual void createProxies(DT_Count count, void *const *objects,
+							   const DT_Vector3 *min, const DT_Vector3 *max,
+							   const DT_Mask *categories, const DT_Mask *masks,
+							   BP_ProxyBase **proxies)
+	{
+		DT_Count i;
+		for (i = 0; i != count; ++i)
+		{
+			proxies[i] = createProxy(objects[i], min[i], max[i], 
+									 categories[i], masks[i]);
+		}
+	}
+
+    virtual void destroyProxy(BP_ProxyBase *proxy) = 0;
+
+	// Destroys the proxies one by one. 
+	virtual void destroyProxies(DT_Count count, BP_ProxyBase *const *proxies)
+	{
+		DT_Count i;
+		for (i = 0; i != count; ++i)
+		{
+			destroyProxy(proxies[i]);
+		}
+	}
+
+	virtual void beginUpdate() = 0;
+	virtual void endUpdate() = 0;
+	virtual bool isUpdating() const = 0;
+
+	// Changes the filter of the proxy, and ends or begins the overlaps 
+	// with the proxies whose boxes overlap, as the filter now holds them 
+	// back or lets them through.
+	void setFilter(BP_ProxyBase *proxy, DT_Mask category, DT_Mask mask)
+	{
+		std::vector<BP_ProxyBase *> partners;
+		findPartners(proxy, partners);
+
+		std::vector<BP_ProxyBase *>::const_iterator it;
+		for (it = partners.begin(); it != partners.end(); ++it)
+		{
+			bool before = proxy->accepts(**it);
+			bool after = BP_accepts(category, mask, (*it)->getCategory(), (*it)->getMask());
+			if (before && !after)
+			{
+				callEndOverlap(proxy->getObject(), (*it)->getObject());
+			}
+			else if (after && !before)
+			{
+				callBeginOverlap(proxy->getObject(), (*it)->getObject());
+			}
+		}
+
+		proxy->setFilter(category, mask);
+	}
+
+	// Only a sweep-and-prune scene has a choice.
+	virtual void setUpdateMode(BP_UpdateMode) {}
+
+	virtual void *rayCast(BP_RayCastCallback objectRayCast,
+						  void *client_data,
+						  const DT_Vector3 source, 
+						  const DT_Vector3 target, 
+						  DT_Scalar& lambda) const = 0;
+
+	// Calls the callback for each proxy whose box overlaps the given box, 
+	// and returns the number of proxies. Leaves the scene untouched, so 
+	// that several threads may query a scene at once.
+	virtual DT_Count queryBox(const DT_Vector3 min, const DT_Vector3 max,
+							  BP_QueryCallback callback, 
+							  void *client_data) const = 0;
+	
+	void setReportMode(BP_ReportMode mode) { m_reportMode = mode; }
+
+	// Returns the pairs that began and ended overlapping since the last 
+	// call. A pair that both began and ended in between is left out. The 
+	// arrays are kept until the next call.
+	void getPairDelta(const BP_Pair *& begins, DT_Count& num_begins,
+					  const BP_Pair *& ends, DT_Count& num_ends);
+
+  	void callBeginOverlap(void *object1, void *object2) 
+	{
+		if (m_reportMode == BP_REPORT_DELTA)
+		{
+			m_begins.push_back(makePair(object1, object2));
+			if (DT_Count(m_begins.size() + m_ends.size()) > m_foldLimit)
+			{
+				foldPairs();
+			}
+		}
+		else
+		{
+			(*m_beginOverlap)(m_client_data, object1, object2);
+		}
+	}
+	
+	void callEndOverlap(void *object1, void *object2) 
+	{
+		if (m_reportMode == BP_REPORT_DELTA)
+		{
+			m_ends.push_back(makePair(object1, object2));
+			if (DT_Count(m_begins.size() + m_ends.size()) > m_foldLimit)
+			{
+				foldPairs();
+			}
+		}
+		else
+		{
+			(*m_endOverlap)(m_client_data, object1, object2);
+		}
+	}
+
+	// Report a pair of overlapping proxies only if their filters accept 
+	// each other.
+	void beginOverlap(BP_ProxyBase *proxy1, BP_ProxyBase *proxy2) 
+	{
+		if (proxy1->accepts(*proxy2))
+		{
+			callBeginOverlap(proxy1->getObject(), proxy2->getObject());
+		}
+	}
+	
+	void endOverlap(BP_ProxyBase *proxy1, BP_ProxyBase *proxy2) 
+	{
+		if (proxy1->accepts(*proxy2))
+		{
+			callEndOverlap(proxy1->getObject(), proxy2->getObject());
+		}
+	}
+
+protected:
+	// Collects the proxies whose boxes overlap the box of the proxy, as 
+	// far as the overlaps have been reported.
+	virtual void findPartners(BP_ProxyBase *proxy, 
+							  std::vector<BP_ProxyBase *>& partners) = 0;
+
+private:
+	// The pending pairs are folded once they outnumber twice the pairs that
+	// remained after the last fold by this many.
+	enum { MinFoldLimit = 1024 };
+
+	// Cancels the begins and ends of the same pairs in the pending lists, 
+	// so that each pair is pending at most once. Keeps the lists bounded 
+	// in scenes that move for long without asking for the delta.
+	void foldPairs();
+
+	// The objects of a pair are put in order of address, so that the 
+	// begin and end of a pair can be matched.
+	static BP_Pair makePair(void *object1, void *object2)
+	{
+		BP_Pair pair;
+		pair.object1 = object1 < object2 ? object1 : object2;
+		pair.object2 = object1 < object2 ? object2 : object1;
+		return pair;
+	}
+
+	void                  *m_client_data;
+	BP_Callback            m_beginOverlap; 
+	BP_Callback            m_endOverlap; 
+	BP_ReportMode          m_reportMode;
+	std::vector<BP_Pair>   m_begins;
+	std::vector<BP_Pair>   m_ends;
+	DT_Count               m_foldLimit;
+	std::vector<BP_Pair>   m_beginDelta;
+	std::vector<BP_Pair>   m_endDelta;
+};
+
+#endif
@@ -0,0 +1,357 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "BP_TreeScene.h"
+
+#include <algorithm>
+
+// The margin by which the boxes in the tree are enlarged, relative to the 
+// longest side of the box.
+static const DT_Scalar FAT_MARGIN = DT_Scalar(0.25);
+
+void BP_TreeProxy::setBBox(const DT_Vector3 min, const DT_Vector3 max)
+{
+	m_scene.moveProxy(this, BP_Box(min, max));
+}
+
+BP_TreePartner& BP_TreeProxy::findPartner(BP_TreeProxy *proxy)
+{
+	std::vector<BP_TreePartner>::iterator it = m_partners.begin();
+	while ((*it).m_proxy != proxy)
+	{
+		++it;
+		assert(it != m_partners.end());
+	}
+	return *it;
+}
+
+void BP_TreeProxy::removePartner(BP_TreeProxy *proxy)
+{
+	findPartner(proxy) = m_partners.back();
+	m_partners.pop_back();
+}
+
+class BP_TreeScene::PartnerCallback {
+public:
+	PartnerCallback(BP_TreeProxy *proxy) : m_proxy(proxy) {}
+
+	void operator()(void *data)
+	{
+		BP_TreeProxy *other = static_cast<BP_TreeProxy *>(data);
+		if (other->m_mark != m_proxy->m_mark)
+		{
+			other->m_mark = m_proxy->m_mark;
+			m_proxy->m_partners.push_back(BP_TreePartner(other));
+			other->m_partners.push_back(BP_TreePartner(m_proxy));
+		}
+	}
+
+private:
+	BP_TreeProxy *m_proxy;
+};
+
+class BP_TreeScene::MarkCallback {
+public:
+	void operator()(void *data)
+	{
+		static_cast<BP_TreeProxy *>(data)->m_mark = 0;
+	}
+};
+
+// The leaves hold enlarged boxes, so the actual box is tested before the 
+// proxy is passed on to the client.
+class BP_TreeScene::QueryCallback {
+public:
+	QueryCallback(const BP_Box& box, BP_QueryCallback callback, void *client_data) 
+	  : m_box(box),
+		m_callback(callback),
+		m_client_data(client_data),
+		m_count(0)
+	{}
+
+	void operator()(void *data)
+	{
+		BP_TreeProxy *proxy = static_cast<BP_TreeProxy *>(data);
+		if (proxy->getBox().overlaps(m_box))
+		{
+			(*m_callback)(m_client_data, proxy->getObject());
+			++m_count;
+		}
+	}
+
+	DT_Count getCount() const { return m_count; }
+
+private:
+	const BP_Box&     m_box;
+	BP_QueryCallback  m_callback;
+	void             *m_client_data;
+	DT_Count          m_count;
+};
+
+class BP_TreeScene::RayCastCallback {
+public:
+	RayCastCallback(BP_RayCastCallback objectRayCast, void *client_data, 
+					const DT_Vector3 source, const DT_Vector3 target) 
+	  : m_objectRayCast(objectRayCast),
+		m_client_data(client_data),
+		m_source(source),
+		m_target(target),
+		m_client_object(0)
+	{
+		m_delta[0] = target[0] - source[0];
+		m_delta[1] = target[1] - source[1];
+		m_delta[2] = target[2] - source[2];
+	}
+
+	void operator()(void *data, DT_Scalar& lambda)
+	{
+		BP_TreeProxy *proxy = static_cast<BP_TreeProxy *>(data);
+		if (proxy->getBox().clip(m_source, m_delta, lambda) &&
+			(*m_objectRayCast)(m_client_data, proxy->getObject(), m_source, m_target, &lambda))
+		{
+			m_client_object = proxy->getObject();
+		}
+	}
+
+	void *getClientObject() const { return m_client_object; }
+
+private:
+	BP_RayCastCallback  m_objectRayCast;
+	void               *m_client_data;
+	const DT_Scalar    *m_source;
+	const DT_Scalar    *m_target;
+	DT_Vector3          m_delta;
+	void               *m_client_object;
+};
+
+BP_Box BP_TreeScene::fatten(const BP_Box& box)
+{
+	DT_Scalar size = DT_Scalar(0.0);
+	int i;
+	for (i = 0; i < 3; ++i)
+	{
+		if (size < box.m_max[i] - box.m_min[i])
+		{
+			size = box.m_max[i] - box.m_min[i];
+		}
+	}
+	BP_Box result = box;
+	result.fatten(FAT_MARGIN * size);
+	return result;
+}
+
+// Returns a mark that no proxy has. When the counter wraps around, the 
+// marks of all proxies are cleared.
+unsigned int BP_TreeScene::nextMark()
+{
+	if (++m_mark == 0)
+	{
+		DT_Vector3 min = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		DT_Vector3 max = {  FLT_MAX,  FLT_MAX,  FLT_MAX };
+		MarkCallback callback;
+		m_tree.query(BP_Box(min, max), callback);
+		m_mark = 1;
+	}
+	return m_mark;
+}
+
+// Drops the partners whose leaves no longer overlap the leaf of the proxy
+// and adds the new ones. The current partners are marked, so that the tree 
+// query skips them. 
+void BP_TreeScene::updatePartners(BP_TreeProxy *proxy)
+{
+	unsigned int mark = nextMark();
+	proxy->m_mark = mark;
+
+	const BP_Box& leaf_box = m_tree.getBox(proxy->m_leaf);
+	std::vector<BP_TreePartner>& partners = proxy->m_partners;
+	size_t i = 0;
+	while (i != partners.size())
+	{
+		BP_TreeProxy *other = partners[i].m_proxy;
+		if (leaf_box.overlaps(m_tree.getBox(other->m_leaf)))
+		{
+			other->m_mark = mark;
+			++i;
+		}
+		else
+		{
+			if (partners[i].m_overlap)
+			{
+				endOverlap(proxy, other);
+			}
+			other->removePartner(proxy);
+			partners[i] = partners.back();
+			partners.pop_back();
+		}
+	}
+
+	PartnerCallback callback(proxy);
+	m_tree.query(leaf_box, callback);
+	proxy->m_moved = false;
+}
+
+// Begins and ends the overlaps of the proxy with its partners.
+void BP_TreeScene::updateOverlaps(BP_TreeProxy *proxy)
+{
+	if (proxy->m_moved)
+	{
+		updatePartners(proxy);
+	}
+
+	std::vector<BP_TreePartner>::iterator it;
+	for (it = proxy->m_partners.begin(); it != proxy->m_partners.end(); ++it)
+	{
+		BP_TreeProxy *other = (*it).m_proxy;
+		bool overlap = proxy->m_box.overlaps(other->m_box);
+		if (overlap != (*it).m_overlap)
+		{
+			(*it).m_overlap = overlap;
+			other->findPartner(proxy).m_overlap = overlap;
+			if (overlap)
+			{
+				beginOverlap(proxy, other);
+			}
+			else
+			{
+				endOverlap(proxy, other);
+			}
+		}
+	}
+}
+
+BP_ProxyBase *BP_TreeScene::createProxy(void *object, 
+										const DT_Vector3 min,
+										const DT_Vector3 max,
+										DT_Mask category,
+										DT_Mask mask)
+{
+	BP_TreeProxy *proxy = new BP_TreeProxy(object, *this, BP_Box(min, max), 
+										   category, mask);
+	proxy->m_leaf = m_tree.insert(fatten(proxy->m_box), proxy);
+	proxy->m_moved = true;
+	updateOverlaps(proxy);
+	return proxy;
+}
+
+// The partners whose actual boxes overlap are the ones that have been 
+// reported.
+void BP_TreeScene::findPartners(BP_ProxyBase *base, 
+								std::vector<BP_ProxyBase *>& partners)
+{
+	BP_TreeProxy *proxy = static_cast<BP_TreeProxy *>(base);
+
+	std::vector<BP_TreePartner>::const_iterator it;
+	for (it = proxy->m_partners.begin(); it != proxy->m_partners.end(); ++it)
+	{
+		if ((*it).m_overlap)
+		{
+			partners.push_back((*it).m_proxy);
+		}
+	}
+}
+
+void BP_TreeScene::destroyProxy(BP_ProxyBase *base)
+{
+	BP_TreeProxy *proxy = static_cast<BP_TreeProxy *>(base);
+
+	if (proxy->m_dirty != -1)
+	{
+		BP_TreeProxy *last = m_dirtyList.back();
+		m_dirtyList[proxy->m_dirty] = last;
+		last->m_dirty = proxy->m_dirty;
+		m_dirtyList.pop_back();
+	}
+
+	std::vector<BP_TreePartner>::iterator it;
+	for (it = proxy->m_partners.begin(); it != proxy->m_partners.end(); ++it)
+	{
+		(*it).m_proxy->removePartner(proxy);
+		if ((*it).m_overlap)
+		{
+			endOverlap(proxy, (*it).m_proxy);
+		}
+	}
+
+	m_tree.remove(proxy->m_leaf);
+
+	delete proxy;
+}
+
+// The tree is updated right away, so that ray casts see the new box. During 
+// a batch update, the overlaps are updated in endUpdate.
+void BP_TreeScene::moveProxy(BP_TreeProxy *proxy, const BP_Box& box)
+{
+	proxy->m_box = box;
+	if (!m_tree.getBox(proxy->m_leaf).contains(box))
+	{
+		m_tree.move(proxy->m_leaf, fatten(box));
+		proxy->m_moved = true;
+	}
+
+	if (m_updating)
+	{
+		if (proxy->m_dirty == -1)
+		{
+			proxy->m_dirty = int(m_dirtyList.size());
+			m_dirtyList.push_back(proxy);
+		}
+	}
+	else
+	{
+		updateOverlaps(proxy);
+	}
+}
+
+void BP_TreeScene::endUpdate()
+{
+	m_updating = false;
+
+	std::vector<BP_TreeProxy *>::iterator it;
+	for (it = m_dirtyList.begin(); it != m_dirtyList.end(); ++it)
+	{
+		updateOverlaps(*it);
+		(*it)->m_dirty = -1;
+	}
+	m_dirtyList.clear();
+}
+
+DT_Count BP_TreeScene::queryBox(const DT_Vector3 min, const DT_Vector3 max,
+								BP_QueryCallback callback, void *client_data) const
+{
+	BP_Box box(min, max);
+	QueryCallback query_callback(box, callback, client_data);
+	m_tree.query(box, query_callback);
+	return query_callback.getCount();
+}
+
+void *BP_TreeScene::rayCast(BP_RayCastCallback objectRayCast,
+							void *client_data,
+							const DT_Vector3 source, 
+							const DT_Vector3 target, 
+							DT_Scalar& lambda) const 
+{
+	RayCastCallback callback(objectRayCast, client_data, source, target);
+	m_tree.rayCast(source, target, lambda, callback);
+	return callback.getClientObject();
+}
@@ -0,0 +1,141 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef BP_TREESCENE_H
+#define BP_TREESCENE_H
+
+#include <vector>
+
+#include "BP_SceneBase.h"
+#include "BP_DynamicTree.h"
+
+class BP_TreeScene;
+class BP_TreeProxy;
+
+// A proxy whose box in the tree overlaps the box in the tree of another 
+// proxy, and whether the actual boxes of the two overlap.
+struct BP_TreePartner {
+	BP_TreePartner(BP_TreeProxy *proxy) : m_proxy(proxy), m_overlap(false) {}
+
+	BP_TreeProxy *m_proxy;
+	bool          m_overlap;
+};
+
+class BP_TreeProxy : public BP_ProxyBase {
+public:
+	BP_TreeProxy(void *object, BP_TreeScene& scene, const BP_Box& box,
+				 DT_Mask category, DT_Mask mask) 
+	  : BP_ProxyBase(object, category, mask),
+		m_scene(scene),
+		m_box(box),
+		m_leaf(BP_DynamicTree::NIL),
+		m_mark(0),
+		m_dirty(-1),
+		m_moved(false)
+	{}
+
+	virtual void setBBox(const DT_Vector3 min, const DT_Vector3 max);
+
+	const BP_Box& getBox() const { return m_box; }
+
+private:
+	friend class BP_TreeScene;
+
+	BP_TreePartner& findPartner(BP_TreeProxy *proxy);
+	void removePartner(BP_TreeProxy *proxy);
+
+	BP_TreeScene&                m_scene;
+	BP_Box                       m_box;
+	int                          m_leaf;
+	std::vector<BP_TreePartner>  m_partners;
+	unsigned int                 m_mark;
+	int                          m_dirty;  // the index in the dirty list, or -1
+	bool                         m_moved;  // the box in the tree has changed
+};
+
+// A dynamic tree of boxes. The leaves hold the boxes of the proxies, 
+// enlarged by a margin, so that a proxy that moves a little stays in its 
+// leaf. Each proxy keeps the proxies whose leaves overlap its leaf. Only a 
+// proxy that leaves its leaf queries the tree for new partners; otherwise, 
+// an update only tests the actual boxes of the partners. Unlike sweep and 
+// prune, the cost of an update does not depend on how far a proxy moves or 
+// on how many boxes share an interval on one axis.
+
+class BP_TreeScene : public BP_SceneBase {
+public:
+    BP_TreeScene(void *client_data,
+				 BP_Callback beginOverlap,
+				 BP_Callback endOverlap) 
+      :	BP_SceneBase(client_data, beginOverlap, endOverlap),
+		m_mark(0),
+		m_updating(false)
+	{}
+
+    virtual BP_ProxyBase *createProxy(void *object, 
+									  const DT_Vector3 min,
+									  const DT_Vector3 max,
+									  DT_Mask category,
+									  DT_Mask mask);
+
+    virtual void destroyProxy(BP_ProxyBase *proxy);
+
+	virtual void beginUpdate() { m_updating = true; }
+	virtual void endUpdate();
+
+	virtual bool isUpdating() const { return m_updating; }
+
+	virtual void *rayCast(BP_RayCastCallback objectRayCast,
+						  void *client_data,
+						  const DT_Vector3 source, 
+						  const DT_Vector3 target, 
+						  DT_Scalar& lambda) const;
+
+	virtual DT_Count queryBox(const DT_Vector3 min, const DT_Vector3 max,
+							  BP_QueryCallback callback, 
+							  void *client_data) const;
+
+	void moveProxy(BP_TreeProxy *proxy, const BP_Box& box);
+
+protected:
+	virtual void findPartners(BP_ProxyBase *proxy, 
+							  std::vector<BP_ProxyBase *>& partners);
+
+private:
+	class PartnerCallback;
+	class MarkCallback;
+	class RayCastCallback;
+	class QueryCallback;
+
+	static BP_Box fatten(const BP_Box& box);
+
+	unsigned int nextMark();
+	void updatePartners(BP_TreeProxy *proxy);
+	void updateOverlaps(BP_TreeProxy *proxy);
+
+	BP_DynamicTree               m_tree;
+	std::vector<BP_TreeProxy *>  m_dirtyList;
+	unsigned int                 m_mark;
+	bool                         m_updating;
+};
+
+#endif
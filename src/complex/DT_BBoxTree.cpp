@@ -37,10 +37,15 @@ inline DT_CBox getBBox(int first, int last, const DT_CBox *boxes, const DT_Index
 	return bbox;
 }
 
-DT_BBoxNode::DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes, const DT_CBox *boxes, DT_Index *indices, const DT_CBox& bbox)
+#ifdef STATISTICS
+int num_box_tests = 0;
+#endif
+
+// Splits at the center of the longest axis of the node's box. Falls back 
+// to the middle index if all leaves end up on one side.
+
+static int splitMidpoint(int first, int last, const DT_CBox *boxes, DT_Index *indices, const DT_CBox& bbox)
 {
-	assert(last - first >= 2);
-	
 	int axis = bbox.longestAxis();
 	MT_Scalar abscissa = bbox.getCenter()[axis];
 	int i = first, mid = last;
@@ -61,6 +66,131 @@ DT_BBoxNode::DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes
 	{
 		mid = (first + last) / 2;
 	}
+
+	return mid;
+}
+
+const int NUM_BINS = 16;
+
+inline int binIndex(MT_Scalar x, MT_Scalar lower, MT_Scalar scale)
+{
+	int bin = int((x - lower) * scale);
+	return bin < NUM_BINS ? bin : NUM_BINS - 1;
+}
+
+// Half the surface area of a box, which is all the heuristic needs.
+inline MT_Scalar halfArea(const MT_BBox& bbox)
+{
+	MT_Vector3 e = bbox.getExtent();
+	return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+}
+
+// Binned surface area heuristic. The leaf centers are sorted into bins 
+// along each axis, and the split between bins is chosen that minimizes the 
+// sum over both halves of the surface area times the number of leaves. 
+// Falls back to the middle index if all leaf centers coincide.
+
+static int splitSAH(int first, int last, const DT_CBox *boxes, DT_Index *indices)
+{
+	MT_BBox centers(boxes[indices[first]].getCenter());
+	int i;
+	for (i = first + 1; i < last; ++i) 
+	{
+		centers = centers.hull(MT_BBox(boxes[indices[i]].getCenter()));
+	}
+
+	int best_axis = -1, best_bin = 0;
+	MT_Scalar best_cost = MT_INFINITY;
+	int axis;
+	for (axis = 0; axis != 3; ++axis)
+	{
+		MT_Scalar lower = centers.getMin()[axis];
+		MT_Scalar width = centers.getMax()[axis] - lower;
+		if (width <= MT_Scalar(0.0))
+		{
+			continue;
+		}
+		MT_Scalar scale = MT_Scalar(NUM_BINS) / width;
+
+		int     count[NUM_BINS];
+		MT_BBox bin_box[NUM_BINS];
+		std::fill(&count[0], &count[NUM_BINS], 0);
+		for (i = first; i < last; ++i)
+		{
+			const DT_CBox& box = boxes[indices[i]];
+			int bin = binIndex(box.getCenter()[axis], lower, scale);
+			bin_box[bin] = count[bin] == 0 ? box.get() : bin_box[bin].hull(box.get());
+			++count[bin];
+		}
+
+		// right_cost[b] is the cost of the bins from b on.
+		MT_Scalar right_cost[NUM_BINS];
+		MT_BBox right_box;
+		int right_count = 0;
+		int b;
+		for (b = NUM_BINS - 1; b > 0; --b)
+		{
+			if (count[b] != 0)
+			{
+				right_box = right_count == 0 ? bin_box[b] : right_box.hull(bin_box[b]);
+				right_count += count[b];
+			}
+			right_cost[b] = right_count == 0 ? MT_Scalar(0.0) : halfArea(right_box) * MT_Scalar(right_count);
+		}
+
+		MT_BBox left_box;
+		int left_count = 0;
+		for (b = 1; b != NUM_BINS; ++b)
+		{
+			if (count[b - 1] != 0)
+			{
+				left_box = left_count == 0 ? bin_box[b - 1] : left_box.hull(bin_box[b - 1]);
+				left_count += count[b - 1];
+			}
+			if (left_count != 0 && left_count != last - first)
+			{
+				MT_Scalar cost = halfArea(left_box) * MT_Scalar(left_count) + right_cost[b];
+				if (cost < best_cost)
+				{
+					best_cost = cost;
+					best_axis = axis;
+					best_bin = b;
+				}
+			}
+		}
+	}
+
+	if (best_axis == -1)
+	{
+		return (first + last) / 2;
+	}
+
+	MT_Scalar lower = centers.getMin()[best_axis];
+	MT_Scalar scale = MT_Scalar(NUM_BINS) / (centers.getMax()[best_axis] - lower);
+	int mid = last;
+	i = first;
+	while (i < mid) 
+	{
+		if (binIndex(boxes[indices[i]].getCenter()[best_axis], lower, scale) < best_bin)
+		{
+			++i;
+		}
+		else
+		{
+			--mid;
+			std::swap(indices[i], indices[mid]);
+		}
+	}
+
+	assert(first < mid && mid < last);
+	return mid;
+}
+
+DT_BBoxNode::DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes, const DT_CBox *boxes, DT_Index *indices, const DT_CBox& bbox, SplitType split)
+{
+	assert(last - first >= 2);
+	
+	int mid = split == SAH ? splitSAH(first, last, boxes, indices) : splitMidpoint(first, last, boxes, indices, bbox);
 	
 	m_lbox = getBBox(first, mid, boxes, indices);
 	m_rbox = getBBox(mid, last, boxes, indices);
@@ -74,7 +204,7 @@ DT_BBoxNode::DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes
 	else 
 	{	
 		m_lchild = node++;
-		new(&free_nodes[m_lchild]) DT_BBoxNode(first, mid, node, free_nodes, boxes, indices, m_lbox);
+		new(&free_nodes[m_lchild]) DT_BBoxNode(first, mid, node, free_nodes, boxes, indices, m_lbox, split);
 	}
 
 	if (last - mid == 1)
@@ -85,6 +215,6 @@ DT_BBoxNode::DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes
 	else 
 	{
 		m_rchild = node++;
-		new(&free_nodes[m_rchild]) DT_BBoxNode(mid, last, node, free_nodes, boxes, indices, m_rbox); 
+		new(&free_nodes[m_rchild]) DT_BBoxNode(mid, last, node, free_nodes, boxes, indices, m_rbox, split);
 	}
 }
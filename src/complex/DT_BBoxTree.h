@@ -24,6 +24,7 @@
 #ifndef DT_BBOXTREE_H
 #define DT_BBOXTREE_H
 
+#include <cassert>
 #include <new>
 #include <algorithm>
 
@@ -64,8 +65,13 @@ public:
 
 class DT_BBoxNode {
 public:
+    // How the leaves of a node are divided over its children: at the 
+    // center of the longest axis, or by a binned surface area heuristic.
+    enum SplitType { MIDPOINT = 0, SAH = 1 };
+
     DT_BBoxNode() {}    
-    DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes, const DT_CBox *boxes, DT_Index *indices, const DT_CBox& bbox);
+    DT_BBoxNode(int first, int last, int& node, DT_BBoxNode *free_nodes, const DT_CBox *boxes, DT_Index *indices, const DT_CBox& bbox, 
+                SplitType split = MIDPOINT);
 
     void makeChildren(DT_BBoxTree& ltree, DT_BBoxTree& rtree) const;
     void makeChildren(const DT_CBox& added, DT_BBoxTree& ltree, DT_BBoxTree& rtree) const;
@@ -186,34 +192,141 @@ inline void refit(DT_BBoxNode& node, const DT_RootData<Shape>& rd)
 }
 
 
+// Stack of the nodes that a traversal still has to visit. The first N 
+// entries are kept in place, so that only unusually deep trees make the 
+// stack move to the heap. 
+
+template <typename Entry, int N = 64>
+class DT_NodeStack {
+public:
+    DT_NodeStack() 
+      : m_data(m_local), 
+        m_size(0), 
+        m_capacity(N) 
+    {}
+
+    ~DT_NodeStack() 
+    { 
+        if (m_data != m_local)
+        {
+            delete [] m_data;
+        }
+    }
+
+    bool empty() const { return m_size == 0; }
+
+    // Returns the new top entry, for the caller to fill in. 
+    Entry& push()
+    {
+        if (m_size == m_capacity) 
+        {
+            grow();
+        }
+        return m_data[m_size++];
+    }
+
+    const Entry& pop() 
+    { 
+        assert(m_size != 0);
+        return m_data[--m_size]; 
+    }
+
+private:
+    DT_NodeStack(const DT_NodeStack&);
+    DT_NodeStack& operator=(const DT_NodeStack&);
+
+    void grow()
+    {
+        Entry *data = new Entry[2 * m_capacity];
+        std::copy(&m_data[0], &m_data[m_size], data);
+        if (m_data != m_local)
+        {
+            delete [] m_data;
+        }
+        m_data = data;
+        m_capacity *= 2;
+    }
+
+    Entry  m_local[N];
+    Entry *m_data;
+    int    m_size;
+    int    m_capacity;
+};
+
+// The traversals below keep the node they visit in a local and descend 
+// into its left child right away. Only the right child goes on the stack, 
+// so the nodes are visited in the same order as by a recursion. The builder 
+// stores each left child right after its parent (see DT_BBoxNode), which 
+// makes this walk run forward through the node array. 
+// For a pair of trees, the tree with the larger box is descended, unless it
+// is a leaf.
+
+struct DT_BBoxTreePair {
+    DT_BBoxTreePair() {}
+    DT_BBoxTreePair(const DT_BBoxTree& a, const DT_BBoxTree& b)
+      : m_a(a),
+        m_b(b)
+    {}
+
+    DT_BBoxTree m_a;
+    DT_BBoxTree m_b;
+};
+
+// Replaces the tree that is descended by its left child, and returns the
+// pair with the right child in rpair.
+template <typename Shape1, typename Shape2>
+inline void descend(DT_BBoxTreePair& pair, DT_BBoxTreePair& rpair, const DT_DuoPack<Shape1, Shape2>& pack)
+{
+    if (pair.m_a.m_type == DT_BBoxTree::LEAF || 
+        (pair.m_b.m_type != DT_BBoxTree::LEAF && pair.m_a.m_cbox.size() < pair.m_b.m_cbox.size())) 
+    {
+        rpair.m_a = pair.m_a;
+        pack.m_b.m_nodes[pair.m_b.m_index].makeChildren(pack.m_b.m_added, pair.m_b, rpair.m_b);
+    }
+    else
+    {
+        rpair.m_b = pair.m_b;
+        pack.m_a.m_nodes[pair.m_a.m_index].makeChildren(pack.m_a.m_added, pair.m_a, rpair.m_a);
+    }
+}
+
+
 template <typename Shape>
 bool rayCast(const DT_BBoxTree& a, const DT_RootData<Shape>& rd,
               const MT_Point3& source, const MT_Point3& target, 
               MT_Scalar& lambda, MT_Vector3& normal) 
 {
-    if (!a.m_cbox.overlapsLineSegment(source, source.lerp(target, lambda))) 
-    {
-        return false;
-    }
+    bool result = false;
 
-    if (a.m_type == DT_BBoxTree::LEAF) 
-    { 
-        return ray_cast(rd, a.m_index, source, target, lambda, normal); 
-    }
-    else 
+    DT_NodeStack<DT_BBoxTree> stack;
+    DT_BBoxTree tree = a;
+    for (;;)
     {
-        DT_BBoxTree ltree, rtree;
-        rd.m_nodes[a.m_index].makeChildren(ltree, rtree);
-        
-        bool lresult = rayCast(ltree, rd, source, target, lambda, normal);
-        bool rresult = rayCast(rtree, rd, source, target, lambda, normal);
-        return lresult || rresult;
+        if (tree.m_cbox.overlapsLineSegment(source, source.lerp(target, lambda))) 
+        {
+            if (tree.m_type != DT_BBoxTree::LEAF) 
+            {
+                rd.m_nodes[tree.m_index].makeChildren(tree, stack.push());
+                continue;
+            }
+
+            if (ray_cast(rd, tree.m_index, source, target, lambda, normal))
+            {
+                result = true;
+            }
+        }
+
+        if (stack.empty())
+        {
+            return result;
+        }
+        tree = stack.pop();
     }
 }
 
 
 #ifdef STATISTICS
-int num_box_tests = 0;
+extern int num_box_tests;
 #endif
 
 template <typename Shape1, typename Shape2>
@@ -224,14 +337,14 @@ inline bool intersect(const DT_CBox& a, const DT_CBox& b, const DT_DuoPack<Shape
 #endif
 
     
+    // The face axes of 'a', then those of 'b', three at a time.
     MT_Vector3 abs_pos_b2a = (pack.m_b2a(b.getCenter()) - a.getCenter()).absolute();
+    if (!abs_pos_b2a.lessEqual(a.getExtent() + pack.m_abs_b2a * b.getExtent()))
+    {
+        return false;
+    }
     MT_Vector3 abs_pos_a2b = (pack.m_a2b(a.getCenter()) - b.getCenter()).absolute();
-    return  (a.getExtent()[0] + pack.m_abs_b2a[0].dot(b.getExtent()) >=  abs_pos_b2a[0]) && 
-            (a.getExtent()[1] + pack.m_abs_b2a[1].dot(b.getExtent()) >=  abs_pos_b2a[1]) && 
-            (a.getExtent()[2] + pack.m_abs_b2a[2].dot(b.getExtent()) >=  abs_pos_b2a[2]) && 
-            (b.getExtent()[0] + pack.m_abs_a2b[0].dot(a.getExtent()) >=  abs_pos_a2b[0]) && 
-            (b.getExtent()[1] + pack.m_abs_a2b[1].dot(a.getExtent()) >=  abs_pos_a2b[1]) &&
-            (b.getExtent()[2] + pack.m_abs_a2b[2].dot(a.getExtent()) >=  abs_pos_a2b[2]);
+    return abs_pos_a2b.lessEqual(b.getExtent() + pack.m_abs_a2b * a.getExtent());
 }
 
 
@@ -240,48 +353,58 @@ inline bool intersect(const DT_CBox& a, const DT_CBox& b, const DT_DuoPack<Shape
 template <typename Shape1, typename Shape2>
 bool intersect(const DT_BBoxTree& a, const DT_Pack<Shape1, Shape2>& pack, MT_Vector3& v)
 { 
-    if (!a.m_cbox.overlaps(pack.m_b_cbox)) 
+    DT_NodeStack<DT_BBoxTree> stack;
+    DT_BBoxTree tree = a;
+    for (;;)
     {
-        return false;
-    }
+        if (tree.m_cbox.overlaps(pack.m_b_cbox)) 
+        {
+            if (tree.m_type != DT_BBoxTree::LEAF) 
+            {
+                pack.m_a.m_nodes[tree.m_index].makeChildren(pack.m_a.m_added, tree, stack.push());
+                continue;
+            }
 
-    if (a.m_type == DT_BBoxTree::LEAF) 
-    {
-        return intersect(pack, a.m_index, v);
-    }
-    else 
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        return intersect(a_ltree, pack, v) || intersect(a_rtree, pack, v);
+            if (intersect(pack, tree.m_index, v))
+            {
+                return true;
+            }
+        }
+
+        if (stack.empty())
+        {
+            return false;
+        }
+        tree = stack.pop();
     }
 }
 
 template <typename Shape1, typename Shape2>
 bool intersect(const DT_BBoxTree& a, const DT_BBoxTree& b, const DT_DuoPack<Shape1, Shape2>& pack, MT_Vector3& v)
 { 
-    if (!intersect(a.m_cbox, b.m_cbox, pack)) 
+    DT_NodeStack<DT_BBoxTreePair> stack;
+    DT_BBoxTreePair pair(a, b);
+    for (;;)
     {
-        return false;
-    }
+        if (intersect(pair.m_a.m_cbox, pair.m_b.m_cbox, pack)) 
+        {
+            if (pair.m_a.m_type != DT_BBoxTree::LEAF || pair.m_b.m_type != DT_BBoxTree::LEAF) 
+            {
+                descend(pair, stack.push(), pack);
+                continue;
+            }
 
-    if (a.m_type == DT_BBoxTree::LEAF && b.m_type == DT_BBoxTree::LEAF) 
-    {
-        return intersect(pack, a.m_index, b.m_index, v);
-    }
-    else if (a.m_type == DT_BBoxTree::LEAF || 
-             (b.m_type != DT_BBoxTree::LEAF && a.m_cbox.size() < b.m_cbox.size())) 
-    {
-        DT_BBoxTree b_ltree, b_rtree;
-        pack.m_b.m_nodes[b.m_index].makeChildren(pack.m_b.m_added, b_ltree, b_rtree);
+            if (intersect(pack, pair.m_a.m_index, pair.m_b.m_index, v))
+            {
+                return true;
+            }
+        }
 
-        return intersect(a, b_ltree, pack, v) || intersect(a, b_rtree, pack, v);
-    }
-    else 
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        return intersect(a_ltree, b, pack, v) || intersect(a_rtree, b, pack, v);
+        if (stack.empty())
+        {
+            return false;
+        }
+        pair = stack.pop();
     }
 }
 
@@ -289,21 +412,29 @@ template <typename Shape1, typename Shape2>
 bool common_point(const DT_BBoxTree& a, const DT_Pack<Shape1, Shape2>& pack,  
                   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
 { 
-    if (!a.m_cbox.overlaps(pack.m_b_cbox))
+    DT_NodeStack<DT_BBoxTree> stack;
+    DT_BBoxTree tree = a;
+    for (;;)
     {
-        return false;
-    }
+        if (tree.m_cbox.overlaps(pack.m_b_cbox)) 
+        {
+            if (tree.m_type != DT_BBoxTree::LEAF) 
+            {
+                pack.m_a.m_nodes[tree.m_index].makeChildren(pack.m_a.m_added, tree, stack.push());
+                continue;
+            }
 
-    if (a.m_type == DT_BBoxTree::LEAF) 
-    {
-        return common_point(pack, a.m_index, v, pa, pb);
-    }
-    else 
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        return common_point(a_ltree, pack, v, pa, pb) ||
-               common_point(a_rtree, pack, v, pa ,pb);
+            if (common_point(pack, tree.m_index, v, pa, pb))
+            {
+                return true;
+            }
+        }
+
+        if (stack.empty())
+        {
+            return false;
+        }
+        tree = stack.pop();
     }
 }
 
@@ -311,145 +442,121 @@ template <typename Shape1, typename Shape2>
 bool common_point(const DT_BBoxTree& a, const DT_BBoxTree& b, const DT_DuoPack<Shape1, Shape2>& pack,  
                   MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
 { 
-    if (!intersect(a.m_cbox, b.m_cbox, pack))
+    DT_NodeStack<DT_BBoxTreePair> stack;
+    DT_BBoxTreePair pair(a, b);
+    for (;;)
     {
-        return false;
-    }
+        if (intersect(pair.m_a.m_cbox, pair.m_b.m_cbox, pack)) 
+        {
+            if (pair.m_a.m_type != DT_BBoxTree::LEAF || pair.m_b.m_type != DT_BBoxTree::LEAF) 
+            {
+                descend(pair, stack.push(), pack);
+                continue;
+            }
 
-    if (a.m_type == DT_BBoxTree::LEAF && b.m_type == DT_BBoxTree::LEAF) 
-    {
-        return common_point(pack, a.m_index, b.m_index, v, pa, pb);
-    }
-    else if (a.m_type == DT_BBoxTree::LEAF || 
-             (b.m_type != DT_BBoxTree::LEAF && a.m_cbox.size() < b.m_cbox.size())) 
-    {
-        DT_BBoxTree b_ltree, b_rtree;
-        pack.m_b.m_nodes[b.m_index].makeChildren(pack.m_b.m_added, b_ltree, b_rtree);
-        return common_point(a, b_ltree, pack, v, pa, pb) ||
-               common_point(a, b_rtree, pack, v, pa, pb);
-    }
-    else 
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        return common_point(a_ltree, b, pack, v, pa, pb) ||
-               common_point(a_rtree, b, pack, v, pa ,pb);
+            if (common_point(pack, pair.m_a.m_index, pair.m_b.m_index, v, pa, pb))
+            {
+                return true;
+            }
+        }
+
+        if (stack.empty())
+        {
+            return false;
+        }
+        pair = stack.pop();
     }
 }
 
 
+// The penetration depth of a complex is the deepest one over all leaves
+// that intersect. Of leaves that are equally deep, the first one visited 
+// is kept. Each leaf starts its search from the direction the previous
+// leaf ended with.
+
 template <typename Shape1, typename Shape2>
 bool penetration_depth(const DT_BBoxTree& a, const DT_HybridPack<Shape1, Shape2>& pack, 
-                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, MT_Scalar& max_pen_len) 
+                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, MT_Scalar& max_pen_len,
+                       DT_Accuracy::DepthMethod method) 
 { 
-    if (!a.m_cbox.overlaps(pack.m_b_cbox))
-    {
-        return false;
-    }
-    
-    if (a.m_type == DT_BBoxTree::LEAF) 
-    {
-        if (penetration_depth(pack, a.m_index, v, pa, pb))
-        {
-            max_pen_len = pa.distance2(pb);
-            return true;
-        }
-        else 
-        {
-            return false;
-        }
-    }
-    else 
+    bool result = false;
+    MT_Vector3 lv = v;
+
+    DT_NodeStack<DT_BBoxTree> stack;
+    DT_BBoxTree tree = a;
+    for (;;)
     {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        if (penetration_depth(a_ltree, pack, v, pa, pb, max_pen_len)) 
+        if (tree.m_cbox.overlaps(pack.m_b_cbox)) 
         {
-            MT_Vector3 rv;
-            MT_Point3 rpa, rpb;
-            MT_Scalar rmax_pen_len;
-            if (penetration_depth(a_rtree, pack, rv, rpa, rpb, rmax_pen_len) &&
-                (max_pen_len < rmax_pen_len))
+            if (tree.m_type != DT_BBoxTree::LEAF) 
+            {
+                pack.m_a.m_nodes[tree.m_index].makeChildren(pack.m_a.m_added, tree, stack.push());
+                continue;
+            }
+
+            MT_Point3 lpa, lpb;
+            if (penetration_depth(pack, tree.m_index, lv, lpa, lpb, method))
             {
-                max_pen_len = rmax_pen_len;
-                v = rv;
-                pa = rpa;
-                pb = rpb;
+                MT_Scalar pen_len = lpa.distance2(lpb);
+                if (!result || max_pen_len < pen_len)
+                {
+                    max_pen_len = pen_len;
+                    v = lv;
+                    pa = lpa;
+                    pb = lpb;
+                }
+                result = true;
             }
-            return true;
         }
-        else 
+
+        if (stack.empty())
         {
-            return penetration_depth(a_rtree, pack, v, pa, pb, max_pen_len);
+            return result;
         }
+        tree = stack.pop();
     }
 }
 
 template <typename Shape1, typename Shape2>
 bool penetration_depth(const DT_BBoxTree& a, const DT_BBoxTree& b, const DT_DuoPack<Shape1, Shape2>& pack, 
-                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, MT_Scalar& max_pen_len) 
+                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, MT_Scalar& max_pen_len,
+                       DT_Accuracy::DepthMethod method) 
 { 
-    if (!intersect(a.m_cbox, b.m_cbox, pack))
-    {
-        return false;
-    }
-  
-    if (a.m_type == DT_BBoxTree::LEAF && b.m_type == DT_BBoxTree::LEAF) 
-    {
-        if (penetration_depth(pack, a.m_index, b.m_index, v, pa, pb))
-        {
-            max_pen_len = pa.distance2(pb);
-            return true;
-        }
-        else 
-        {
-            return false;
-        }
-    }
-    else if (a.m_type == DT_BBoxTree::LEAF || 
-             (b.m_type != DT_BBoxTree::LEAF && a.m_cbox.size() < b.m_cbox.size())) 
+    bool result = false;
+    MT_Vector3 lv = v;
+
+    DT_NodeStack<DT_BBoxTreePair> stack;
+    DT_BBoxTreePair pair(a, b);
+    for (;;)
     {
-        DT_BBoxTree b_ltree, b_rtree;
-        pack.m_b.m_nodes[b.m_index].makeChildren(pack.m_b.m_added, b_ltree, b_rtree);
-        if (penetration_depth(a, b_ltree, pack, v, pa, pb, max_pen_len)) 
+        if (intersect(pair.m_a.m_cbox, pair.m_b.m_cbox, pack)) 
         {
-            MT_Point3 rpa, rpb;
-            MT_Scalar rmax_pen_len;
-            if (penetration_depth(a, b_rtree, pack, v, rpa, rpb, rmax_pen_len) &&
-                (max_pen_len < rmax_pen_len))
+            if (pair.m_a.m_type != DT_BBoxTree::LEAF || pair.m_b.m_type != DT_BBoxTree::LEAF) 
             {
-                max_pen_len = rmax_pen_len;
-                pa = rpa;
-                pb = rpb;
+                descend(pair, stack.push(), pack);
+                continue;
             }
-            return true;
-        }
-        else
-        {
-            return penetration_depth(a, b_rtree, pack, v, pa, pb, max_pen_len);
-        }
-    }
-    else 
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        if (penetration_depth(a_ltree, b, pack, v, pa, pb, max_pen_len)) 
-        {
-            MT_Point3 rpa, rpb;
-            MT_Scalar rmax_pen_len;
-            if (penetration_depth(a_rtree, b, pack, v, rpa, rpb, rmax_pen_len) &&
-                (max_pen_len < rmax_pen_len))
+
+            MT_Point3 lpa, lpb;
+            if (penetration_depth(pack, pair.m_a.m_index, pair.m_b.m_index, lv, lpa, lpb, method))
             {
-                max_pen_len = rmax_pen_len;
-                pa = rpa;
-                pb = rpb;
+                MT_Scalar pen_len = lpa.distance2(lpb);
+                if (!result || max_pen_len < pen_len)
+                {
+                    max_pen_len = pen_len;
+                    v = lv;
+                    pa = lpa;
+                    pb = lpb;
+                }
+                result = true;
             }
-            return true;
         }
-        else 
+
+        if (stack.empty())
         {
-            return penetration_depth(a_rtree, b, pack, v, pa, pb, max_pen_len);
+            return result;
         }
+        pair = stack.pop();
     }
 }
 
@@ -469,32 +576,84 @@ inline MT_Scalar distance2(const DT_CBox& a, const MT_Transform& a2w,
     return MT_Scalar(0.0);
 }
 
+// A node that closest_points still has to visit, together with the lower 
+// bound for its distance. 
+template <typename Tree>
+struct DT_BoundedTree {
+    DT_BoundedTree() {}
+    DT_BoundedTree(const Tree& tree, MT_Scalar dist2)
+      : m_tree(tree),
+        m_dist2(dist2)
+    {}
+
+    Tree      m_tree;
+    MT_Scalar m_dist2;
+};
+
+// Of the children of a node, closest_points descends into the nearer one 
+// first. A node on the stack is skipped if, by the time it is popped, a 
+// leaf has been found that is at least as near as its bound.
 
 template <typename Shape1, typename Shape2>
 MT_Scalar closest_points(const DT_BBoxTree& a, const DT_Pack<Shape1, Shape2>& pack, 
                          MT_Scalar max_dist2, MT_Point3& pa, MT_Point3& pb) 
 { 
-    if (a.m_type == DT_BBoxTree::LEAF) 
-    {
-        return closest_points(pack, a.m_index, max_dist2, pa, pb);
-    }
-    else 
+    MT_Scalar min_dist2 = MT_INFINITY;
+
+    DT_NodeStack<DT_BoundedTree<DT_BBoxTree> > stack;
+    DT_BBoxTree tree = a;
+    for (;;)
     {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        MT_Scalar ldist2 = distance2(a_ltree.m_cbox, pack.m_a.m_xform, pack.m_b_cbox, pack.m_a.m_xform);
-        MT_Scalar rdist2 = distance2(a_rtree.m_cbox, pack.m_a.m_xform, pack.m_b_cbox, pack.m_a.m_xform);
-        if (ldist2 < rdist2) 
+        if (tree.m_type != DT_BBoxTree::LEAF) 
         {
-            MT_Scalar dist2 = ldist2 < max_dist2 ? closest_points(a_ltree, pack, max_dist2, pa, pb) : MT_INFINITY;
-            GEN_set_min(max_dist2, dist2);
-            return rdist2 < max_dist2 ? GEN_min(dist2, closest_points(a_rtree, pack, max_dist2, pa, pb)) : dist2;
+            DT_BBoxTree ltree, rtree;
+            pack.m_a.m_nodes[tree.m_index].makeChildren(pack.m_a.m_added, ltree, rtree);
+            MT_Scalar ldist2 = distance2(ltree.m_cbox, pack.m_a.m_xform, pack.m_b_cbox, pack.m_a.m_xform);
+            MT_Scalar rdist2 = distance2(rtree.m_cbox, pack.m_a.m_xform, pack.m_b_cbox, pack.m_a.m_xform);
+            if (ldist2 < rdist2) 
+            {
+                if (rdist2 < max_dist2)
+                {
+                    stack.push() = DT_BoundedTree<DT_BBoxTree>(rtree, rdist2);
+                }
+                if (ldist2 < max_dist2)
+                {
+                    tree = ltree;
+                    continue;
+                }
+            }
+            else
+            {
+                if (ldist2 < max_dist2)
+                {
+                    stack.push() = DT_BoundedTree<DT_BBoxTree>(ltree, ldist2);
+                }
+                if (rdist2 < max_dist2)
+                {
+                    tree = rtree;
+                    continue;
+                }
+            }
         }
         else
         {
-            MT_Scalar dist2 = rdist2 < max_dist2 ? closest_points(a_rtree, pack, max_dist2, pa, pb) : MT_INFINITY;
-            GEN_set_min(max_dist2, dist2);  
-            return ldist2 < max_dist2 ? GEN_min(dist2, closest_points(a_ltree, pack, max_dist2, pa, pb)) : dist2;       
+            MT_Scalar dist2 = closest_points(pack, tree.m_index, max_dist2, pa, pb);
+            GEN_set_min(min_dist2, dist2);
+            GEN_set_min(max_dist2, dist2);
+        }
+
+        for (;;)
+        {
+            if (stack.empty())
+            {
+                return min_dist2;
+            }
+            const DT_BoundedTree<DT_BBoxTree>& entry = stack.pop();
+            if (entry.m_dist2 < max_dist2)
+            {
+                tree = entry.m_tree;
+                break;
+            }
         }
     }
 }
@@ -504,50 +663,63 @@ template <typename Shape1, typename Shape2>
 MT_Scalar closest_points(const DT_BBoxTree& a, const DT_BBoxTree& b, const DT_DuoPack<Shape1, Shape2>& pack, 
                          MT_Scalar max_dist2, MT_Point3& pa, MT_Point3& pb) 
 {   
-    if (a.m_type == DT_BBoxTree::LEAF && b.m_type == DT_BBoxTree::LEAF) 
-    {
-        return closest_points(pack, a.m_index, b.m_index, max_dist2, pa, pb);
-    }
-    else if (a.m_type == DT_BBoxTree::LEAF || 
-             (b.m_type != DT_BBoxTree::LEAF && a.m_cbox.size() < b.m_cbox.size())) 
+    MT_Scalar min_dist2 = MT_INFINITY;
+
+    DT_NodeStack<DT_BoundedTree<DT_BBoxTreePair> > stack;
+    DT_BBoxTreePair pair(a, b);
+    for (;;)
     {
-        DT_BBoxTree b_ltree, b_rtree;
-        pack.m_b.m_nodes[b.m_index].makeChildren(pack.m_b.m_added, b_ltree, b_rtree);
-        MT_Scalar ldist2 = distance2(a.m_cbox, pack.m_a.m_xform, b_ltree.m_cbox, pack.m_b.m_xform);
-        MT_Scalar rdist2 = distance2(a.m_cbox, pack.m_a.m_xform, b_rtree.m_cbox, pack.m_b.m_xform);
-        if (ldist2 < rdist2)
+        if (pair.m_a.m_type != DT_BBoxTree::LEAF || pair.m_b.m_type != DT_BBoxTree::LEAF) 
         {
-            MT_Scalar dist2 = ldist2 < max_dist2 ? closest_points(a, b_ltree, pack, max_dist2, pa, pb): MT_INFINITY;;
-            GEN_set_min(max_dist2, dist2);
-            return rdist2 < max_dist2 ? GEN_min(dist2, closest_points(a, b_rtree, pack, max_dist2, pa, pb)) : dist2;        
+            DT_BBoxTreePair rpair;
+            descend(pair, rpair, pack);
+            MT_Scalar ldist2 = distance2(pair.m_a.m_cbox, pack.m_a.m_xform, pair.m_b.m_cbox, pack.m_b.m_xform);
+            MT_Scalar rdist2 = distance2(rpair.m_a.m_cbox, pack.m_a.m_xform, rpair.m_b.m_cbox, pack.m_b.m_xform);
+            if (ldist2 < rdist2) 
+            {
+                if (rdist2 < max_dist2)
+                {
+                    stack.push() = DT_BoundedTree<DT_BBoxTreePair>(rpair, rdist2);
+                }
+                if (ldist2 < max_dist2)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                if (ldist2 < max_dist2)
+                {
+                    stack.push() = DT_BoundedTree<DT_BBoxTreePair>(pair, ldist2);
+                }
+                if (rdist2 < max_dist2)
+                {
+                    pair = rpair;
+                    continue;
+                }
+            }
         }
         else
         {
-            MT_Scalar dist2 =  rdist2 < max_dist2 ? closest_points(a, b_rtree, pack, max_dist2, pa, pb) : MT_INFINITY;;
+            MT_Scalar dist2 = closest_points(pack, pair.m_a.m_index, pair.m_b.m_index, max_dist2, pa, pb);
+            GEN_set_min(min_dist2, dist2);
             GEN_set_min(max_dist2, dist2);
-            return ldist2 < max_dist2 ? GEN_min(dist2, closest_points(a, b_ltree, pack, max_dist2, pa, pb)) : dist2;
         }
-    }
-    else
-    {
-        DT_BBoxTree a_ltree, a_rtree;
-        pack.m_a.m_nodes[a.m_index].makeChildren(pack.m_a.m_added, a_ltree, a_rtree);
-        MT_Scalar ldist2 = distance2(a_ltree.m_cbox, pack.m_a.m_xform, b.m_cbox, pack.m_b.m_xform);
-        MT_Scalar rdist2 = distance2(a_rtree.m_cbox, pack.m_a.m_xform, b.m_cbox, pack.m_b.m_xform);
-        if (ldist2 < rdist2) 
-        {
-            MT_Scalar dist2 = ldist2 < max_dist2 ? closest_points(a_ltree, b, pack, max_dist2, pa, pb) : MT_INFINITY;;
-            GEN_set_min(max_dist2, dist2);
-            return rdist2 < max_dist2 ? GEN_min(dist2,closest_points(a_rtree, b, pack, max_dist2, pa, pb)) : dist2;
-        }
-        else
+
+        for (;;)
         {
-            MT_Scalar dist2 = rdist2 < max_dist2 ? closest_points(a_rtree, b, pack, max_dist2, pa, pb) : MT_INFINITY;
-            GEN_set_min(max_dist2, dist2);
-            return ldist2 < max_dist2 ? GEN_min(dist2, closest_points(a_ltree, b, pack, max_dist2, pa, pb)) : dist2;
+            if (stack.empty())
+            {
+                return min_dist2;
+            }
+            const DT_BoundedTree<DT_BBoxTreePair>& entry = stack.pop();
+            if (entry.m_dist2 < max_dist2)
+            {
+                pair = entry.m_tree;
+                break;
+            }
         }
     }
 }
 
 #endif
-
@@ -28,6 +28,7 @@
 #include "DT_Minkowski.h"
 #include "DT_Sphere.h"
 #include "DT_Transform.h"
+#include "DT_PenDepth.h"
 #include "DT_Object.h"
 
 DT_Complex::DT_Complex(const DT_VertexBase *base) 
@@ -58,7 +59,7 @@ DT_Complex::~DT_Complex()
     }
 }
 
-void DT_Complex::finish(DT_Count n, const DT_Convex *p[]) 
+void DT_Complex::finish(DT_Count n, const DT_Convex *p[], DT_BBoxNode::SplitType split) 
 {
 	m_count = n;
 
@@ -97,7 +98,7 @@ void DT_Complex::finish(DT_Count n, const DT_Convex *p[])
         assert(m_nodes);
     
         int num_nodes = 0;
-        new(&m_nodes[num_nodes++]) DT_BBoxNode(0, n, num_nodes, m_nodes, boxes, indices, m_cbox);
+        new(&m_nodes[num_nodes++]) DT_BBoxNode(0, n, num_nodes, m_nodes, boxes, indices, m_cbox, split);
 
         assert(num_nodes == int(n - 1));
         
@@ -240,38 +241,43 @@ bool common_point(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_marg
                         DT_BBoxTree(b.m_cbox + pack.m_b.m_added, 0, b.m_type),  pack, v, pa, pb);
 }
 
-inline bool penetration_depth(const DT_HybridPack<const DT_Convex *, MT_Scalar>& pack, DT_Index a_index, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+inline bool penetration_depth(const DT_HybridPack<const DT_Convex *, MT_Scalar>& pack, DT_Index a_index, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+							  DT_Accuracy::DepthMethod method) 
 {
     DT_Transform ta = DT_Transform(pack.m_a.m_xform, *pack.m_a.m_leaves[a_index]);
-    return ::hybrid_penetration_depth(ta, pack.m_a.m_plus, pack.m_b, pack.m_margin, v, pa, pb); 
+    return ::hybrid_penetration_depth(ta, pack.m_a.m_plus, pack.m_b, pack.m_margin, v, pa, pb, 
+									  DT_EPAWorkspace::local(), 0, method); 
 }
 
 bool penetration_depth(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_margin, 
-                       const DT_Convex& b, MT_Scalar b_margin, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+                       const DT_Convex& b, MT_Scalar b_margin, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+					   DT_Accuracy::DepthMethod method) 
 {
     DT_HybridPack<const DT_Convex *, MT_Scalar> pack(DT_ObjectData<const DT_Convex *, MT_Scalar>(a.m_nodes, a.m_leaves, a2w, a_margin), b, b_margin);
      
     MT_Scalar  max_pen_len = MT_Scalar(0.0);
-    return penetration_depth(DT_BBoxTree(a.m_cbox + pack.m_a.m_added, 0, a.m_type), pack, v, pa, pb, max_pen_len);
+    return penetration_depth(DT_BBoxTree(a.m_cbox + pack.m_a.m_added, 0, a.m_type), pack, v, pa, pb, max_pen_len, method);
 }
 
-inline bool penetration_depth(const DT_DuoPack<const DT_Convex *, MT_Scalar>& pack, DT_Index a_index, DT_Index b_index, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+inline bool penetration_depth(const DT_DuoPack<const DT_Convex *, MT_Scalar>& pack, DT_Index a_index, DT_Index b_index, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+							  DT_Accuracy::DepthMethod method) 
 {
     DT_Transform ta = DT_Transform(pack.m_a.m_xform, *pack.m_a.m_leaves[a_index]);
     DT_Transform tb = DT_Transform(pack.m_b.m_xform, *pack.m_b.m_leaves[b_index]);
-    return ::hybrid_penetration_depth(ta, pack.m_a.m_plus, tb, pack.m_b.m_plus, v, pa, pb);  
+    return ::hybrid_penetration_depth(ta, pack.m_a.m_plus, tb, pack.m_b.m_plus, v, pa, pb, 
+									  DT_EPAWorkspace::local(), 0, method);  
 }
 
 bool penetration_depth(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_margin,
                        const DT_Complex& b, const MT_Transform& b2w, MT_Scalar b_margin, 
-                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb) 
+                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_Accuracy::DepthMethod method) 
 {
     DT_DuoPack<const DT_Convex *, MT_Scalar> pack(DT_ObjectData<const DT_Convex *, MT_Scalar>(a.m_nodes, a.m_leaves, a2w, a_margin),
                                                   DT_ObjectData<const DT_Convex *, MT_Scalar>(b.m_nodes, b.m_leaves, b2w, b_margin));
 
     MT_Scalar  max_pen_len = MT_Scalar(0.0);
     return penetration_depth(DT_BBoxTree(a.m_cbox + pack.m_a.m_added, 0, a.m_type),
-                             DT_BBoxTree(b.m_cbox + pack.m_b.m_added, 0, b.m_type), pack, v, pa, pb, max_pen_len);
+                             DT_BBoxTree(b.m_cbox + pack.m_b.m_added, 0, b.m_type), pack, v, pa, pb, max_pen_len, method);
 }
 
 
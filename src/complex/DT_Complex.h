@@ -41,7 +41,7 @@ public:
 	DT_Complex(const DT_VertexBase *base);
 	virtual ~DT_Complex();
 	
-	void finish(DT_Count n, const DT_Convex *p[]);
+	void finish(DT_Count n, const DT_Convex *p[], DT_BBoxNode::SplitType split = DT_BBoxNode::MIDPOINT);
     
 	virtual DT_ShapeType getType() const { return COMPLEX; }
 
@@ -68,11 +68,12 @@ public:
                              MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
     
     friend bool penetration_depth(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_margin, 
-								  const DT_Convex& b, MT_Scalar b_margin, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+								  const DT_Convex& b, MT_Scalar b_margin, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+								  DT_Accuracy::DepthMethod method);
     
     friend bool penetration_depth(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_margin, 
 								  const DT_Complex& b, const MT_Transform& b2w, MT_Scalar b_margin,
-								  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+								  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_Accuracy::DepthMethod method);
 
     friend MT_Scalar closest_points(const DT_Complex& a, const MT_Transform& a2w, MT_Scalar a_margin, 
 		                            const DT_Convex& b, MT_Point3& pa, MT_Point3& pb);
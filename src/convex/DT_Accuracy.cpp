@@ -28,3 +28,4 @@ static const MT_Scalar rel_error = MT_Scalar(1.0e-3);
 MT_Scalar DT_Accuracy::rel_error2 = rel_error * rel_error;
 MT_Scalar DT_Accuracy::depth_tolerance = MT_Scalar(1.0) + MT_Scalar(2.0) * rel_error; 
 MT_Scalar DT_Accuracy::tol_error = MT_EPSILON;
+DT_Accuracy::DepthMethod DT_Accuracy::depth_method = DT_Accuracy::EPA;
@@ -28,9 +28,15 @@
 
 class DT_Accuracy {
 public:
+	// The method that computes the penetration depth of objects whose cores
+	// intersect: the expanding polytope algorithm, or the faster but
+	// approximate Minkowski portal refinement.
+	enum DepthMethod { EPA, MPR };
+
 	static MT_Scalar rel_error2; // squared relative error in the computed distance
 	static MT_Scalar depth_tolerance; // terminate EPA if upper_bound <= depth_tolerance * dist2
 	static MT_Scalar tol_error; // error tolerance if the distance is almost zero
+	static DepthMethod depth_method; // method of the depth response
 	
 	static void setAccuracy(MT_Scalar rel_error) 
 	{ 
@@ -42,6 +48,11 @@ public:
 	{ 
 		tol_error = epsilon;
 	}
+
+	static void setDepthMethod(DepthMethod method) 
+	{ 
+		depth_method = method;
+	}
 };
 
 #endif
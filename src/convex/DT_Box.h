@@ -36,6 +36,8 @@ public:
 		m_extent(e) 
 	{}
 
+	virtual DT_ShapeType getType() const { return BOX; } 
+
     virtual MT_Scalar supportH(const MT_Vector3& v) const;
     virtual MT_Point3 support(const MT_Vector3& v) const;
 	virtual bool ray_cast(const MT_Point3& source, const MT_Point3& target,
@@ -29,6 +29,7 @@
 
 #include "DT_GJK.h"
 #include "DT_PenDepth.h"
+#include "DT_MPR.h"
 
 #include <algorithm>
 #include <new>
@@ -85,7 +86,36 @@ bool DT_Convex::ray_cast(const MT_Point3& source, const MT_Point3& target, MT_Sc
     return false;
 }
 
-bool intersect(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v)
+// Starts GJK from the vertices in 'simplex', if there are any and they are not 
+// degenerate. Returns true if the seeded simplex already contains the origin,
+// so that no iterations are needed.
+static bool seed(DT_GJK& gjk, DT_Simplex *simplex, MT_Vector3& v, MT_Scalar& dist2)
+{
+	if (simplex)
+	{
+		simplex->m_start = gjk.seed(*simplex, v) ? DT_Simplex::WARM : DT_Simplex::COLD;
+		simplex->m_iterations = 0;
+		if (simplex->m_start == DT_Simplex::WARM)
+		{
+			dist2 = v.length2();
+			return gjk.fullSimplex() || dist2 <= DT_Accuracy::tol_error * gjk.maxVertex();
+		}
+	}
+	return false;
+}
+
+// Keeps the last simplex for the next run. The simplex of GJK is not changed 
+// by a failed step, so it is never degenerate.
+static bool finish(const DT_GJK& gjk, DT_Simplex *simplex, bool result)
+{
+	if (simplex)
+	{
+		gjk.getSimplex(*simplex);
+	}
+	return result;
+}
+
+bool intersect(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, DT_Simplex *simplex)
 {
 	DT_GJK gjk;
 
@@ -94,63 +124,75 @@ bool intersect(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v)
 #endif
 	MT_Scalar dist2 = MT_INFINITY;
 
-	do
+	if (!seed(gjk, simplex, v, dist2))
 	{
-		MT_Point3  p = a.support(-v);	
-		MT_Point3  q = b.support(v);
-		MT_Vector3 w = p - q; 
-		
-        if (v.dot(w) > MT_Scalar(0.0)) 
+		do
 		{
-			return false;
-		}
- 
-		gjk.addVertex(w); 
-        if (gjk.isAffinelyDependent())
-        {
+			MT_Point3  p = a.support(-v);	
+			MT_Point3  q = b.support(v);
+			MT_Vector3 w = p - q; 
+			
+			if (v.dot(w) > MT_Scalar(0.0)) 
+			{
+				return finish(gjk, simplex, false);
+			}
+			
+			if (simplex)
+			{
+				gjk.addVertex(w, p, q); 
+				++simplex->m_iterations;
+			}
+			else
+			{
+				gjk.addVertex(w); 
+			}
+
+			if (gjk.isAffinelyDependent())
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif
-            return false;
-        }
-
-
+				return finish(gjk, simplex, false);
+			}
+			
+			
 #ifdef STATISTICS
-        ++num_iterations;
+			++num_iterations;
 #endif
-        if (!gjk.closest(v)) 
-		{
+			if (!gjk.closest(v)) 
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif
-            return false;
-        }
-
+				return finish(gjk, simplex, false);
+			}
+			
 #ifdef SAFE_EXIT
-		MT_Scalar prev_dist2 = dist2;
+			MT_Scalar prev_dist2 = dist2;
 #endif
-
-		dist2 = v.length2();
-
+			
+			dist2 = v.length2();
+			
 #ifdef SAFE_EXIT
-		if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
-		{
- 			return false;
-		}
+			if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
+			{
+				return finish(gjk, simplex, false);
+			}
 #endif
-    } 
-    while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
+		} 
+		while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
+	}
 
     v.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
 
-    return true;
+    return finish(gjk, simplex, true);
 }
 
 
 
 
 bool common_point(const DT_Convex& a, const DT_Convex& b,
-                  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+                  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_Simplex *simplex)
 {
 	DT_GJK gjk;
 
@@ -160,58 +202,66 @@ bool common_point(const DT_Convex& a, const DT_Convex& b,
 
 	MT_Scalar dist2 = MT_INFINITY;
 
-    do
+	if (!seed(gjk, simplex, v, dist2))
 	{
-		MT_Point3  p = a.support(-v);	
-		MT_Point3  q = b.support(v);
-		MT_Vector3 w = p - q; 
-		
-        if (v.dot(w) > MT_Scalar(0.0)) 
+		do
 		{
-			return false;
-		}
- 
-		gjk.addVertex(w, p, q); 
-        if (gjk.isAffinelyDependent())
-        {
+			MT_Point3  p = a.support(-v);	
+			MT_Point3  q = b.support(v);
+			MT_Vector3 w = p - q; 
+			
+			if (v.dot(w) > MT_Scalar(0.0)) 
+			{
+				return finish(gjk, simplex, false);
+			}
+			
+			gjk.addVertex(w, p, q); 
+			if (simplex)
+			{
+				++simplex->m_iterations;
+			}
+
+			if (gjk.isAffinelyDependent())
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif 
-            return false;
-        }
-
-
+				return finish(gjk, simplex, false);
+			}
+			
+			
 #ifdef STATISTICS
-        ++num_iterations;
+			++num_iterations;
 #endif
-        if (!gjk.closest(v)) 
-		{
+			if (!gjk.closest(v)) 
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif
-            return false;
-        }		
-		
+				return finish(gjk, simplex, false);
+			}		
+			
 #ifdef SAFE_EXIT
-		MT_Scalar prev_dist2 = dist2;
+			MT_Scalar prev_dist2 = dist2;
 #endif
-
-		dist2 = v.length2();
-
+			
+			dist2 = v.length2();
+			
 #ifdef SAFE_EXIT
-		if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
-		{
-            return false;
-		}
+			if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
+			{
+				return finish(gjk, simplex, false);
+			}
 #endif
-    }
-    while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
+		}
+		while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
+	}
     
 	gjk.compute_points(pa, pb);
 
     v.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
 
-    return true;
+    return finish(gjk, simplex, true);
 }
 
 
@@ -222,6 +272,13 @@ bool common_point(const DT_Convex& a, const DT_Convex& b,
 	
 bool penetration_depth(const DT_Convex& a, const DT_Convex& b,
                        MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return penetration_depth(a, b, v, pa, pb, DT_EPAWorkspace::local());
+}
+
+bool penetration_depth(const DT_Convex& a, const DT_Convex& b,
+                       MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+					   DT_EPAWorkspace& workspace, DT_Simplex *simplex)
 {
 	DT_GJK gjk;
 
@@ -231,63 +288,82 @@ bool penetration_depth(const DT_Convex& a, const DT_Convex& b,
 
 	MT_Scalar dist2 = MT_INFINITY;
 
-    do
+	if (!seed(gjk, simplex, v, dist2))
 	{
-		MT_Point3  p = a.support(-v);	
-		MT_Point3  q = b.support(v);
-		MT_Vector3 w = p - q; 
-		
-        if (v.dot(w) > MT_Scalar(0.0)) 
+		do
 		{
-			return false;
-		}
- 
-		gjk.addVertex(w, p, q); 
-        
-        if (gjk.isAffinelyDependent())
-        {
+			MT_Point3  p = a.support(-v);	
+			MT_Point3  q = b.support(v);
+			MT_Vector3 w = p - q; 
+			
+			if (v.dot(w) > MT_Scalar(0.0)) 
+			{
+				return finish(gjk, simplex, false);
+			}
+			
+			gjk.addVertex(w, p, q); 
+			if (simplex)
+			{
+				++simplex->m_iterations;
+			}
+			
+			if (gjk.isAffinelyDependent())
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif
- 
-            return false;
-        }
-
-
+				
+				return finish(gjk, simplex, false);
+			}
+			
+			
 #ifdef STATISTICS
-        ++num_iterations;
+			++num_iterations;
 #endif
-        if (!gjk.closest(v)) 
-		{
+			if (!gjk.closest(v)) 
+			{
 #ifdef STATISTICS
-            ++num_irregularities;
+				++num_irregularities;
 #endif
-            return false;
-        }		
-		
+				return finish(gjk, simplex, false);
+			}		
+			
 #ifdef SAFE_EXIT
-		MT_Scalar prev_dist2 = dist2;
+			MT_Scalar prev_dist2 = dist2;
 #endif
-
-		dist2 = v.length2();
-
+			
+			dist2 = v.length2();
+			
 #ifdef SAFE_EXIT
-		if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
-		{
- 			return false;
-		}
+			if (prev_dist2 - dist2 <= MT_EPSILON * prev_dist2) 
+			{
+				return finish(gjk, simplex, false);
+			}
 #endif
-    }
-    while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
-    
+		}
+		while (!gjk.fullSimplex() && dist2 > DT_Accuracy::tol_error * gjk.maxVertex()); 
+	}
 
-	return penDepth(gjk, a, b, v, pa, pb);
+	// The simplex is kept before the expanding polytope grows it. 
+	finish(gjk, simplex, true);
+	return penDepth(gjk, a, b, v, pa, pb, workspace);
 
 }
 
 bool hybrid_penetration_depth(const DT_Convex& a, MT_Scalar a_margin, 
 							  const DT_Convex& b, MT_Scalar b_margin,
                               MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return hybrid_penetration_depth(a, a_margin, b, b_margin, v, pa, pb, DT_EPAWorkspace::local());
+}
+
+// The first phase works on the objects without margins, so only the second 
+// phase starts from 'simplex'.
+bool hybrid_penetration_depth(const DT_Convex& a, MT_Scalar a_margin, 
+							  const DT_Convex& b, MT_Scalar b_margin,
+                              MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+							  DT_EPAWorkspace& workspace, DT_Simplex *simplex,
+							  DT_Accuracy::DepthMethod method)
 {
 	MT_Scalar margin = a_margin + b_margin;
 	if (margin > MT_Scalar(0.0))
@@ -382,12 +458,18 @@ bool hybrid_penetration_depth(const DT_Convex& a, MT_Scalar a_margin,
 	}
 	// Second GJK phase. compute points on the boundary of the offset object
 	
-	return penetration_depth((a_margin > MT_Scalar(0.0) ? 
-							  static_cast<const DT_Convex&>(DT_Minkowski(a, DT_Sphere(a_margin))) : 
-							  static_cast<const DT_Convex&>(a)), 
-							 (b_margin > MT_Scalar(0.0) ? 
-							  static_cast<const DT_Convex&>(DT_Minkowski(b, DT_Sphere(b_margin))) : 
-							  static_cast<const DT_Convex&>(b)), v, pa, pb);
+	DT_Sphere    a_sphere(a_margin);
+	DT_Sphere    b_sphere(b_margin);
+	DT_Minkowski a_offset(a, a_sphere);
+	DT_Minkowski b_offset(b, b_sphere);
+	const DT_Convex& ca = a_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(a_offset) : a;
+	const DT_Convex& cb = b_margin > MT_Scalar(0.0) ? static_cast<const DT_Convex&>(b_offset) : b;
+
+	if (method == DT_Accuracy::MPR)
+	{
+		return mprPenDepth(ca, cb, v, pa, pb);
+	}
+	return penetration_depth(ca, cb, v, pa, pb, workspace, simplex);
 }
 
 
@@ -32,6 +32,11 @@
 #include "MT_Matrix3x3.h"
 #include "MT_Transform.h"
 
+#include "DT_Accuracy.h"
+
+class DT_EPAWorkspace;
+struct DT_Simplex;
+
 class DT_Convex : public DT_Shape {
 public:
     virtual ~DT_Convex() {}
@@ -49,16 +54,36 @@ protected:
 };
 
 
-bool intersect(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v);
+// The tests that take a simplex start GJK from it, if it is not empty, and 
+// return the last simplex of GJK in it. The vertices of the simplex must be 
+// support points of the same two objects. 
+
+bool intersect(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, DT_Simplex *simplex = 0);
 
-bool common_point(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+bool common_point(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, 
+				  DT_Simplex *simplex = 0);
 
 MT_Scalar closest_points(const DT_Convex&, const DT_Convex&, MT_Scalar max_dist2, MT_Point3& pa, MT_Point3& pb);
 
+// The versions without a workspace use the workspace of the calling thread.
+
 bool penetration_depth(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
 
+bool penetration_depth(const DT_Convex& a, const DT_Convex& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+					   DT_EPAWorkspace& workspace, DT_Simplex *simplex = 0);
+
 bool hybrid_penetration_depth(const DT_Convex& a, MT_Scalar a_margin, 
 							  const DT_Convex& b, MT_Scalar b_margin,
                               MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
 
+// With MPR as 'method', the depth of objects whose cores intersect is 
+// approximated by Minkowski portal refinement, which needs neither the
+// workspace nor the simplex.
+
+bool hybrid_penetration_depth(const DT_Convex& a, MT_Scalar a_margin, 
+							  const DT_Convex& b, MT_Scalar b_margin,
+                              MT_Vector3& v, MT_Point3& pa, MT_Point3& pb,
+							  DT_EPAWorkspace& workspace, DT_Simplex *simplex = 0,
+							  DT_Accuracy::DepthMethod method = DT_Accuracy::EPA);
+
 #endif
@@ -29,12 +29,35 @@
 #define FAST_CLOSEST
 #define UNROLL_LOOPS
 
+// Finds the closest point of the simplex with signed volumes instead of 
+// Johnson's sub-algorithm. The other switches apply to Johnson's only.
+//#define SIGNED_VOLUMES
+
 
 #include "MT_Point3.h"
 #include "MT_Vector3.h"
 #include "GEN_MinMax.h"
 #include "DT_Accuracy.h"
 
+// The vertices of a simplex, as support points of both objects, for starting 
+// GJK where an earlier run ended. An empty simplex gives a cold start. A run 
+// leaves its last simplex, how it started, and its number of iterations.
+struct DT_Simplex {
+	enum T_Start { UNUSED, COLD, WARM };
+
+	DT_Simplex() :
+		m_num_verts(0),
+		m_start(UNUSED),
+		m_iterations(0)
+	{}
+
+	int        m_num_verts;
+	MT_Point3  m_p[4];
+	MT_Point3  m_q[4];
+	T_Start    m_start;
+	int        m_iterations;
+};
+
 class DT_GJK {
 private:
 	typedef unsigned int T_Bits;
@@ -70,6 +93,30 @@ public:
 		return false;
 	}
 
+#ifdef SIGNED_VOLUMES
+
+	// A vertex that coincides with another one or lies in the affine hull of 
+	// the others leaves the simplex without length, area or volume.
+    bool isAffinelyDependent() const 
+	{
+		int index[4];
+		switch (vertices(m_all_bits, index))
+		{
+		case 2:
+			return (m_y[index[1]] - m_y[index[0]]).length2() <= MT_Scalar(0.0);
+		case 3:
+			return (m_y[index[1]] - m_y[index[0]]).cross(m_y[index[2]] - m_y[index[0]]).length2() <= MT_Scalar(0.0);
+		case 4:
+			return volume(m_y[index[1]] - m_y[index[0]], 
+						  m_y[index[2]] - m_y[index[0]], 
+						  m_y[index[3]] - m_y[index[0]]) == MT_Scalar(0.0);
+		default:
+			return false;
+		}
+	}
+
+#else
+
     bool isAffinelyDependent() const 
 	{
         MT_Scalar sum(0.0);
@@ -85,6 +132,8 @@ public:
 		return sum <= MT_Scalar(0.0);
 	}
 
+#endif
+
 
 	void addVertex(const MT_Vector3& w) 
 	{
@@ -100,8 +149,10 @@ public:
 		m_ylen2[m_last] = w.length2();
         m_all_bits = m_bits | m_last_bit;
 
+#ifndef SIGNED_VOLUMES
 		update_cache();
 		compute_det();
+#endif
 	}
 
 	void addVertex(const MT_Vector3& w, const MT_Point3& p, const MT_Point3& q)
@@ -111,6 +162,48 @@ public:
 		m_q[m_last] = q;
 	}
 
+	// Rebuilds the simplex from the vertices of an earlier one, and computes 
+	// its point v closest to the origin. Returns false if the vertices are 
+	// degenerate, and leaves the simplex empty.
+	bool seed(const DT_Simplex& simplex, MT_Vector3& v)
+	{
+		reset();
+		int i;
+		for (i = 0; i != simplex.m_num_verts; ++i)
+		{
+			MT_Vector3 w = simplex.m_p[i] - simplex.m_q[i];
+			if (inSimplex(w))
+			{
+				reset();
+				return false;
+			}
+
+			addVertex(w, simplex.m_p[i], simplex.m_q[i]);
+			if (isAffinelyDependent() || !closest(v))
+			{
+				reset();
+				return false;
+			}
+		}
+		return !emptySimplex();
+	}
+
+	void getSimplex(DT_Simplex& simplex) const 
+	{
+		simplex.m_num_verts = 0;
+		int i;
+		T_Bits bit;
+		for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+		{
+			if (contains(m_bits, bit)) 
+			{
+				simplex.m_p[simplex.m_num_verts] = m_p[i];
+				simplex.m_q[simplex.m_num_verts] = m_q[i];
+				++simplex.m_num_verts;
+			}
+		}
+	}
+
 	int getSimplex(MT_Point3 *pBuf, MT_Point3 *qBuf, MT_Vector3 *yBuf) const 
 	{
 		int num_verts = 0;
@@ -134,6 +227,60 @@ public:
 		return num_verts;
     }
 
+#ifdef SIGNED_VOLUMES
+
+	void compute_points(MT_Point3& p1, MT_Point3& p2) 
+	{
+		p1.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+		p2.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+		int i;
+		T_Bits bit;
+		for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+		{
+			if (contains(m_bits, bit))
+			{
+				p1 += m_p[i] * m_lambda[i];
+				p2 += m_q[i] * m_lambda[i];
+			}
+		}
+	}
+
+	// The closest point lies in the smallest face of the simplex that the 
+	// origin projects into. The signs of the volumes that the origin spans 
+	// with the facets of a face tell whether the origin projects into it, 
+	// and if not, which facets to search. A degenerate face has no volume, 
+	// so all its facets are searched. This never fails, and the closest 
+	// point need not include the last vertex.
+	bool closest(MT_Vector3& v) 
+	{
+		int index[4];
+		switch (vertices(m_all_bits, index))
+		{
+		case 1:
+			m_bits = m_all_bits;
+			m_lambda[index[0]] = MT_Scalar(1.0);
+			break;
+		case 2:
+			m_bits = closestSegment(index[0], index[1], m_lambda);
+			break;
+		case 3:
+			m_bits = closestTriangle(index[0], index[1], index[2], m_lambda);
+			break;
+		default:
+			m_bits = closestTetrahedron(index, m_lambda);
+			break;
+		}
+		v = compute_vector(m_bits);
+		return true;
+	}
+
+	void backup_closest(MT_Vector3& v)
+	{
+		closest(v);
+	}
+	
+#else
+
 	void compute_points(MT_Point3& p1, MT_Point3& p2) 
 	{
 		MT_Scalar sum = MT_Scalar(0.0);
@@ -218,10 +365,197 @@ public:
 		}
 	}
 	
+#endif
+
 	MT_Scalar maxVertex() const { return m_maxlen2; }
 
 
 private:
+	static bool sameSign(MT_Scalar a, MT_Scalar b)
+	{
+		return (a > MT_Scalar(0.0) && b > MT_Scalar(0.0)) || (a < MT_Scalar(0.0) && b < MT_Scalar(0.0));
+	}
+
+	static MT_Scalar volume(const MT_Vector3& a, const MT_Vector3& b, const MT_Vector3& c)
+	{
+		return a.dot(b.cross(c));
+	}
+
+	// Returns the number of vertices in s, and their indices.
+	static int vertices(T_Bits s, int *index)
+	{
+		int num_verts = 0;
+		int i;
+		T_Bits bit;
+		for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+		{
+			if (contains(s, bit))
+			{
+				index[num_verts++] = i;
+			}
+		}
+		return num_verts;
+	}
+
+#ifdef SIGNED_VOLUMES
+
+	MT_Vector3 compute_vector(T_Bits s) 
+	{
+        MT_Vector3 v(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+		m_maxlen2 = MT_Scalar(0.0);
+
+		int i;
+		T_Bits bit;
+		for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+		{
+			if (contains(s, bit))
+			{
+				GEN_set_max(m_maxlen2, m_ylen2[i]);
+				v += m_y[i] * m_lambda[i];
+			}
+		}
+		return v;
+	}
+
+	// Makes the face s with barycentric coordinates l the closest one, if 
+	// its point is closer than that of the face in 'bits'.
+	void keepCloser(T_Bits s, const MT_Scalar *l, 
+					T_Bits& bits, MT_Scalar *lambda, MT_Scalar& min_dist2) const
+	{
+        MT_Vector3 u(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+		int i;
+		T_Bits bit;
+		for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+		{
+			if (contains(s, bit))
+			{
+				u += m_y[i] * l[i];
+			}
+		}
+
+		MT_Scalar dist2 = u.length2();
+		if (dist2 < min_dist2)
+		{
+			min_dist2 = dist2;
+			bits = s;
+			for (i = 0, bit = 0x1; i < 4; ++i, bit <<= 1) 
+			{
+				if (contains(s, bit))
+				{
+					lambda[i] = l[i];
+				}
+			}
+		}
+	}
+
+	T_Bits closestSegment(int i, int j, MT_Scalar *lambda) const
+	{
+		MT_Vector3 t = m_y[j] - m_y[i];
+		MT_Scalar ci = m_y[j].dot(t);
+		MT_Scalar cj = -m_y[i].dot(t);
+		if (cj <= MT_Scalar(0.0))
+		{
+			lambda[i] = MT_Scalar(1.0);
+			return 0x1 << i;
+		}
+		if (ci <= MT_Scalar(0.0))
+		{
+			lambda[j] = MT_Scalar(1.0);
+			return 0x1 << j;
+		}
+
+		MT_Scalar s = MT_Scalar(1.0) / (ci + cj);
+		lambda[i] = ci * s;
+		lambda[j] = cj * s;
+		return (0x1 << i) | (0x1 << j);
+	}
+
+	// The volumes are those of the origin and an edge, seen along the normal. 
+	T_Bits closestTriangle(int i, int j, int k, MT_Scalar *lambda) const
+	{
+		MT_Vector3 n = (m_y[j] - m_y[i]).cross(m_y[k] - m_y[i]);
+		MT_Scalar ci = n.dot(m_y[j].cross(m_y[k]));
+		MT_Scalar cj = n.dot(m_y[k].cross(m_y[i]));
+		MT_Scalar ck = n.dot(m_y[i].cross(m_y[j]));
+		if (ci > MT_Scalar(0.0) && cj > MT_Scalar(0.0) && ck > MT_Scalar(0.0))
+		{
+			MT_Scalar s = MT_Scalar(1.0) / (ci + cj + ck);
+			lambda[i] = ci * s;
+			lambda[j] = cj * s;
+			lambda[k] = ck * s;
+			return (0x1 << i) | (0x1 << j) | (0x1 << k);
+		}
+
+		T_Bits bits = 0x0;
+		MT_Scalar min_dist2 = MT_INFINITY;
+		MT_Scalar l[4];
+		if (ci <= MT_Scalar(0.0))
+		{
+			keepCloser(closestSegment(j, k, l), l, bits, lambda, min_dist2);
+		}
+		if (cj <= MT_Scalar(0.0))
+		{
+			keepCloser(closestSegment(k, i, l), l, bits, lambda, min_dist2);
+		}
+		if (ck <= MT_Scalar(0.0))
+		{
+			keepCloser(closestSegment(i, j, l), l, bits, lambda, min_dist2);
+		}
+		return bits;
+	}
+
+	// The volume for a vertex is that of the tetrahedron with the origin in 
+	// place of the vertex.
+	T_Bits closestTetrahedron(const int *index, MT_Scalar *lambda) const
+	{
+		const MT_Vector3& a = m_y[index[0]];
+		MT_Vector3 ab = m_y[index[1]] - a;
+		MT_Vector3 ac = m_y[index[2]] - a;
+		MT_Vector3 ad = m_y[index[3]] - a;
+
+		MT_Scalar c[4];
+		c[0] = volume(m_y[index[1]], m_y[index[2]], m_y[index[3]]);
+		c[1] = volume(-a, ac, ad);
+		c[2] = volume(ab, -a, ad);
+		c[3] = volume(ab, ac, -a);
+		MT_Scalar det = c[0] + c[1] + c[2] + c[3];
+
+		if (sameSign(det, c[0]) && sameSign(det, c[1]) && 
+			sameSign(det, c[2]) && sameSign(det, c[3]))
+		{
+			MT_Scalar s = MT_Scalar(1.0) / det;
+			int i;
+			for (i = 0; i != 4; ++i)
+			{
+				lambda[index[i]] = c[i] * s;
+			}
+			return 0xf;
+		}
+
+		T_Bits bits = 0x0;
+		MT_Scalar min_dist2 = MT_INFINITY;
+		MT_Scalar l[4];
+		if (!sameSign(det, c[0]))
+		{
+			keepCloser(closestTriangle(index[1], index[2], index[3], l), l, bits, lambda, min_dist2);
+		}
+		if (!sameSign(det, c[1]))
+		{
+			keepCloser(closestTriangle(index[0], index[2], index[3], l), l, bits, lambda, min_dist2);
+		}
+		if (!sameSign(det, c[2]))
+		{
+			keepCloser(closestTriangle(index[0], index[1], index[3], l), l, bits, lambda, min_dist2);
+		}
+		if (!sameSign(det, c[3]))
+		{
+			keepCloser(closestTriangle(index[0], index[1], index[2], l), l, bits, lambda, min_dist2);
+		}
+		return bits;
+	}
+
+#else
+
 	void update_cache();
 	void compute_det();
 
@@ -285,13 +619,19 @@ private:
 
 		return v / sum;
 	}
+
+#endif
  
 private:
+#ifdef SIGNED_VOLUMES
+	MT_Scalar	m_lambda[4]; // barycentric coordinates of the closest point
+#else
 	MT_Scalar	m_det[16][4]; // cached sub-determinants
     MT_Vector3	m_edge[4][4];
 
 #ifdef JOHNSON_ROBUST
     MT_Scalar	m_norm[4][4];
+#endif
 #endif
 
 	MT_Point3	m_p[4];    // support points of object A in local coordinates 
@@ -311,6 +651,8 @@ private:
 
 
 
+#ifndef SIGNED_VOLUMES
+
 inline void DT_GJK::update_cache() 
 {
 	int i;
@@ -550,3 +892,5 @@ inline void DT_GJK::compute_det()
 #endif
 
 #endif
+
+#endif
@@ -32,6 +32,8 @@ public:
 	   m_source(source), 
 	   m_target(target) {}
 
+	virtual DT_ShapeType getType() const { return LINESEGMENT; } 
+
     virtual MT_Scalar supportH(const MT_Vector3& v) const;
     virtual MT_Point3 support(const MT_Vector3& v) const;
 
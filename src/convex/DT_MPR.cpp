@@ -0,0 +1,277 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include <algorithm>
+
+#include "DT_MPR.h"
+#include "DT_Convex.h"
+#include "DT_Accuracy.h"
+#include "GEN_MinMax.h"
+
+// The refinement stops after this many support points if the portal does 
+// not converge, which happens for curved surfaces and very tight accuracies.
+const int MaxIterations = 64;
+
+// A vertex of the portal: a support point of A - B, and the support points 
+// of A and B that it is the difference of.
+
+class PortalVertex {
+public:
+	void setValue(const DT_Convex& a, const DT_Convex& b, const MT_Vector3& dir)
+	{
+		m_p = a.support(dir);
+		m_q = b.support(-dir);
+		m_w = m_p - m_q;
+	}
+
+	MT_Point3  m_p;
+	MT_Point3  m_q;
+	MT_Vector3 m_w;
+};
+
+// The mean of the support points along the coordinate axes lies in the 
+// object, and for symmetric objects it is the center.
+inline MT_Point3 interiorPoint(const DT_Convex& c)
+{
+	MT_Point3 sum = c.support(MT_Vector3(MT_Scalar(1.0), MT_Scalar(0.0), MT_Scalar(0.0))) +
+		            c.support(MT_Vector3(MT_Scalar(-1.0), MT_Scalar(0.0), MT_Scalar(0.0))) +
+		            c.support(MT_Vector3(MT_Scalar(0.0), MT_Scalar(1.0), MT_Scalar(0.0))) +
+		            c.support(MT_Vector3(MT_Scalar(0.0), MT_Scalar(-1.0), MT_Scalar(0.0))) +
+		            c.support(MT_Vector3(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(1.0))) +
+		            c.support(MT_Vector3(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(-1.0)));
+	return sum / MT_Scalar(6.0);
+}
+
+// The point of triangle 'v1' 'v2' 'v3' closest to the origin, as the 
+// weights of the vertices.
+inline void closestWeights(const MT_Vector3& v1, const MT_Vector3& v2, const MT_Vector3& v3, 
+						   MT_Scalar& l1, MT_Scalar& l2, MT_Scalar& l3)
+{
+	MT_Vector3 e12 = v2 - v1;
+	MT_Vector3 e13 = v3 - v1;
+
+	MT_Scalar d1 = -e12.dot(v1);
+	MT_Scalar d2 = -e13.dot(v1);
+	if (d1 <= MT_Scalar(0.0) && d2 <= MT_Scalar(0.0))
+	{
+		l1 = MT_Scalar(1.0); l2 = MT_Scalar(0.0); l3 = MT_Scalar(0.0);
+		return;
+	}
+
+	MT_Scalar d3 = -e12.dot(v2);
+	MT_Scalar d4 = -e13.dot(v2);
+	if (d3 >= MT_Scalar(0.0) && d4 <= d3)
+	{
+		l1 = MT_Scalar(0.0); l2 = MT_Scalar(1.0); l3 = MT_Scalar(0.0);
+		return;
+	}
+
+	MT_Scalar c3 = d1 * d4 - d3 * d2;
+	if (c3 <= MT_Scalar(0.0) && d1 >= MT_Scalar(0.0) && d3 <= MT_Scalar(0.0))
+	{
+		l2 = d1 / (d1 - d3); l1 = MT_Scalar(1.0) - l2; l3 = MT_Scalar(0.0);
+		return;
+	}
+
+	MT_Scalar d5 = -e12.dot(v3);
+	MT_Scalar d6 = -e13.dot(v3);
+	if (d6 >= MT_Scalar(0.0) && d5 <= d6)
+	{
+		l1 = MT_Scalar(0.0); l2 = MT_Scalar(0.0); l3 = MT_Scalar(1.0);
+		return;
+	}
+
+	MT_Scalar c2 = d5 * d2 - d1 * d6;
+	if (c2 <= MT_Scalar(0.0) && d2 >= MT_Scalar(0.0) && d6 <= MT_Scalar(0.0))
+	{
+		l3 = d2 / (d2 - d6); l1 = MT_Scalar(1.0) - l3; l2 = MT_Scalar(0.0);
+		return;
+	}
+
+	MT_Scalar c1 = d3 * d6 - d5 * d4;
+	if (c1 <= MT_Scalar(0.0) && d4 - d3 >= MT_Scalar(0.0) && d5 - d6 >= MT_Scalar(0.0))
+	{
+		l3 = (d4 - d3) / ((d4 - d3) + (d5 - d6)); l2 = MT_Scalar(1.0) - l3; l1 = MT_Scalar(0.0);
+		return;
+	}
+
+	MT_Scalar denom = MT_Scalar(1.0) / (c1 + c2 + c3);
+	l2 = c2 * denom;
+	l3 = c3 * denom;
+	l1 = MT_Scalar(1.0) - l2 - l3;
+}
+
+// Replaces a vertex of the portal by 'v4', such that the ray from 'v0' 
+// through the origin still passes through the portal.
+inline void expandPortal(const PortalVertex& v0, PortalVertex& v1, PortalVertex& v2, 
+						 PortalVertex& v3, const PortalVertex& v4)
+{
+	MT_Vector3 n = v4.m_w.cross(v0.m_w);
+	if (v1.m_w.dot(n) > MT_Scalar(0.0))
+	{
+		if (v2.m_w.dot(n) > MT_Scalar(0.0))
+		{
+			v1 = v4;
+		}
+		else
+		{
+			v3 = v4;
+		}
+	}
+	else
+	{
+		if (v3.m_w.dot(n) > MT_Scalar(0.0))
+		{
+			v2 = v4;
+		}
+		else
+		{
+			v1 = v4;
+		}
+	}
+}
+
+bool mprPenDepth(const DT_Convex& a, const DT_Convex& b, 
+				 MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	// Portal discovery: find a triangle of support points that the ray from
+	// the interior point 'v0' through the origin passes through. 
+	PortalVertex v0, v1, v2, v3;
+	v0.m_p = interiorPoint(a);
+	v0.m_q = interiorPoint(b);
+	v0.m_w = v0.m_p - v0.m_q;
+	if (v0.m_w.length2() == MT_Scalar(0.0))
+	{
+		// The origin is the interior point, so any ray will do.
+		v0.m_w.setValue(MT_EPSILON, MT_Scalar(0.0), MT_Scalar(0.0));
+	}
+
+	MT_Vector3 dir = -v0.m_w;
+	v1.setValue(a, b, dir);
+	if (v1.m_w.dot(dir) <= MT_Scalar(0.0))
+	{
+		return false;
+	}
+
+	dir = v0.m_w.cross(v1.m_w);
+	if (dir.length2() <= DT_Accuracy::tol_error * v0.m_w.length2() * v1.m_w.length2())
+	{
+		// The origin lies on the segment from 'v0' to 'v1'.
+		v = v1.m_w;
+		pa = v1.m_p;
+		pb = v1.m_q;
+		return true;
+	}
+	
+	v2.setValue(a, b, dir);
+	if (v2.m_w.dot(dir) <= MT_Scalar(0.0))
+	{
+		return false;
+	}
+
+	dir = (v1.m_w - v0.m_w).cross(v2.m_w - v0.m_w);
+	if (dir.dot(v0.m_w) > MT_Scalar(0.0))
+	{
+		std::swap(v1, v2);
+		dir = -dir;
+	}
+
+	int iterations = 0;
+	for (;;)
+	{
+		v3.setValue(a, b, dir);
+		if (v3.m_w.dot(dir) <= MT_Scalar(0.0))
+		{
+			return false;
+		}
+
+		if (v1.m_w.cross(v3.m_w).dot(v0.m_w) < MT_Scalar(0.0))
+		{
+			v2 = v3;
+		}
+		else if (v3.m_w.cross(v2.m_w).dot(v0.m_w) < MT_Scalar(0.0))
+		{
+			v1 = v3;
+		}
+		else 
+		{
+			break;
+		}
+
+		if (++iterations == MaxIterations)
+		{
+			return false;
+		}
+		dir = (v1.m_w - v0.m_w).cross(v2.m_w - v0.m_w);
+	}
+
+	// Portal refinement: move the portal outwards until it lies on the 
+	// boundary of A - B. The objects intersect if the origin lies behind
+	// the portal.
+	MT_Scalar rel_error = MT_sqrt(DT_Accuracy::rel_error2);
+	bool inside = false;
+	iterations = 0;
+	for (;;)
+	{
+		dir = (v2.m_w - v1.m_w).cross(v3.m_w - v1.m_w);
+		MT_Scalar len2 = dir.length2();
+		if (len2 == MT_Scalar(0.0))
+		{
+			break;
+		}
+		dir /= MT_sqrt(len2);
+
+		if (!inside && dir.dot(v1.m_w) >= MT_Scalar(0.0))
+		{
+			inside = true;
+		}
+
+		PortalVertex v4;
+		v4.setValue(a, b, dir);
+		MT_Scalar delta = v4.m_w.dot(dir);
+		if (!inside && delta <= MT_Scalar(0.0))
+		{
+			return false;
+		}
+
+		MT_Scalar gap = delta - GEN_max(GEN_max(v1.m_w.dot(dir), v2.m_w.dot(dir)), v3.m_w.dot(dir));
+		if (gap <= rel_error * delta + DT_Accuracy::tol_error || ++iterations == MaxIterations)
+		{
+			break;
+		}
+
+		expandPortal(v0, v1, v2, v3, v4);
+	}
+
+	if (!inside)
+	{
+		return false;
+	}
+
+	MT_Scalar l1, l2, l3;
+	closestWeights(v1.m_w, v2.m_w, v3.m_w, l1, l2, l3);
+	v  = v1.m_w * l1 + v2.m_w * l2 + v3.m_w * l3;
+	pa = v1.m_p * l1 + v2.m_p * l2 + v3.m_p * l3;
+	pb = v1.m_q * l1 + v2.m_q * l2 + v3.m_q * l3;
+	return true;
+}
@@ -0,0 +1,42 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_MPR_H
+#define DT_MPR_H
+
+#include "MT_Vector3.h"
+#include "MT_Point3.h"
+
+class DT_Convex;
+
+// Penetration depth by Minkowski portal refinement. The depth is measured
+// along the ray from an interior point of A - B through the origin, rather 
+// than along the shortest translation as found by the expanding polytope 
+// algorithm, so it is an upper bound that is close for shallow contacts. It
+// needs no GJK simplex and no workspace. Returns false if the objects do not
+// intersect. As for penDepth, 'v' is 'pa' - 'pb'.
+
+bool mprPenDepth(const DT_Convex& a, const DT_Convex& b, 
+				 MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+
+#endif
@@ -30,16 +30,32 @@
 //#define DEBUG
 
 
-const int       MaxSupportPoints = 100;
-const int       MaxFacets         = 200;
+// EPA converges in well under a hundred support points. The cap stops an
+// expansion that does not converge before isKnownVertex, which compares 
+// each new support point with all earlier ones, gets expensive. 
+const int       MaxSupportPoints = 1024;
+const int       InitialSupportPoints = 32;
 
-static MT_Point3  pBuf[MaxSupportPoints];
-static MT_Point3  qBuf[MaxSupportPoints];
-static MT_Vector3 yBuf[MaxSupportPoints];
+DT_EPAWorkspace::DT_EPAWorkspace()
+{
+	reserve(InitialSupportPoints);
+}
 
+void DT_EPAWorkspace::reserve(int num_verts)
+{
+	if (num_verts > capacity())
+	{
+		m_pBuf.resize(num_verts);
+		m_qBuf.resize(num_verts);
+		m_yBuf.resize(num_verts);
+	}
+}
 
-static Triangle *triangleHeap[MaxFacets];
-static int  num_triangles;
+DT_EPAWorkspace& DT_EPAWorkspace::local()
+{
+	static thread_local DT_EPAWorkspace workspace;
+	return workspace;
+}
 
 class TriangleComp
 {
@@ -51,12 +67,12 @@ public:
     }
 } triangleComp;
 
-inline void addCandidate(Triangle *triangle, MT_Scalar upper2) 
+inline void addCandidate(std::vector<Triangle *>& triangleHeap, Triangle *triangle, MT_Scalar upper2) 
 {
     if (triangle->isClosestInternal() && triangle->getDist2() <= upper2)
     {
-        triangleHeap[num_triangles++] = triangle;
-        std::push_heap(&triangleHeap[0], &triangleHeap[num_triangles], triangleComp);
+        triangleHeap.push_back(triangle);
+        std::push_heap(triangleHeap.begin(), triangleHeap.end(), triangleComp);
 #ifdef DEBUG
         std::cout << " accepted" << std::endl;
 #endif
@@ -78,6 +94,22 @@ inline void addCandidate(Triangle *triangle, MT_Scalar upper2)
     }
 }		
 
+// A support point that is already a vertex of the polytope cannot expand it. 
+// Without this check, rounding errors may make the loop alternate between 
+// a few vertices until the support point buffers are exhausted.
+inline bool isKnownVertex(const MT_Vector3 *verts, int index)
+{
+	int i;
+	for (i = 0; i != index; ++i)
+	{
+		if (verts[i] == verts[index])
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 inline int originInTetrahedron(const MT_Vector3& p1, const MT_Vector3& p2, 
                                const MT_Vector3& p3, const MT_Vector3& p4)
 {
@@ -109,15 +141,20 @@ inline int originInTetrahedron(const MT_Vector3& p1, const MT_Vector3& p2,
 }
 
 bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
-              MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+              MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_EPAWorkspace& workspace)
 {
+	MT_Point3  *pBuf = workspace.pBuf();
+	MT_Point3  *qBuf = workspace.qBuf();
+	MT_Vector3 *yBuf = workspace.yBuf();
+	std::vector<Triangle *>& triangleHeap = workspace.triangleHeap();
+	TriangleStore& triangleStore = workspace.triangleStore();
 	
 	int num_verts = gjk.getSimplex(pBuf, qBuf, yBuf);
     MT_Scalar tolerance = DT_Accuracy::tol_error * gjk.maxVertex();
     
-    num_triangles = 0;
+    triangleHeap.clear();
     
-    g_triangleStore.clear();
+    triangleStore.clear();
 	
     switch (num_verts) 
     {
@@ -183,10 +220,10 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
         
         if (bad_vertex == 0)
         {
-            Triangle *f0 = g_triangleStore.newTriangle(yBuf, 0, 1, 2);
-            Triangle *f1 = g_triangleStore.newTriangle(yBuf, 0, 3, 1);
-            Triangle *f2 = g_triangleStore.newTriangle(yBuf, 0, 2, 3);
-            Triangle *f3 = g_triangleStore.newTriangle(yBuf, 1, 3, 2);
+            Triangle *f0 = triangleStore.newTriangle(yBuf, 0, 1, 2);
+            Triangle *f1 = triangleStore.newTriangle(yBuf, 0, 3, 1);
+            Triangle *f2 = triangleStore.newTriangle(yBuf, 0, 2, 3);
+            Triangle *f3 = triangleStore.newTriangle(yBuf, 1, 3, 2);
             
             if (!(f0 && f0->getDist2() > MT_Scalar(0.0) &&
                   f1 && f1->getDist2() > MT_Scalar(0.0) &&
@@ -203,10 +240,10 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
             link(Edge(f1, 1), Edge(f3, 0));
             link(Edge(f2, 1), Edge(f3, 1));
             
-            addCandidate(f0, MT_INFINITY);
-            addCandidate(f1, MT_INFINITY);
-            addCandidate(f2, MT_INFINITY);
-            addCandidate(f3, MT_INFINITY);
+            addCandidate(triangleHeap, f0, MT_INFINITY);
+            addCandidate(triangleHeap, f1, MT_INFINITY);
+            addCandidate(triangleHeap, f2, MT_INFINITY);
+            addCandidate(triangleHeap, f3, MT_INFINITY);
             break;
         }
         
@@ -238,12 +275,12 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
         qBuf[4] = b.support(vv);
         yBuf[4] = pBuf[4] - qBuf[4];
 	    
-        Triangle* f0 = g_triangleStore.newTriangle(yBuf, 0, 1, 3);
-        Triangle* f1 = g_triangleStore.newTriangle(yBuf, 1, 2, 3);
-        Triangle* f2 = g_triangleStore.newTriangle(yBuf, 2, 0, 3); 
-        Triangle* f3 = g_triangleStore.newTriangle(yBuf, 0, 2, 4);
-        Triangle* f4 = g_triangleStore.newTriangle(yBuf, 2, 1, 4);
-        Triangle* f5 = g_triangleStore.newTriangle(yBuf, 1, 0, 4);
+        Triangle* f0 = triangleStore.newTriangle(yBuf, 0, 1, 3);
+        Triangle* f1 = triangleStore.newTriangle(yBuf, 1, 2, 3);
+        Triangle* f2 = triangleStore.newTriangle(yBuf, 2, 0, 3); 
+        Triangle* f3 = triangleStore.newTriangle(yBuf, 0, 2, 4);
+        Triangle* f4 = triangleStore.newTriangle(yBuf, 2, 1, 4);
+        Triangle* f5 = triangleStore.newTriangle(yBuf, 1, 0, 4);
         
         if (!(f0 && f0->getDist2() > MT_Scalar(0.0) &&
               f1 && f1->getDist2() > MT_Scalar(0.0) &&
@@ -267,12 +304,12 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
         link(Edge(f4, 1), Edge(f5, 2));
         link(Edge(f5, 1), Edge(f3, 2));
 	    
-        addCandidate(f0, MT_INFINITY);
-        addCandidate(f1, MT_INFINITY);
-        addCandidate(f2, MT_INFINITY);
-        addCandidate(f3, MT_INFINITY);  
-        addCandidate(f4, MT_INFINITY);
-        addCandidate(f5, MT_INFINITY);
+        addCandidate(triangleHeap, f0, MT_INFINITY);
+        addCandidate(triangleHeap, f1, MT_INFINITY);
+        addCandidate(triangleHeap, f2, MT_INFINITY);
+        addCandidate(triangleHeap, f3, MT_INFINITY);  
+        addCandidate(triangleHeap, f4, MT_INFINITY);
+        addCandidate(triangleHeap, f5, MT_INFINITY);
 	    
         num_verts = 5;
     }
@@ -282,7 +319,7 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
     // We have a polytope inside the Minkowski sum containing
     // the origin.
     
-    if (num_triangles == 0)
+    if (triangleHeap.empty())
     {
         return false;
     }
@@ -295,9 +332,9 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
     
     do 
     {
-        triangle = triangleHeap[0];
-        std::pop_heap(&triangleHeap[0], &triangleHeap[num_triangles], triangleComp);
-        --num_triangles;
+        triangle = triangleHeap.front();
+        std::pop_heap(triangleHeap.begin(), triangleHeap.end(), triangleComp);
+        triangleHeap.pop_back();
 		
         if (!triangle->isObsolete()) 
         {
@@ -309,6 +346,14 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
                 assert(false);	
                 break;
             }
+
+            if (num_verts == workspace.capacity())
+            {
+                workspace.reserve(GEN_min(2 * num_verts, MaxSupportPoints));
+                pBuf = workspace.pBuf();
+                qBuf = workspace.qBuf();
+                yBuf = workspace.yBuf();
+            }
 			
             pBuf[num_verts] = a.support( triangle->getClosest());
             qBuf[num_verts] = b.support(-triangle->getClosest());
@@ -325,9 +370,7 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
             MT_Scalar error = far_dist - triangle->getDist2();
             if (error <= GEN_max(DT_Accuracy::rel_error2 * far_dist, tolerance)
 #if 1
-                || yBuf[index] == yBuf[(*triangle)[0]] 
-                || yBuf[index] == yBuf[(*triangle)[1]]
-                || yBuf[index] == yBuf[(*triangle)[2]]
+                || isKnownVertex(yBuf, index)
 #endif
                 ) 
             {
@@ -341,28 +384,28 @@ bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b,
             // not be in the convex hull. Start local search
             // from this triangle.
 			
-            int i = g_triangleStore.getFree();
+            int i = triangleStore.getFree();
             
-            if (!triangle->silhouette(yBuf, index, g_triangleStore))
+            if (!triangle->silhouette(yBuf, index, triangleStore))
             {
                 break;
             }
 			
-            while (i != g_triangleStore.getFree())
+            while (i != triangleStore.getFree())
             {
-                Triangle *newTriangle = &g_triangleStore[i];
+                Triangle *newTriangle = &triangleStore[i];
                 //assert(triangle->getDist2() <= newTriangle->getDist2());
                 
-                addCandidate(newTriangle, upper_bound2);
+                addCandidate(triangleHeap, newTriangle, upper_bound2);
                 
                 ++i;
             }
         }
     }
-    while (num_triangles > 0 && triangleHeap[0]->getDist2() <= upper_bound2);
+    while (!triangleHeap.empty() && triangleHeap.front()->getDist2() <= upper_bound2);
 	
 #ifdef DEBUG    
-    std::cout << "#triangles left = " << num_triangles << std::endl;
+    std::cout << "#triangles left = " << triangleHeap.size() << std::endl;
 #endif
     
     v = triangle->getClosest();
@@ -24,13 +24,49 @@
 #ifndef DT_PENDEPTH_H
 #define DT_PENDEPTH_H
 
+#include <vector>
+
 #include "MT_Vector3.h"
 #include "MT_Point3.h"
+#include "DT_TriEdge.h"
 
 class DT_GJK;
 class DT_Convex;
 
+// Scratch space of the expanding polytope algorithm. The buffers grow as 
+// needed and keep their memory from one query to the next. A workspace 
+// serves one query at a time, so concurrent queries need one each.
+
+class DT_EPAWorkspace {
+public:
+	DT_EPAWorkspace();
+
+	// Grows the support point buffers to hold at least num_verts points.
+	void reserve(int num_verts);
+	int  capacity() const { return m_yBuf.size(); }
+	
+	MT_Point3  *pBuf() { return &m_pBuf[0]; }
+	MT_Point3  *qBuf() { return &m_qBuf[0]; }
+	MT_Vector3 *yBuf() { return &m_yBuf[0]; }
+
+	std::vector<Triangle *>& triangleHeap()  { return m_triangleHeap; }
+	TriangleStore&           triangleStore() { return m_triangleStore; }
+
+	// The workspace of the calling thread.
+	static DT_EPAWorkspace& local();
+
+private:
+	DT_EPAWorkspace(const DT_EPAWorkspace&);
+	DT_EPAWorkspace& operator=(const DT_EPAWorkspace&);
+
+	std::vector<MT_Point3>   m_pBuf;
+	std::vector<MT_Point3>   m_qBuf;
+	std::vector<MT_Vector3>  m_yBuf;
+	std::vector<Triangle *>  m_triangleHeap;
+	TriangleStore            m_triangleStore;
+};
+
 bool penDepth(const DT_GJK& gjk, const DT_Convex& a, const DT_Convex& b, 
-			  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+			  MT_Vector3& v, MT_Point3& pa, MT_Point3& pb, DT_EPAWorkspace& workspace);
 
 #endif
@@ -25,9 +25,7 @@
 
 #ifdef QHULL
 
-extern "C" {
-	#include <qhull/qhull_a.h>
-}
+#include "DT_QuickHull.h"
 
 #include <vector>
 #include <new>  
@@ -36,64 +34,14 @@ typedef std::vector<MT_Point3> T_VertexBuf;
 typedef std::vector<DT_Index> T_IndexBuf;
 typedef std::vector<T_IndexBuf> T_MultiIndexBuf;
 
-static char options[] = "qhull Qts i Tv";
-
 #define DK_HIERARCHY
 
-T_IndexBuf *adjacency_graph(DT_Count count, const MT_Point3 *verts, const char *flags)
+T_IndexBuf *adjacency_graph(DT_QuickHull& hull, DT_Count count, const MT_Point3 *verts, const char *flags)
 {
-	/*int curlong, totlong, exitcode;
+	hull.compute(count, verts, flags);
 	
-    facetT *facet;
-    vertexT *vertex;
-    vertexT **vertexp;
-    
-    std::vector<MT::Tuple3<coordT> > array;
-	T_IndexBuf index;
-    DT_Index i;
-    for (i = 0; i != count; ++i) 
-	{
-		if (flags == 0 || flags[i])
-		{
-            array.push_back(MT::Tuple3<coordT>(verts[i]));
-			index.push_back(i);
-		}
-    }
-
-    qh_init_A(stdin, stdout, stderr, 0, NULL);
-    if ((exitcode = setjmp(qh errexit))) 
-	{
-		exit(exitcode);
-	}
-    qh_initflags(options);
-    qh_init_B(array[0], array.size(), 3, False);
-    qh_qhull();
-    qh_check_output();
-    
-    T_IndexBuf *indexBuf = new T_IndexBuf[count];
-    FORALLfacets 
-	{
-		setT *vertices = qh_facet3vertex(facet);
-		
-		T_IndexBuf  facetIndices;
-
-		FOREACHvertex_(vertices) 
-		{
-			facetIndices.push_back(index[qh_pointid(vertex->point)]);
-		}
-		int i, j;
-		for (i = 0, j = facetIndices.size()-1; i < (int)facetIndices.size(); j = i++)
-		{
-			indexBuf[facetIndices[j]].push_back(facetIndices[i]);
-		}
-    }
-
-    
-    qh NOerrexit = True;
-    qh_freeqhull(!qh_ALL);
-    qh_memfreeshort(&curlong, &totlong);*/
-
-	T_IndexBuf* indexBuf = new T_IndexBuf[count];
+	T_IndexBuf *indexBuf = new T_IndexBuf[count];
+	hull.adjacency(indexBuf);
 	return indexBuf;
 }
 
@@ -184,24 +132,46 @@ DT_Polyhedron::DT_Polyhedron(const DT_VertexBase *base, DT_Count count, const DT
 		vertexBuf.push_back((*base)[indices[i]]);
 	}
 
-	T_IndexBuf *indexBuf = count > 4 ? adjacency_graph(count, &vertexBuf[0], 0) : simplex_adjacency_graph(count, 0);
+	// One hull object serves all layers, so that its buffers are reused.
+	DT_QuickHull hull;
+
+	T_IndexBuf *indexBuf = count > 4 ? adjacency_graph(hull, count, &vertexBuf[0], 0) : simplex_adjacency_graph(count, 0);
 	
 	std::vector<MT_Point3> pointBuf;
+	T_IndexBuf pointIndex(count);
 	
 	for (i = 0; i != count; ++i) 
 	{
 		if (!indexBuf[i].empty()) 
 		{
+			pointIndex[i] = pointBuf.size();
 			pointBuf.push_back(vertexBuf[i]);
 		}
 	}
-			
-	delete [] indexBuf;
 
 	m_count = pointBuf.size();
 	m_verts = new MT_Point3[m_count];	
 	std::copy(pointBuf.begin(), pointBuf.end(), &m_verts[0]);
 
+	// The hull of all vertices serves as the first layer. Computing it 
+	// again for the hull vertices only might not reproduce the same 
+	// vertices where vertices are coplanar up to rounding.
+	T_IndexBuf *layerBuf = new T_IndexBuf[m_count];
+	for (i = 0; i != count; ++i) 
+	{
+		if (!indexBuf[i].empty()) 
+		{
+			T_IndexBuf& adjacent = layerBuf[pointIndex[i]];
+			DT_Index j;
+			for (j = 0; j != indexBuf[i].size(); ++j)
+			{
+				adjacent.push_back(pointIndex[indexBuf[i][j]]);
+			}
+		}
+	}
+			
+	delete [] indexBuf;
+
 	T_MultiIndexBuf *cobound = new T_MultiIndexBuf[m_count];
     char *flags = new char[m_count];
 	std::fill(&flags[0], &flags[m_count], 1);
@@ -210,15 +180,24 @@ DT_Polyhedron::DT_Polyhedron(const DT_VertexBase *base, DT_Count count, const DT
 	DT_Count layer_count = m_count;
 	while (layer_count > 4)
 	{
-		T_IndexBuf *indexBuf = adjacency_graph(m_count, m_verts, flags);
+		T_IndexBuf *indexBuf = layerBuf != 0 ? layerBuf : adjacency_graph(hull, m_count, m_verts, flags);
+		layerBuf = 0;
 		
 		DT_Index i;
 		for (i = 0; i != m_count; ++i) 
 		{
 			if (flags[i])
 			{
-				assert(!indexBuf[i].empty());
-				cobound[i].push_back(indexBuf[i]);
+				// A vertex that lies on the hull of the coarser layer 
+				// up to rounding is left out of that layer.
+				if (indexBuf[i].empty())
+				{
+					flags[i] = 0;
+				}
+				else
+				{
+					cobound[i].push_back(indexBuf[i]);
+				}
 			}
 		}
 			
@@ -255,6 +234,8 @@ DT_Polyhedron::DT_Polyhedron(const DT_VertexBase *base, DT_Count count, const DT
 		}	
 	}
 	
+	delete [] layerBuf;
+
 	indexBuf = simplex_adjacency_graph(m_count, flags);
 		
 	for (i = 0; i != m_count; ++i) 
@@ -313,20 +294,20 @@ DT_Polyhedron::~DT_Polyhedron()
 
 MT_Scalar DT_Polyhedron::supportH(const MT_Vector3& v) const 
 {
-    m_curr_vertex = m_start_vertex;
-    MT_Scalar d = (*this)[m_curr_vertex].dot(v);
+    DT_Index curr_vertex = m_start_vertex;
+    MT_Scalar d = (*this)[curr_vertex].dot(v);
     MT_Scalar h = d;
 	int curr_layer;
 	for (curr_layer = m_cobound[m_start_vertex].size(); curr_layer != 0; --curr_layer)
 	{
-		const DT_IndexArray& curr_cobound = m_cobound[m_curr_vertex][curr_layer-1];
+		const DT_IndexArray& curr_cobound = m_cobound[curr_vertex][curr_layer-1];
         DT_Index i;
 		for (i = 0; i != curr_cobound.size(); ++i) 
 		{
 			d = (*this)[curr_cobound[i]].dot(v);
 			if (d > h)
 			{
-				m_curr_vertex = curr_cobound[i];
+				curr_vertex = curr_cobound[i];
 				h = d;
 			}
 		}
@@ -337,26 +318,26 @@ MT_Scalar DT_Polyhedron::supportH(const MT_Vector3& v) const
 
 MT_Point3 DT_Polyhedron::support(const MT_Vector3& v) const 
 {
-	m_curr_vertex = m_start_vertex;
-    MT_Scalar d = (*this)[m_curr_vertex].dot(v);
+	DT_Index curr_vertex = m_start_vertex;
+    MT_Scalar d = (*this)[curr_vertex].dot(v);
     MT_Scalar h = d;
 	int curr_layer;
 	for (curr_layer = m_cobound[m_start_vertex].size(); curr_layer != 0; --curr_layer)
 	{
-		const DT_IndexArray& curr_cobound = m_cobound[m_curr_vertex][curr_layer-1];
+		const DT_IndexArray& curr_cobound = m_cobound[curr_vertex][curr_layer-1];
         DT_Index i;
 		for (i = 0; i != curr_cobound.size(); ++i) 
 		{
 			d = (*this)[curr_cobound[i]].dot(v);
 			if (d > h)
 			{
-				m_curr_vertex = curr_cobound[i];
+				curr_vertex = curr_cobound[i];
 				h = d;
 			}
 		}
 	}
 	
-    return (*this)[m_curr_vertex];
+    return (*this)[curr_vertex];
 }
 
 #else
@@ -364,12 +345,13 @@ MT_Point3 DT_Polyhedron::support(const MT_Vector3& v) const
 MT_Scalar DT_Polyhedron::supportH(const MT_Vector3& v) const 
 {
     int last_vertex = -1;
-    MT_Scalar d = (*this)[m_curr_vertex].dot(v);
+    DT_Index curr_vertex = m_curr_vertex.load(std::memory_order_relaxed);
+    MT_Scalar d = (*this)[curr_vertex].dot(v);
     MT_Scalar h = d;
 	
 	for (;;) 
 	{
-        DT_IndexArray& curr_cobound = m_cobound[m_curr_vertex][0];
+        DT_IndexArray& curr_cobound = m_cobound[curr_vertex][0];
         int i = 0, n = curr_cobound.size(); 
         while (i != n && 
                (curr_cobound[i] == last_vertex || 
@@ -383,22 +365,24 @@ MT_Scalar DT_Polyhedron::supportH(const MT_Vector3& v) const
 			break;
 		}
 		
-        last_vertex = m_curr_vertex;
-        m_curr_vertex = curr_cobound[i];
+        last_vertex = curr_vertex;
+        curr_vertex = curr_cobound[i];
         h = d;
     }
+    m_curr_vertex.store(curr_vertex, std::memory_order_relaxed);
     return h;
 }
 
 MT_Point3 DT_Polyhedron::support(const MT_Vector3& v) const 
 {
 	int last_vertex = -1;
-    MT_Scalar d = (*this)[m_curr_vertex].dot(v);
+    DT_Index curr_vertex = m_curr_vertex.load(std::memory_order_relaxed);
+    MT_Scalar d = (*this)[curr_vertex].dot(v);
     MT_Scalar h = d;
 	
     for (;;)
 	{
-        DT_IndexArray& curr_cobound = m_cobound[m_curr_vertex][0];
+        DT_IndexArray& curr_cobound = m_cobound[curr_vertex][0];
         int i = 0, n = curr_cobound.size();
         while (i != n && 
                (curr_cobound[i] == last_vertex || 
@@ -412,11 +396,12 @@ MT_Point3 DT_Polyhedron::support(const MT_Vector3& v) const
 			break;
 		}
 		
-		last_vertex = m_curr_vertex;
-        m_curr_vertex = curr_cobound[i];
+		last_vertex = curr_vertex;
+        curr_vertex = curr_cobound[i];
         h = d;
     }
-    return (*this)[m_curr_vertex];
+    m_curr_vertex.store(curr_vertex, std::memory_order_relaxed);
+    return (*this)[curr_vertex];
 }
 
 #endif
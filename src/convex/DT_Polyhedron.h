@@ -24,17 +24,14 @@
 #ifndef DT_POLYHEDRON_H
 #define DT_POLYHEDRON_H
 
-#ifdef HAVE_CONFIG_H
-# include "config.h"
-# if HAVE_QHULL_QHULL_A_H
-#  define QHULL
-# endif
-#endif
-
+// The hull of the vertices is computed by DT_QuickHull, so the 
+// hill-climbing polyhedron no longer depends on an external qhull.
 #define QHULL
 
 #ifdef QHULL
 
+#include <atomic>
+
 #include "DT_Convex.h"
 #include "DT_IndexArray.h"
 #include "DT_VertexBase.h"
@@ -62,7 +59,9 @@ private:
 	MT_Point3			 *m_verts;
 	T_MultiIndexArray    *m_cobound;
     DT_Index              m_start_vertex;
-	mutable DT_Index      m_curr_vertex;
+	// Start of the next hill climb. Only a hint, so concurrent support 
+	// queries may overwrite each other's value.
+	mutable std::atomic<DT_Index> m_curr_vertex;
 };
 
 #else 
@@ -25,13 +25,15 @@
 
 MT_BBox DT_Polytope::bbox() const 
 {
-	MT_BBox bbox = (*this)[0];
+	MT_Point3 min = (*this)[0], max = min;
 	DT_Index i;
     for (i = 1; i < numVerts(); ++i) 
 	{
-        bbox = bbox.hull((*this)[i]);
+		MT_Point3 p = (*this)[i];
+		min.setMin(p);
+		max.setMax(p);
     }
-    return bbox;
+    return MT_BBox(min, max);
 }
 
 MT_Scalar DT_Polytope::supportH(const MT_Vector3& v) const 
@@ -0,0 +1,376 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "DT_Primitive.h"
+#include "DT_Sphere.h"
+#include "DT_Box.h"
+#include "DT_LineSegment.h"
+#include "DT_Accuracy.h"
+#include "GEN_MinMax.h"
+
+// Returns whether the columns of basis are orthogonal. Relative errors up to 
+// the accuracy of the distance computations are ignored. The column lengths 
+// are returned in scale.
+static bool orthogonal(const MT_Matrix3x3& basis, MT_Vector3& scale)
+{
+	MT_Matrix3x3 m = basis.transposeTimes(basis);
+	if (m[0][1] * m[0][1] > DT_Accuracy::rel_error2 * m[0][0] * m[1][1] ||
+		m[0][2] * m[0][2] > DT_Accuracy::rel_error2 * m[0][0] * m[2][2] ||
+		m[1][2] * m[1][2] > DT_Accuracy::rel_error2 * m[1][1] * m[2][2])
+	{
+		return false;
+	}
+	scale.setValue(MT_sqrt(m[0][0]), MT_sqrt(m[1][1]), MT_sqrt(m[2][2]));
+	return true;
+}
+
+bool DT_WorldSphere::setValue(const DT_Sphere& sphere, const MT_Transform& xform, MT_Scalar margin)
+{
+	MT_Vector3 scale;
+	if (!orthogonal(xform.getBasis(), scale) ||
+		!(MT_abs(scale[0] - scale[1]) <= MT_sqrt(DT_Accuracy::rel_error2) * scale[0] &&
+		  MT_abs(scale[0] - scale[2]) <= MT_sqrt(DT_Accuracy::rel_error2) * scale[0]))
+	{
+		return false;
+	}
+	m_center = xform.getOrigin();
+	m_margin = sphere.getRadius() * scale[0] + margin;
+	return true;
+}
+
+MT_Scalar DT_WorldSphere::nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const
+{
+	q = m_center;
+	n = p - q;
+	MT_Scalar dist = n.length();
+	if (dist > MT_Scalar(0.0))
+	{
+		n /= dist;
+	}
+	else
+	{
+		n.setValue(MT_Scalar(1.0), MT_Scalar(0.0), MT_Scalar(0.0));
+	}
+	return dist;
+}
+
+bool DT_WorldBox::setValue(const DT_Box& box, const MT_Transform& xform, MT_Scalar margin)
+{
+	MT_Vector3 scale;
+	if (!orthogonal(xform.getBasis(), scale))
+	{
+		return false;
+	}
+	const MT_Matrix3x3& basis = xform.getBasis();
+	int i;
+	for (i = 0; i != 3; ++i)
+	{
+		m_axis[i].setValue(basis[0][i] / scale[i], basis[1][i] / scale[i], basis[2][i] / scale[i]);
+		m_extent[i] = box.getExtent()[i] * scale[i];
+	}
+	m_center = xform.getOrigin();
+	m_margin = margin;
+	return true;
+}
+
+MT_Scalar DT_WorldBox::nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const
+{
+	MT_Vector3 d = p - m_center;
+	MT_Scalar local[3];
+	bool inside = true;
+	int i;
+	for (i = 0; i != 3; ++i)
+	{
+		local[i] = m_axis[i].dot(d);
+		if (local[i] < -m_extent[i])
+		{
+			local[i] = -m_extent[i];
+			inside = false;
+		}
+		else if (local[i] > m_extent[i])
+		{
+			local[i] = m_extent[i];
+			inside = false;
+		}
+	}
+
+	if (!inside)
+	{
+		q = m_center + m_axis[0] * local[0] + m_axis[1] * local[1] + m_axis[2] * local[2];
+		n = p - q;
+		MT_Scalar dist = n.length();
+		if (dist > MT_Scalar(0.0))
+		{
+			n /= dist;
+			return dist;
+		}
+	}
+
+	// p is inside the box. The nearest point is on the nearest face.
+	int k = 0;
+	for (i = 1; i != 3; ++i)
+	{
+		if (m_extent[i] - MT_abs(local[i]) < m_extent[k] - MT_abs(local[k]))
+		{
+			k = i;
+		}
+	}
+	MT_Scalar side = local[k] < MT_Scalar(0.0) ? -m_extent[k] : m_extent[k];
+	q = p + m_axis[k] * (side - local[k]);
+	n = local[k] < MT_Scalar(0.0) ? -m_axis[k] : m_axis[k];
+	return MT_abs(local[k]) - m_extent[k];
+}
+
+bool DT_WorldSegment::setValue(const DT_LineSegment& segment, const MT_Transform& xform, MT_Scalar margin)
+{
+	m_source = xform(segment.getSource());
+	m_target = xform(segment.getTarget());
+	m_margin = margin;
+	return true;
+}
+
+MT_Scalar DT_WorldSegment::nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const
+{
+	MT_Vector3 r = m_target - m_source;
+	MT_Scalar r_length2 = r.length2();
+	MT_Scalar lambda = r_length2 > MT_Scalar(0.0) ? (p - m_source).dot(r) / r_length2 : MT_Scalar(0.0);
+	GEN_set_max(lambda, MT_Scalar(0.0));
+	GEN_set_min(lambda, MT_Scalar(1.0));
+	q = m_source + r * lambda;
+	n = p - q;
+	MT_Scalar dist = n.length();
+	if (dist > MT_Scalar(0.0))
+	{
+		n /= dist;
+	}
+	else 
+		// p is on the segment. Any direction orthogonal to the segment will do.
+	{
+		int axis = r.closestAxis();
+		MT_Vector3 e(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+		e[(axis + 1) % 3] = MT_Scalar(1.0);
+		n = r_length2 > MT_Scalar(0.0) ? r.cross(e).normalized() : e;
+	}
+	return dist;
+}
+
+// All queries of a sphere against a primitive b follow from the point of b 
+// nearest to the center of the sphere. 
+
+template <typename Primitive>
+inline bool sphereIntersect(const DT_WorldSphere& a, const Primitive& b, MT_Vector3& v)
+{
+	MT_Point3 q;
+	MT_Vector3 n;
+	MT_Scalar gap = b.nearest(a.m_center, q, n) - a.m_margin - b.m_margin;
+	if (gap > MT_Scalar(0.0))
+	{
+		v = n * gap;
+		return false;
+	}
+	v.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+	return true;
+}
+
+template <typename Primitive>
+inline bool sphereCommonPoint(const DT_WorldSphere& a, const Primitive& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	MT_Point3 q;
+	MT_Vector3 n;
+	MT_Scalar dist = b.nearest(a.m_center, q, n);
+	MT_Scalar gap = dist - a.m_margin - b.m_margin;
+	if (gap > MT_Scalar(0.0))
+	{
+		v = n * gap;
+		return false;
+	}
+	// The point of b nearest to the center, or the center if it lies in b.
+	pa = pb = a.m_center - n * GEN_max(dist - b.m_margin, MT_Scalar(0.0));
+	v.setValue(MT_Scalar(0.0), MT_Scalar(0.0), MT_Scalar(0.0));
+	return true;
+}
+
+template <typename Primitive>
+inline bool spherePenetrationDepth(const DT_WorldSphere& a, const Primitive& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	MT_Point3 q;
+	MT_Vector3 n;
+	MT_Scalar gap = b.nearest(a.m_center, q, n) - a.m_margin - b.m_margin;
+	v = n * gap;
+	if (gap > MT_Scalar(0.0))
+	{
+		return false;
+	}
+	pa = a.m_center - n * a.m_margin;
+	pb = q + n * b.m_margin;
+	return true;
+}
+
+template <typename Primitive>
+inline MT_Scalar sphereClosestPoints(const DT_WorldSphere& a, const Primitive& b, MT_Point3& pa, MT_Point3& pb)
+{
+	MT_Point3 q;
+	MT_Vector3 n;
+	MT_Scalar dist = b.nearest(a.m_center, q, n);
+	MT_Scalar gap = dist - a.m_margin - b.m_margin;
+	if (gap > MT_Scalar(0.0))
+	{
+		pa = a.m_center - n * a.m_margin;
+		pb = q + n * b.m_margin;
+		return gap * gap;
+	}
+	pa = pb = a.m_center - n * GEN_max(dist - b.m_margin, MT_Scalar(0.0));
+	return MT_Scalar(0.0);
+}
+
+bool intersect(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v)
+{
+	return sphereIntersect(a, b, v);
+}
+
+bool intersect(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v)
+{
+	return sphereIntersect(a, b, v);
+}
+
+bool intersect(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v)
+{
+	return sphereIntersect(a, b, v);
+}
+
+bool common_point(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereCommonPoint(a, b, v, pa, pb);
+}
+
+bool common_point(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereCommonPoint(a, b, v, pa, pb);
+}
+
+bool common_point(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereCommonPoint(a, b, v, pa, pb);
+}
+
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return spherePenetrationDepth(a, b, v, pa, pb);
+}
+
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return spherePenetrationDepth(a, b, v, pa, pb);
+}
+
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb)
+{
+	return spherePenetrationDepth(a, b, v, pa, pb);
+}
+
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereClosestPoints(a, b, pa, pb);
+}
+
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereClosestPoints(a, b, pa, pb);
+}
+
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Point3& pa, MT_Point3& pb)
+{
+	return sphereClosestPoints(a, b, pa, pb);
+}
+
+bool separated(const DT_WorldBox& a, const DT_WorldBox& b, MT_Vector3& v)
+{
+	MT_Scalar margin = a.m_margin + b.m_margin;
+	MT_Vector3 d = b.m_center - a.m_center;
+
+	// The axes of b in the frame of a. The epsilon keeps the cross products 
+	// of nearly parallel axes from reporting a separation by mistake.
+	MT_Scalar r[3][3], abs_r[3][3];
+	MT_Scalar da[3], db[3];
+	int i, j;
+	for (i = 0; i != 3; ++i)
+	{
+		for (j = 0; j != 3; ++j)
+		{
+			r[i][j] = a.m_axis[i].dot(b.m_axis[j]);
+			abs_r[i][j] = MT_abs(r[i][j]) + MT_EPSILON;
+		}
+		da[i] = a.m_axis[i].dot(d);
+		db[i] = b.m_axis[i].dot(d);
+	}
+
+	// The face normals of a and of b
+	for (i = 0; i != 3; ++i)
+	{
+		MT_Scalar gap = MT_abs(da[i]) - a.m_extent[i] - 
+			(b.m_extent[0] * abs_r[i][0] + b.m_extent[1] * abs_r[i][1] + b.m_extent[2] * abs_r[i][2]) - margin;
+		if (gap > MT_Scalar(0.0))
+		{
+			v = a.m_axis[i] * (da[i] < MT_Scalar(0.0) ? gap : -gap);
+			return true;
+		}
+	}
+
+	for (j = 0; j != 3; ++j)
+	{
+		MT_Scalar gap = MT_abs(db[j]) - b.m_extent[j] - 
+			(a.m_extent[0] * abs_r[0][j] + a.m_extent[1] * abs_r[1][j] + a.m_extent[2] * abs_r[2][j]) - margin;
+		if (gap > MT_Scalar(0.0))
+		{
+			v = b.m_axis[j] * (db[j] < MT_Scalar(0.0) ? gap : -gap);
+			return true;
+		}
+	}
+
+	// The cross products of an edge of a and an edge of b. The axes are not 
+	// normalized, so the margin is scaled by their length.
+	for (i = 0; i != 3; ++i)
+	{
+		int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+		for (j = 0; j != 3; ++j)
+		{
+			int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+			MT_Scalar length2 = MT_Scalar(1.0) - r[i][j] * r[i][j];
+			if (length2 > MT_EPSILON)
+			{
+				MT_Scalar dist = da[i2] * r[i1][j] - da[i1] * r[i2][j];
+				MT_Scalar length = MT_sqrt(length2);
+				MT_Scalar gap = MT_abs(dist) - 
+					(a.m_extent[i1] * abs_r[i2][j] + a.m_extent[i2] * abs_r[i1][j]) - 
+					(b.m_extent[j1] * abs_r[i][j2] + b.m_extent[j2] * abs_r[i][j1]) - margin * length;
+				if (gap > MT_Scalar(0.0))
+				{
+					v = a.m_axis[i].cross(b.m_axis[j]) * ((dist < MT_Scalar(0.0) ? gap : -gap) / length2);
+					return true;
+				}
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,111 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_PRIMITIVE_H
+#define DT_PRIMITIVE_H
+
+#include "MT_Point3.h"
+#include "MT_Vector3.h"
+#include "MT_Transform.h"
+
+class DT_Sphere;
+class DT_Box;
+class DT_LineSegment;
+
+// Spheres, boxes and line segments placed in world coordinates, for the 
+// queries that have a closed form on these shapes. A primitive is grown by 
+// a margin, so a sphere is its center grown by its radius, and a line 
+// segment with a margin is a capsule. setValue returns false if the 
+// transform deforms the shape into one of another kind, e.g., a sphere into 
+// an ellipsoid. The queries have to be done by GJK then.
+
+class DT_WorldSphere {
+public:
+	typedef DT_Sphere Shape;
+
+	bool setValue(const DT_Sphere& sphere, const MT_Transform& xform, MT_Scalar margin);
+
+	// Returns the distance of p to the shape without its margin, the point
+	// q of that shape nearest to p, and the unit vector n from q to p. 
+	MT_Scalar nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const;
+
+	MT_Point3  m_center;
+	MT_Scalar  m_margin;
+};
+
+class DT_WorldBox {
+public:
+	typedef DT_Box Shape;
+
+	bool setValue(const DT_Box& box, const MT_Transform& xform, MT_Scalar margin);
+
+	// For points inside the box, the distance is negative and q is the 
+	// nearest point on the boundary.
+	MT_Scalar nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const;
+
+	MT_Point3  m_center;
+	MT_Vector3 m_axis[3];
+	MT_Vector3 m_extent;
+	MT_Scalar  m_margin;
+};
+
+class DT_WorldSegment {
+public:
+	typedef DT_LineSegment Shape;
+
+	bool setValue(const DT_LineSegment& segment, const MT_Transform& xform, MT_Scalar margin);
+
+	MT_Scalar nearest(const MT_Point3& p, MT_Point3& q, MT_Vector3& n) const;
+
+	MT_Point3  m_source;
+	MT_Point3  m_target;
+	MT_Scalar  m_margin;
+};
+
+// The queries follow the conventions of their GJK counterparts in 
+// DT_Convex.h. The vector v is set to the separating vector pa - pb if the 
+// shapes are disjoint and to zero otherwise.
+
+bool intersect(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v);
+bool intersect(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v);
+bool intersect(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v);
+
+bool common_point(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+bool common_point(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+bool common_point(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+bool penetration_depth(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Vector3& v, MT_Point3& pa, MT_Point3& pb);
+
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldSphere& b, MT_Point3& pa, MT_Point3& pb);
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldBox& b, MT_Point3& pa, MT_Point3& pb);
+MT_Scalar closest_points(const DT_WorldSphere& a, const DT_WorldSegment& b, MT_Point3& pa, MT_Point3& pb);
+
+// Separating axis test on the 15 axes of a pair of boxes. Returns true 
+// if one of them separates the boxes grown by their margins. Without 
+// margins the test is exact, with margins it may miss a separation near 
+// the rounded edges and corners.
+bool separated(const DT_WorldBox& a, const DT_WorldBox& b, MT_Vector3& v);
+
+#endif
@@ -0,0 +1,531 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#include "DT_QuickHull.h"
+
+#include "MT_Scalar.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cassert>
+
+#include <algorithm>
+
+static const DT_Index NONE = ~DT_Index(0);
+
+// Points closer to a face than eps times the extent of the point set are 
+// regarded as lying on it. The tolerance is a few units of the precision of 
+// MT_Scalar, so that points that are coplanar up to rounding, e.g., the 
+// vertices of a tessellated cylinder, do not end up as hull vertices.
+static const double REL_EPS = 8.0 * MT_EPSILON;
+
+// A face is removed if the new point lies above it by more than the 
+// rounding error of the distance. Using the larger tolerance here would 
+// leave folds in the hull that accumulate into visible concavities.
+static const double REL_VISIBLE_EPS = 16.0 * DBL_EPSILON;
+
+static inline void sub(double *r, const double *a, const double *b)
+{
+	r[0] = a[0] - b[0];
+	r[1] = a[1] - b[1];
+	r[2] = a[2] - b[2];
+}
+
+static inline double dot(const double *a, const double *b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static inline void cross(double *r, const double *a, const double *b)
+{
+	r[0] = a[1] * b[2] - a[2] * b[1];
+	r[1] = a[2] * b[0] - a[0] * b[2];
+	r[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline double normalize(double *a)
+{
+	double len = sqrt(dot(a, a));
+	if (len > 0.0)
+	{
+		a[0] /= len;
+		a[1] /= len;
+		a[2] /= len;
+	}
+	return len;
+}
+
+inline double DT_QuickHull::distance(const Face& face, DT_Index i) const
+{
+	return dot(face.m_normal, point(i)) - face.m_offset;
+}
+
+DT_Index DT_QuickHull::addFace(DT_Index a, DT_Index b, DT_Index c)
+{
+	Face face;
+	face.m_v[0] = a;
+	face.m_v[1] = b;
+	face.m_v[2] = c;
+	face.m_adj[0] = face.m_adj[1] = face.m_adj[2] = NONE;
+
+	double e1[3], e2[3];
+	sub(e1, point(b), point(a));
+	sub(e2, point(c), point(a));
+	cross(face.m_normal, e1, e2);
+	normalize(face.m_normal);
+	face.m_offset = dot(face.m_normal, point(a));
+
+	face.m_outside = NONE;
+	face.m_furthest = NONE;
+	face.m_maxDist = 0.0;
+	face.m_visible = false;
+	face.m_dead = false;
+
+	m_faces.push_back(face);
+	return m_faces.size() - 1;
+}
+
+// Adds point i to the conflict list of the first face from first_face on
+// that it lies above. The point is dropped if it lies above none of them.
+
+void DT_QuickHull::assignPoint(DT_Index i, DT_Index first_face)
+{
+	DT_Index f;
+	for (f = first_face; f != m_faces.size(); ++f)
+	{
+		Face& face = m_faces[f];
+		if (!face.m_dead)
+		{
+			double d = distance(face, i);
+			if (d > m_eps)
+			{
+				m_next[i] = face.m_outside;
+				face.m_outside = i;
+				if (d > face.m_maxDist)
+				{
+					face.m_maxDist = d;
+					face.m_furthest = i;
+				}
+				return;
+			}
+		}
+	}
+}
+
+// Collects the faces visible from the eye point, starting from a face that 
+// is known to be visible, and the edges on the boundary of the visible region.
+
+void DT_QuickHull::findHorizon(DT_Index eye, DT_Index face)
+{
+	m_faces[face].m_visible = true;
+	m_visible.push_back(face);
+
+	DT_Index j;
+	for (j = 0; j != m_visible.size(); ++j)
+	{
+		DT_Index f = m_visible[j];
+		int e;
+		for (e = 0; e != 3; ++e)
+		{
+			DT_Index n = m_faces[f].m_adj[e];
+			if (!m_faces[n].m_visible)
+			{
+				if (distance(m_faces[n], eye) > m_visibleEps)
+				{
+					m_faces[n].m_visible = true;
+					m_visible.push_back(n);
+				}
+				else
+				{
+					m_horizon.push_back(f);
+					m_horizon.push_back(e);
+				}
+			}
+		}
+	}
+}
+
+// Replaces the faces visible from the eye point by a cone of faces joining 
+// the horizon to the eye point.
+
+void DT_QuickHull::addPoint(DT_Index eye, DT_Index face)
+{
+	m_visible.clear();
+	m_horizon.clear();
+	findHorizon(eye, face);
+
+	DT_Index first_new = m_faces.size();
+
+	DT_Index i;
+	for (i = 0; i != m_horizon.size(); i += 2)
+	{
+		DT_Index f = m_horizon[i];
+		DT_Index e = m_horizon[i + 1];
+		DT_Index a = m_faces[f].m_v[e];
+		DT_Index b = m_faces[f].m_v[(e + 1) % 3];
+		DT_Index n = m_faces[f].m_adj[e];
+
+		DT_Index g = addFace(a, b, eye);
+		m_faces[g].m_adj[0] = n;
+		
+		Face& other = m_faces[n];
+		int k;
+		for (k = 0; other.m_v[k] != b; ++k) 
+		{
+			assert(k < 2);
+		}
+		assert(other.m_v[(k + 1) % 3] == a);
+		other.m_adj[k] = g;
+
+		m_faceAt[a] = g;
+	}
+
+	// New face (a, b, eye) shares edge (b, eye) with the new face that 
+	// starts at b.
+	for (i = first_new; i != m_faces.size(); ++i)
+	{
+		DT_Index g = m_faceAt[m_faces[i].m_v[1]];
+		m_faces[i].m_adj[1] = g;
+		m_faces[g].m_adj[2] = i;
+	}
+
+	for (i = 0; i != m_visible.size(); ++i)
+	{
+		m_faces[m_visible[i]].m_dead = true;
+	}
+	
+	for (i = 0; i != m_visible.size(); ++i)
+	{
+		DT_Index p = m_faces[m_visible[i]].m_outside;
+		while (p != NONE)
+		{
+			DT_Index next = m_next[p];
+			if (p != eye)
+			{
+				assignPoint(p, first_new);
+			}
+			p = next;
+		}
+	}
+}
+
+int DT_QuickHull::compute(DT_Count count, const MT_Point3 *verts, const char *flags)
+{
+	m_dimension = 0;
+	m_points.clear();
+	m_faces.clear();
+	m_hullFaces.clear();
+	m_polygon.clear();
+
+	m_coords.resize(3 * count);
+	m_next.assign(count, NONE);
+	m_faceAt.resize(count);
+
+	double extent = 0.0;
+	DT_Index i;
+	for (i = 0; i != count; ++i) 
+	{
+		if (flags == 0 || flags[i])
+		{
+			double *p = &m_coords[3 * i];
+			p[0] = verts[i][0];
+			p[1] = verts[i][1];
+			p[2] = verts[i][2];
+			extent = std::max(extent, fabs(p[0]) + fabs(p[1]) + fabs(p[2]));
+			m_points.push_back(i);
+		}
+	}
+
+	if (m_points.empty())
+	{
+		return m_dimension;
+	}
+
+	m_eps = std::max(REL_EPS * extent, DBL_MIN);
+	m_visibleEps = REL_VISIBLE_EPS * extent;
+
+	// The extreme points along the axis of largest spread.
+	DT_Index i0 = m_points[0], i1 = m_points[0];
+	double spread = 0.0;
+	int axis;
+	for (axis = 0; axis != 3; ++axis)
+	{
+		DT_Index lo = m_points[0], hi = m_points[0];
+		for (i = 1; i != m_points.size(); ++i)
+		{
+			const double *p = point(m_points[i]);
+			if (p[axis] < point(lo)[axis]) 
+			{
+				lo = m_points[i];
+			}
+			if (p[axis] > point(hi)[axis])
+			{
+				hi = m_points[i];
+			}
+		}
+		if (point(hi)[axis] - point(lo)[axis] > spread)
+		{
+			spread = point(hi)[axis] - point(lo)[axis];
+			i0 = lo;
+			i1 = hi;
+		}
+	}
+	
+	if (spread <= m_eps)
+	{
+		m_polygon.push_back(i0);
+		return m_dimension;
+	}
+
+	// The point furthest from the line through i0 and i1.
+	double dir[3];
+	sub(dir, point(i1), point(i0));
+	normalize(dir);
+
+	DT_Index i2 = NONE;
+	double max_dist = m_eps;
+	for (i = 0; i != m_points.size(); ++i)
+	{
+		double d[3], c[3];
+		sub(d, point(m_points[i]), point(i0));
+		cross(c, d, dir);
+		double dist = sqrt(dot(c, c));
+		if (dist > max_dist)
+		{
+			max_dist = dist;
+			i2 = m_points[i];
+		}
+	}
+
+	if (i2 == NONE)
+	{
+		m_dimension = 1;
+		m_polygon.push_back(i0);
+		m_polygon.push_back(i1);
+		return m_dimension;
+	}
+
+	// The point furthest from the plane through i0, i1 and i2.
+	double e1[3], e2[3], normal[3];
+	sub(e1, point(i1), point(i0));
+	sub(e2, point(i2), point(i0));
+	cross(normal, e1, e2);
+	normalize(normal);
+
+	DT_Index i3 = NONE;
+	max_dist = m_eps;
+	for (i = 0; i != m_points.size(); ++i)
+	{
+		double d[3];
+		sub(d, point(m_points[i]), point(i0));
+		double dist = fabs(dot(d, normal));
+		if (dist > max_dist)
+		{
+			max_dist = dist;
+			i3 = m_points[i];
+		}
+	}
+
+	if (i3 == NONE)
+	{
+		computePolygon(i0, i1, i2);
+		return m_dimension;
+	}
+
+	m_dimension = 3;
+
+	// The initial tetrahedron, with its faces oriented outward.
+	DT_Index tetra[4] = { i0, i1, i2, i3 };
+	int k;
+	for (k = 0; k != 4; ++k)
+	{
+		DT_Index a = tetra[(k + 1) % 4], b = tetra[(k + 2) % 4], c = tetra[(k + 3) % 4];
+		double d[3], n[3];
+		sub(e1, point(b), point(a));
+		sub(e2, point(c), point(a));
+		sub(d, point(tetra[k]), point(a));
+		cross(n, e1, e2);
+		if (dot(n, d) > 0.0)
+		{
+			std::swap(b, c);
+		}
+		addFace(a, b, c);
+	}
+
+	DT_Index f;
+	for (f = 0; f != 4; ++f)
+	{
+		int e;
+		for (e = 0; e != 3; ++e)
+		{
+			DT_Index a = m_faces[f].m_v[e], b = m_faces[f].m_v[(e + 1) % 3];
+			DT_Index g;
+			for (g = 0; g != 4; ++g)
+			{
+				const DT_Index *v = m_faces[g].m_v;
+				if ((v[0] == b && v[1] == a) || (v[1] == b && v[2] == a) || (v[2] == b && v[0] == a))
+				{
+					m_faces[f].m_adj[e] = g;
+				}
+			}
+			assert(m_faces[f].m_adj[e] != NONE);
+		}
+	}
+
+	for (i = 0; i != m_points.size(); ++i)
+	{
+		DT_Index p = m_points[i];
+		if (p != i0 && p != i1 && p != i2 && p != i3)
+		{
+			assignPoint(p, 0);
+		}
+	}
+
+	for (f = 0; f != m_faces.size(); ++f)
+	{
+		if (!m_faces[f].m_dead && m_faces[f].m_outside != NONE)
+		{
+			addPoint(m_faces[f].m_furthest, f);
+		}
+	}
+
+	for (f = 0; f != m_faces.size(); ++f)
+	{
+		if (!m_faces[f].m_dead)
+		{
+			m_hullFaces.push_back(m_faces[f].m_v[0]);
+			m_hullFaces.push_back(m_faces[f].m_v[1]);
+			m_hullFaces.push_back(m_faces[f].m_v[2]);
+		}
+	}
+
+	return m_dimension;
+}
+
+struct Projection {
+	double   m_s, m_t;
+	DT_Index m_index;
+
+	bool operator<(const Projection& other) const
+	{
+		return m_s < other.m_s || (m_s == other.m_s && m_t < other.m_t);
+	}
+};
+
+// Whether b lies more than eps to the right of the line from a to c, 
+// i.e., the turn at b is counterclockwise.
+
+static bool leftTurn(const Projection& a, const Projection& b, const Projection& c, double eps)
+{
+	double ds = c.m_s - a.m_s, dt = c.m_t - a.m_t;
+	double len = sqrt(ds * ds + dt * dt);
+	return len > eps && (b.m_s - a.m_s) * dt - (b.m_t - a.m_t) * ds > eps * len;
+}
+
+// The boundary of a planar point set, by Andrew's monotone chain on the 
+// points projected onto the plane through i0, i1 and i2. 
+
+void DT_QuickHull::computePolygon(DT_Index i0, DT_Index i1, DT_Index i2)
+{
+	double u[3], v[3], normal[3], e2[3];
+	sub(u, point(i1), point(i0));
+	sub(e2, point(i2), point(i0));
+	cross(normal, u, e2);
+	normalize(u);
+	normalize(normal);
+	cross(v, normal, u);
+
+	std::vector<Projection> proj(m_points.size());
+	DT_Index i;
+	for (i = 0; i != m_points.size(); ++i)
+	{
+		double d[3];
+		sub(d, point(m_points[i]), point(i0));
+		proj[i].m_s = dot(d, u);
+		proj[i].m_t = dot(d, v);
+		proj[i].m_index = m_points[i];
+	}
+	std::sort(proj.begin(), proj.end());
+
+	// The lower and upper chains, as indices into proj. 
+	DT_Index n = proj.size();
+	std::vector<DT_Index> chain(2 * n);
+	DT_Index k = 0;
+	DT_Index j;
+	for (j = 0; j != n; ++j)
+	{
+		while (k >= 2 && !leftTurn(proj[chain[k - 2]], proj[chain[k - 1]], proj[j], m_eps))
+		{
+			--k;
+		}
+		chain[k++] = j;
+	}
+	DT_Index lower = k + 1;
+	for (j = n - 1; j-- != 0;)
+	{
+		while (k >= lower && !leftTurn(proj[chain[k - 2]], proj[chain[k - 1]], proj[j], m_eps))
+		{
+			--k;
+		}
+		chain[k++] = j;
+	}
+	--k;
+
+	for (i = 0; i != k; ++i)
+	{
+		m_polygon.push_back(proj[chain[i]].m_index);
+	}
+	m_dimension = m_polygon.size() >= 3 ? 2 : 1;
+}
+
+void DT_QuickHull::adjacency(T_IndexBuf *adjacency) const
+{
+	DT_Index i;
+	if (m_dimension == 3)
+	{
+		for (i = 0; i != m_hullFaces.size(); i += 3)
+		{
+			adjacency[m_hullFaces[i]].push_back(m_hullFaces[i + 1]);
+			adjacency[m_hullFaces[i + 1]].push_back(m_hullFaces[i + 2]);
+			adjacency[m_hullFaces[i + 2]].push_back(m_hullFaces[i]);
+		}
+	}
+	else if (m_polygon.size() == 1)
+	{
+		adjacency[m_polygon[0]].push_back(m_polygon[0]);
+	}
+	else if (m_polygon.size() == 2)
+	{
+		adjacency[m_polygon[0]].push_back(m_polygon[1]);
+		adjacency[m_polygon[1]].push_back(m_polygon[0]);
+	}
+	else 
+	{
+		DT_Index n = m_polygon.size();
+		for (i = 0; i != n; ++i)
+		{
+			adjacency[m_polygon[i]].push_back(m_polygon[(i + 1) % n]);
+			adjacency[m_polygon[i]].push_back(m_polygon[(i + n - 1) % n]);
+		}
+	}
+}
@@ -0,0 +1,105 @@
+/*
+ * SOLID - Software Library for Interference Detection
+ * 
+ * Copyright (C) 2001-2003  Dtecta.  All rights reserved.
+ *
+ * This library may be distributed under the terms of the Q Public License
+ * (QPL) as defined by Trolltech AS of Norway and appearing in the file
+ * LICENSE.QPL included in the packaging of this file.
+ *
+ * This library may be distributed and/or modified under the terms of the
+ * GNU General Public License (GPL) version 2 as published by the Free Software
+ * Foundation and appearing in the file LICENSE.GPL included in the
+ * packaging of this file.
+ *
+ * This library is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Commercial use or any other use of this library not covered by either 
+ * the QPL or the GPL requires an additional license from Dtecta. 
+ * Please contact info@dtecta.com for enquiries about the terms of commercial
+ * use of this library.
+ */
+
+#ifndef DT_QUICKHULL_H
+#define DT_QUICKHULL_H
+
+#include <vector>
+
+#include "SOLID_types.h"
+#include "MT_Point3.h"
+
+// Convex hull of a point set by the quickhull algorithm. The hull is 
+// computed in double precision on a copy of the points. A DT_QuickHull 
+// keeps its buffers from one computation to the next, so it is cheap to 
+// reuse it for a sequence of hulls, e.g., the layers of a Dobkin-Kirkpatrick 
+// hierarchy. 
+//
+// Point sets that are flat are handled as well: a planar set yields the 
+// boundary polygon, a collinear set its two end points, and a set of 
+// coinciding points a single point.
+
+class DT_QuickHull {
+public:
+	typedef std::vector<DT_Index> T_IndexBuf;
+
+	DT_QuickHull() : m_dimension(0) {}
+
+	// Computes the hull of the points verts[i] for which flags is null or
+	// flags[i] is set. Returns the dimension of the point set (0..3).
+	int compute(DT_Count count, const MT_Point3 *verts, const char *flags);
+
+	int dimension() const { return m_dimension; }
+
+	// The triangles of the hull, three indices per triangle in 
+	// counterclockwise order seen from the outside. Empty unless the 
+	// dimension is 3. 
+	const T_IndexBuf& faces() const { return m_hullFaces; }
+
+	// Appends to adjacency[i] the hull vertices that share an edge with 
+	// vertex i. Each neighbour is listed once. Points that are not a 
+	// vertex of the hull get no neighbours.
+	void adjacency(T_IndexBuf *adjacency) const;
+
+private:
+	struct Face {
+		DT_Index m_v[3];       // vertices, counterclockwise from the outside
+		DT_Index m_adj[3];     // m_adj[i] is the face across edge (m_v[i], m_v[i+1])
+		double   m_normal[3];
+		double   m_offset;
+		DT_Index m_outside;    // first point of the conflict list
+		DT_Index m_furthest;   // point of the conflict list furthest above the face
+		double   m_maxDist;
+		bool     m_visible;
+		bool     m_dead;
+	};
+
+	DT_QuickHull(const DT_QuickHull&);
+	DT_QuickHull& operator=(const DT_QuickHull&);
+
+	const double *point(DT_Index i) const { return &m_coords[3 * i]; }
+	double distance(const Face& face, DT_Index i) const;
+
+	DT_Index addFace(DT_Index a, DT_Index b, DT_Index c);
+	void     assignPoint(DT_Index i, DT_Index first_face);
+	void     findHorizon(DT_Index eye, DT_Index face);
+	void     addPoint(DT_Index eye, DT_Index face);
+
+	void computePolygon(DT_Index i0, DT_Index i1, DT_Index i2);
+
+	int                    m_dimension;
+	double                 m_eps;
+	double                 m_visibleEps;
+	std::vector<double>    m_coords;
+	T_IndexBuf             m_points;     // the points taking part in the hull
+	T_IndexBuf             m_next;       // links of the conflict lists
+	std::vector<Face>      m_faces;
+	T_IndexBuf             m_visible;
+	T_IndexBuf             m_horizon;    // face and edge index pairs
+	T_IndexBuf             m_newFaces;
+	T_IndexBuf             m_faceAt;     // new face by the first vertex of its horizon edge
+	T_IndexBuf             m_hullFaces;
+	T_IndexBuf             m_polygon;    // boundary of a planar point set, in order
+};
+
+#endif
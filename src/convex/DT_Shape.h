@@ -32,9 +32,15 @@
 
 class DT_Object;
 
+// The convex shapes from SPHERE on have closed-form algorithms for some 
+// queries. Shapes are passed to the algorithms in the order of their types.
 enum DT_ShapeType {
     COMPLEX,
-    CONVEX
+    CONVEX,
+    SPHERE,
+    BOX,
+    LINESEGMENT,
+    NUM_SHAPE_TYPES
 };
 
 class DT_Shape {
@@ -30,12 +30,16 @@ class DT_Sphere : public DT_Convex {
 public:
    DT_Sphere(MT_Scalar radius) : m_radius(radius) {}
 	
+	virtual DT_ShapeType getType() const { return SPHERE; } 
+
     virtual MT_Scalar supportH(const MT_Vector3& v) const;
 	virtual MT_Point3 support(const MT_Vector3& v) const;
 	
 	virtual bool ray_cast(const MT_Point3& source, const MT_Point3& target,
 						  MT_Scalar& param, MT_Vector3& normal) const;
 
+	MT_Scalar getRadius() const { return m_radius; }
+
 protected:
     MT_Scalar m_radius;
 };
@@ -23,8 +23,6 @@
 
 #include "DT_TriEdge.h"
 
-TriangleStore g_triangleStore;
-
 bool link(const Edge& edge0, const Edge& edge1) 
 {
 	bool ok = edge0.getSource() == edge1.getTarget() && edge0.getTarget() == edge1.getSource();
@@ -140,50 +140,64 @@ public:
 };
   
 	
-static const int MaxTriangles = 200;
+// Triangles are allocated in blocks that are never moved, so pointers to 
+// triangles stay valid while the store grows. clear() keeps the blocks for 
+// the next query.
 
 class TriangleStore
 {
 private:
+	enum { BlockSize = 256 };
 
+	std::vector<Triangle *> m_blocks;
+	int                     m_free;
+
+	TriangleStore(const TriangleStore&);
+	TriangleStore& operator=(const TriangleStore&);
 
-	Triangle m_triangles[MaxTriangles];
-	int      m_free;
 public:
 	TriangleStore()
 	  : m_free(0)
 	{}
 
+	~TriangleStore()
+	{
+		std::vector<Triangle *>::iterator it;
+		for (it = m_blocks.begin(); it != m_blocks.end(); ++it)
+		{
+			delete [] *it;
+		}
+	}
+
 	void clear() { m_free = 0; }
 
 	int getFree() const { return m_free; }
 
-	Triangle& operator[](int i) { return m_triangles[i]; }
-	Triangle& last() { return m_triangles[m_free - 1]; }
+	Triangle& operator[](int i) { return m_blocks[i / BlockSize][i % BlockSize]; }
+	Triangle& last() { return (*this)[m_free - 1]; }
 
 	void setFree(int backup) { m_free = backup; }
 
 
 	Triangle *newTriangle(const MT_Vector3 *verts, Index_t i0, Index_t i1, Index_t i2) 
 	{ 
-		Triangle *newTriangle = 0;
-		if (m_free != MaxTriangles)
+		if (m_free == int(m_blocks.size()) * BlockSize)
 		{
-			newTriangle = &m_triangles[m_free++];
-			new (newTriangle) Triangle(i0, i1, i2);
-			if (!newTriangle->computeClosest(verts))
-			{
-				--m_free;
-				newTriangle = 0;
-			}
+			m_blocks.push_back(new Triangle[BlockSize]);
+		}
+
+		Triangle *newTriangle = &(*this)[m_free++];
+		new (newTriangle) Triangle(i0, i1, i2);
+		if (!newTriangle->computeClosest(verts))
+		{
+			--m_free;
+			newTriangle = 0;
 		}
 
 		return newTriangle;
 	}
 };
 
-extern TriangleStore g_triangleStore;
-
 
 inline int circ_next(int i) { return (i + 1) % 3; } 
 inline int circ_prev(int i) { return (i + 2) % 3; } 